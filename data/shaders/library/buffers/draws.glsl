@@ -0,0 +1,17 @@
+#ifndef DRAWS_BUFFER
+#define DRAWS_BUFFER
+// draws buffer, transforms of indirect and batched draws indexed by base instance plus instance
+layout (std430, binding = 0) readonly buffer Draws
+{
+	Transform transforms[];
+} draws;
+
+// is renderer drawn by indirect commands or instanced batches
+uniform bool indirect;
+
+// transform of current draw
+Transform getTransform()
+{
+	return indirect ? draws.transforms[gl_BaseInstance + gl_InstanceID] : transform;
+}
+#endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "../../../library/buffers/camera.glsl"
 #include "../../../library/structs/transform.glsl"
+#include "../../../library/buffers/draws.glsl"
 
 // vertex attributes
 layout (location = 0) in vec3 position;
@@ -23,10 +24,13 @@ out VsOut
 
 void main()
 {
+	// renderer or indirect draw transform
+	Transform draw_transform = getTransform();
+
 	// tbn vectors
-	vec3 t = normalize(mat3(transform.normal) * tangent);
-	vec3 b = normalize(mat3(transform.normal) * bitangent);
-	vec3 n = normalize(mat3(transform.normal) * normal);
+	vec3 t = normalize(mat3(draw_transform.normal) * tangent);
+	vec3 b = normalize(mat3(draw_transform.normal) * bitangent);
+	vec3 n = normalize(mat3(draw_transform.normal) * normal);
 
 	// right handedness fix for models with mirrored uvs
 	if (dot(cross(n, t), b) < 0.0f) t *= -1.0f;
@@ -35,12 +39,12 @@ void main()
 	vs_out.tbn = transpose(mat3(t, b, n));
 
 	// set shader outputs
-	vs_out.vertex_normal = mat3(transform.normal) * normal;
+	vs_out.vertex_normal = mat3(draw_transform.normal) * normal;
 	vs_out.texture_coords = uv;
-	vs_out.fragment_position = vec3(transform.model * vec4(position, 1.0f));
+	vs_out.fragment_position = vec3(draw_transform.model * vec4(position, 1.0f));
 	vs_out.tangent_view_position = vs_out.tbn * vec3(camera.position);
 	vs_out.tangent_fragment_position = vs_out.tbn * vs_out.fragment_position;
 
 	// shader output
-	gl_Position = camera.projection * camera.view * transform.model * vec4(position, 1.0f);
+	gl_Position = camera.projection * camera.view * draw_transform.model * vec4(position, 1.0f);
 }
\ No newline at end of file
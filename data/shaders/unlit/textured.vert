@@ -2,6 +2,7 @@
 
 #include "../library/buffers/camera.glsl"
 #include "../library/structs/transform.glsl"
+#include "../library/buffers/draws.glsl"
 
 // vertex attributes
 layout (location = 0) in vec3 position;
@@ -15,9 +16,12 @@ out VsOut
 
 void main()
 {
+	// renderer or indirect draw transform
+	Transform draw_transform = getTransform();
+
 	// set shader outputs
 	vs_out.texture_coords = uv;
 
 	// shader output
-	gl_Position = camera.projection * camera.view * transform.model * vec4(position, 1.0f);
+	gl_Position = camera.projection * camera.view * draw_transform.model * vec4(position, 1.0f);
 }
\ No newline at end of file
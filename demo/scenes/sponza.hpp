@@ -95,7 +95,7 @@ bool initialize(hawk::System::Core& app)
 
 	// sponza
 	hawk::Objects::Entity* sponza = app.scene.world->addEntity("Sponza", app.assets.models["Sponza"]);
-	sponza->transform->scale = glm::vec3(0.1f);
+	sponza->transform->setScale(glm::vec3(0.1f));
 	sponza->setStatic(true, true);
 
 	return true;
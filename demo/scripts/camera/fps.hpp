@@ -67,16 +67,22 @@ void cameraLook(float x, float y)
 		// camera entity
 		hawk::Objects::Entity* entity = app.video.camera->entity;
 
+		// camera rotation
+		glm::vec3 rotation = entity->transform->getRotation();
+
 		// set yaw and pitch
-		entity->transform->rotation.x += x_offset * camera_sensitivity;
-		entity->transform->rotation.y += y_offset * camera_sensitivity;
+		rotation.x += x_offset * camera_sensitivity;
+		rotation.y += y_offset * camera_sensitivity;
 
 		// make sure that when pitch is out of bounds, screen doesn't get flipped
 		if (camera_constrain)
 		{
-			if (entity->transform->rotation.y > 89.0f) entity->transform->rotation.y = 89.0f;
-			if (entity->transform->rotation.y < -89.0f) entity->transform->rotation.y = -89.0f;
+			if (rotation.y > 89.0f) rotation.y = 89.0f;
+			if (rotation.y < -89.0f) rotation.y = -89.0f;
 		}
+
+		// apply rotation
+		entity->transform->setRotation(rotation);
 	}
 }
 
@@ -114,10 +120,16 @@ void cameraMove(float dt)
 		// camera entity
 		hawk::Objects::Entity* entity = app.video.camera->entity;
 
-		if (app.input.keyPress(GLFW_KEY_W)) entity->transform->position += app.video.camera->front * velocity;
-		if (app.input.keyPress(GLFW_KEY_S)) entity->transform->position -= app.video.camera->front * velocity;
-		if (app.input.keyPress(GLFW_KEY_A)) entity->transform->position -= app.video.camera->right * velocity;
-		if (app.input.keyPress(GLFW_KEY_D)) entity->transform->position += app.video.camera->right * velocity;
+		// camera position
+		glm::vec3 position = entity->transform->getPosition();
+
+		if (app.input.keyPress(GLFW_KEY_W)) position += app.video.camera->front * velocity;
+		if (app.input.keyPress(GLFW_KEY_S)) position -= app.video.camera->front * velocity;
+		if (app.input.keyPress(GLFW_KEY_A)) position -= app.video.camera->right * velocity;
+		if (app.input.keyPress(GLFW_KEY_D)) position += app.video.camera->right * velocity;
+
+		// apply movement only when it changed to keep transform cache clean
+		if (position != entity->transform->getPosition()) entity->transform->setPosition(position);
 	}
 }
 
@@ -210,12 +210,18 @@ namespace hawk
 				// unbind frame buffer
 				glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
+				// bindings changed behind video manager
+				app.video.resetBindings();
+
 				return false;
 			}
 
 			// unbind frame buffer
 			glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
+			// bindings changed behind video manager
+			app.video.resetBindings();
+
 			// set properties
 			m_width = width;
 			m_height = height;
@@ -239,11 +245,14 @@ namespace hawk
 			// copy stencil buffer flag
 			bool copy_stencil_buffer = (bits & GL_STENCIL_BUFFER_BIT) == GL_STENCIL_BUFFER_BIT;
 
+			// video manager
+			Managers::Video& video = System::Core::getInstance().video;
+
 			// bind source frame buffer as read buffer
-			glBindFramebuffer(GL_READ_FRAMEBUFFER, src->getFbo());
+			video.bindFramebuffer(src->getFbo(), GL_READ_FRAMEBUFFER);
 
 			// bind destination frame buffer as write buffer
-			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dst->getFbo());
+			video.bindFramebuffer(dst->getFbo(), GL_DRAW_FRAMEBUFFER);
 
 			// copy buffers
 			if (copy_color_buffer)
@@ -267,7 +276,7 @@ namespace hawk
 			}
 
 			// unbind read/write buffers
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			video.bindFramebuffer(0);
 		}
 
 		void Framebuffer::release()
@@ -298,35 +307,35 @@ namespace hawk
 				m_depth_stencil_texture = 0;
 			}
 
+			// deleted names may be reused
+			System::Core::getInstance().video.resetBindings();
+
 			// free object
 			delete this;
 		}
 
 		void Framebuffer::bind()
 		{
+			// video manager
+			Managers::Video& video = System::Core::getInstance().video;
+
 			// bind frame buffer
-			glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+			video.bindFramebuffer(m_fbo);
 
 			// set viewport
-			glViewport(0, 0, m_width, m_height);
+			video.setViewport(0, 0, m_width, m_height);
 		}
 
 		void Framebuffer::bindColorTexture(unsigned int index, unsigned int unit)
 		{
-			// activate texture
-			glActiveTexture(GL_TEXTURE0 + unit);
-
 			// bind texture
-			glBindTexture(m_target, m_color_texture[index]);
+			System::Core::getInstance().video.bindTexture(unit, m_color_texture[index]);
 		}
 
 		void Framebuffer::bindDepthStencilTexture(unsigned int unit)
 		{
-			// activate texture
-			glActiveTexture(GL_TEXTURE0 + unit);
-
 			// bind texture
-			glBindTexture(m_target, m_depth_stencil_texture);
+			System::Core::getInstance().video.bindTexture(unit, m_depth_stencil_texture);
 		}
 
 		void Framebuffer::clear(const glm::vec4& color, unsigned int bits)
@@ -74,7 +74,7 @@ namespace hawk
 
 		void Material::use()
 		{
-			glUseProgram(m_shader->getProgram());
+			System::Core::getInstance().video.useProgram(m_shader->getProgram());
 		}
 
 		Shader* Material::getShader() const
@@ -456,30 +456,31 @@ namespace hawk
 			System::Core& app = System::Core::getInstance();
 
 			// texture sampler counter
-			int texture_counter = 0;
+			unsigned int texture_counter = 0;
 
 			// if we have textures
 			if (!textures.empty())
 			{
-				// set textures
+				// texture objects of samplers
+				unsigned int texture_ids[16];
+
 				for (auto texture : textures)
 				{
-					// bind texture
-					texture->bind(texture_counter++);
+					texture_ids[texture_counter++] = texture->getTexture();
 
 					// break if exceeded textures limit
 					if (texture_counter == 16) break;
 				}
 
-				// activate default texture
-				glActiveTexture(GL_TEXTURE0);
+				// bind changed textures in one call
+				app.video.bindTextures(0, texture_counter, texture_ids);
 			}
 
 			// if this a forward lit material
 			if (app.video.getRendering() == Managers::Video::Rendering::Forward && m_material_type != Type::Unlit)
 			{
 				// if we have lights
-				if (!app.video.lights.empty())
+				if (!app.video.getActiveLights().empty())
 				{
 					// shadow map id holder
 					unsigned int shadow_map_id = 0;
@@ -497,13 +498,10 @@ namespace hawk
 					for (unsigned int i = 0; i < app.video.getMaxLights(); ++i)
 					{
 						// continue if light is out of active lights range
-						if (i + 1 > app.video.lights.size()) break;
-
-						// continue if light is disabled
-						if (!app.video.lights[i]->enable) continue;
+						if (i + 1 > app.video.getActiveLights().size()) break;
 
 						// if light has shadows
-						if (app.video.lights[i]->cast_shadows && shadow_map_id < app.video.getMaxShadows())
+						if (app.video.getActiveLights()[i]->cast_shadows && shadow_map_id < app.video.getMaxShadows())
 						{
 							// directional shadow map sample index
 							dsm_sampler_index = shadow_map_counter++;
@@ -515,16 +513,16 @@ namespace hawk
 							shadow_map_id++;
 
 							// bind shadow map texture
-							switch (app.video.lights[i]->getLightType())
+							switch (app.video.getActiveLights()[i]->getLightType())
 							{
 							case Components::Light::Type::Directional:
-								app.video.lights[i]->getShadowMapFramebuffer()->bindDepthStencilTexture(dsm_sampler_index);
+								app.video.getActiveLights()[i]->getShadowMapFramebuffer()->bindDepthStencilTexture(dsm_sampler_index);
 								break;
 							case Components::Light::Type::Point:
-								app.video.lights[i]->getShadowMapFramebuffer()->bindDepthStencilTexture(odsm_sampler_index);
+								app.video.getActiveLights()[i]->getShadowMapFramebuffer()->bindDepthStencilTexture(odsm_sampler_index);
 								break;
 							case Components::Light::Type::Spot:
-								app.video.lights[i]->getShadowMapFramebuffer()->bindDepthStencilTexture(dsm_sampler_index);
+								app.video.getActiveLights()[i]->getShadowMapFramebuffer()->bindDepthStencilTexture(dsm_sampler_index);
 								break;
 							}
 						}
@@ -1,38 +1,53 @@
+#include "../system/core.hpp"
 #include "mesh.hpp"
+#include "../objects/bvh.hpp"
 #include <glad/glad.h>
 #include "../helpers/math.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
 
 namespace hawk
 {
 	namespace Assets
 	{
-		Mesh::Mesh() : mode(GL_TRIANGLES), m_vao(0), m_vbo(0), m_ibo(0)
+		/**
+		 * Guards building triangle trees.
+		 */
+		static std::mutex tree_mutex;
+
+		Mesh::Mesh() : mode(GL_TRIANGLES), m_vao(0), m_vbo(0), m_ibo(0), m_base_vertex(0), m_first_index(0), m_in_arena(false), m_tree(nullptr)
 		{
 			// set asset type
 			m_type = "Mesh";
 		}
 
-		Mesh::Mesh(const Mesh& other) : Asset(other), vertices(other.vertices), indices(other.indices), mode(other.mode),
-			m_vao(other.m_vao), m_vbo(other.m_vbo), m_ibo(other.m_ibo) 
+		Mesh::Mesh(const Mesh& other) : Asset(other), vertices(other.vertices), indices(other.indices), mode(other.mode), lods(other.lods), meshlets(other.meshlets),
+			m_vao(other.m_vao), m_vbo(other.m_vbo), m_ibo(other.m_ibo), m_base_vertex(other.m_base_vertex), m_first_index(other.m_first_index), m_in_arena(other.m_in_arena), m_bounds(other.m_bounds), m_sphere(other.m_sphere), m_tree(nullptr)
 		{
 			// set asset type
 			m_type = "Mesh";
+
+			// share arena ranges
+			if (m_in_arena) System::Core::getInstance().video.getGeometryArena().retain(m_base_vertex);
 		}
 
-		Mesh::Mesh(const std::vector<Vertex>& vertices, unsigned int mode) : vertices(vertices), mode(mode)
+		Mesh::Mesh(const std::vector<Vertex>& vertices, unsigned int mode) : vertices(vertices), mode(mode), m_vao(0), m_vbo(0), m_ibo(0), m_base_vertex(0), m_first_index(0), 
+			m_in_arena(false), m_tree(nullptr)
 		{
 			// set asset type
 			m_type = "Mesh";
 		}
 
 		Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, unsigned int mode) : vertices(vertices), 
-			indices(indices), mode(mode)
+			indices(indices), mode(mode), m_vao(0), m_vbo(0), m_ibo(0), m_base_vertex(0), m_first_index(0), m_in_arena(false), m_tree(nullptr)
 		{
 			// set asset type
 			m_type = "Mesh";
 		}
 
-		Mesh::Mesh(Mesh::Primitive primitive, float width, float height, float length)
+		Mesh::Mesh(Mesh::Primitive primitive, float width, float height, float length) : m_vao(0), m_vbo(0), m_ibo(0), m_base_vertex(0), m_first_index(0), m_in_arena(false), 
+			m_tree(nullptr)
 		{
 			// set asset type
 			m_type = "Mesh";
@@ -173,16 +188,52 @@ namespace hawk
 
 		void Mesh::operator=(const Mesh& other)
 		{
+			// return if assigned to itself
+			if (this == &other) return;
+
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// share arena ranges of other mesh, then drop own ones which may be last reference
+			if (other.m_in_arena) app.video.getGeometryArena().retain(other.m_base_vertex);
+
+			if (m_in_arena) app.video.getGeometryArena().free(m_base_vertex);
+
 			vertices = other.vertices;
 			indices = other.indices;
 			mode = other.mode;
+			lods = other.lods;
+			meshlets = other.meshlets;
 			m_vao = other.m_vao;
 			m_vbo = other.m_vbo;
 			m_ibo = other.m_ibo;
+			m_base_vertex = other.m_base_vertex;
+			m_first_index = other.m_first_index;
+			m_in_arena = other.m_in_arena;
+			m_bounds = other.m_bounds;
+			m_sphere = other.m_sphere;
+
+			// triangles tree is built again for new vertices
+			delete m_tree.exchange(nullptr);
 		}
 
 		bool Mesh::build()
 		{
+			// calculate bounding volumes
+			calculateBounds();
+
+			// upload into shared geometry arena, draws then keep one vertex array bound
+			hawk::Objects::GeometryArena& arena = System::Core::getInstance().video.getGeometryArena();
+
+			if (!vertices.empty() && arena.allocate(&vertices[0], static_cast<unsigned int>(vertices.size()), indices.empty() ? nullptr : &indices[0], 
+				static_cast<unsigned int>(indices.size()), m_base_vertex, m_first_index))
+			{
+				m_vao = arena.getVao();
+				m_in_arena = true;
+
+				return true;
+			}
+
 			// make vertex array
 			glGenVertexArrays(1, &m_vao);
 
@@ -193,7 +244,7 @@ namespace hawk
 			if (indices.size() > 0) glGenBuffers(1, &m_ibo);
 
 			// bind vertex array to hold changes
-			glBindVertexArray(m_vao);
+			System::Core::getInstance().video.bindVertexArray(m_vao);
 
 			// bind and fill vertex buffer
 			glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
@@ -227,7 +278,7 @@ namespace hawk
 			glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof Vertex, (void*)offsetof(Vertex, bitangent));
 
 			// unbind vertex array
-			glBindVertexArray(0);
+			System::Core::getInstance().video.bindVertexArray(0);
 
 			// unbind vertex buffer
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -240,12 +291,24 @@ namespace hawk
 
 		void Mesh::release()
 		{
+			// give arena ranges back, vertex array is shared
+			if (m_in_arena)
+			{
+				System::Core::getInstance().video.getGeometryArena().free(m_base_vertex);
+
+				m_vao = 0;
+				m_in_arena = false;
+			}
+
 			// free vertex array
 			if (m_vao)
 			{
 				glDeleteVertexArrays(1, &m_vao);
 
 				m_vao = 0;
+
+				// deleted names may be reused
+				System::Core::getInstance().video.resetBindings();
 			}
 
 			// free vertex buffer
@@ -264,15 +327,274 @@ namespace hawk
 				m_ibo = 0;
 			}
 
+			// release detail levels
+			for (auto lod : lods)
+				if (lod) lod->release();
+
+			lods.clear();
+
+			// free triangles tree
+			delete m_tree.exchange(nullptr);
+
 			// free object
 			delete this;
 		}
 
+		bool Mesh::buildMeshlets(unsigned int max_vertices, unsigned int max_triangles)
+		{
+			meshlets.clear();
+
+			// return if mesh has no indexed triangles
+			if (mode != GL_TRIANGLES || indices.size() < 3 || indices.size() % 3 != 0 || max_vertices < 3 || max_triangles == 0) return false;
+
+			unsigned int triangles_count = static_cast<unsigned int>(indices.size() / 3);
+			unsigned int vertices_count = static_cast<unsigned int>(vertices.size());
+
+			// triangles around each vertex
+			std::vector<unsigned int> offsets(vertices_count + 1, 0);
+
+			for (auto index : indices)
+				offsets[index + 1]++;
+
+			for (unsigned int i = 0; i < vertices_count; ++i)
+				offsets[i + 1] += offsets[i];
+
+			std::vector<unsigned int> adjacency(indices.size());
+			std::vector<unsigned int> cursors(offsets.begin(), offsets.end() - 1);
+
+			for (size_t i = 0; i < indices.size(); ++i)
+				adjacency[cursors[indices[i]]++] = static_cast<unsigned int>(i / 3);
+
+			// meshlet state, vertex marks hold meshlet number plus one
+			std::vector<unsigned char> used(triangles_count, 0);
+			std::vector<unsigned int> marks(vertices_count, 0);
+			std::vector<unsigned int> candidates;
+			std::vector<unsigned int> ordered;
+
+			ordered.reserve(indices.size());
+
+			unsigned int next = 0;
+
+			while (true)
+			{
+				// start at first free triangle
+				while (next < triangles_count && used[next]) ++next;
+
+				if (next == triangles_count) break;
+
+				unsigned int mark = static_cast<unsigned int>(meshlets.size()) + 1;
+				unsigned int meshlet_vertices = 0, meshlet_triangles = 0;
+
+				Meshlet meshlet = { static_cast<unsigned int>(ordered.size()), 0, { glm::vec3(0.0f), 0.0f }, glm::vec3(0.0f), 1.0f };
+
+				candidates.clear();
+				candidates.push_back(next);
+
+				// grow over neighbour triangles which add fewest new vertices
+				while (meshlet_triangles < max_triangles)
+				{
+					int best = -1;
+					unsigned int best_new = 4;
+
+					for (size_t i = 0; i < candidates.size(); ++i)
+					{
+						unsigned int triangle = candidates[i];
+
+						if (used[triangle]) continue;
+
+						unsigned int added = 0;
+
+						for (unsigned int k = 0; k < 3; ++k)
+							if (marks[indices[triangle * 3 + k]] != mark) added++;
+
+						if (meshlet_vertices + added <= max_vertices && added < best_new)
+						{
+							best = static_cast<int>(i);
+							best_new = added;
+						}
+					}
+
+					// close meshlet if no neighbour fits
+					if (best < 0) break;
+
+					unsigned int triangle = candidates[best];
+
+					candidates[best] = candidates.back();
+					candidates.pop_back();
+
+					// add triangle and queue its neighbours
+					used[triangle] = 1;
+					meshlet_triangles++;
+
+					for (unsigned int k = 0; k < 3; ++k)
+					{
+						unsigned int vertex = indices[triangle * 3 + k];
+
+						ordered.push_back(vertex);
+
+						if (marks[vertex] == mark) continue;
+
+						marks[vertex] = mark;
+						meshlet_vertices++;
+
+						for (unsigned int j = offsets[vertex]; j < offsets[vertex + 1]; ++j)
+							if (!used[adjacency[j]]) candidates.push_back(adjacency[j]);
+					}
+				}
+
+				meshlet.count = static_cast<unsigned int>(ordered.size()) - meshlet.first;
+
+				// sphere around meshlet box
+				Helpers::Bounds::Box box = Helpers::Bounds::empty();
+
+				for (unsigned int i = meshlet.first; i < meshlet.first + meshlet.count; ++i)
+					Helpers::Bounds::expand(box, vertices[ordered[i]].position);
+
+				meshlet.sphere.center = (box.min + box.max) * 0.5f;
+
+				for (unsigned int i = meshlet.first; i < meshlet.first + meshlet.count; ++i)
+					meshlet.sphere.radius = std::max(meshlet.sphere.radius, glm::length(vertices[ordered[i]].position - meshlet.sphere.center));
+
+				// normal cone of triangle faces
+				std::vector<glm::vec3> normals;
+
+				for (unsigned int i = meshlet.first; i < meshlet.first + meshlet.count; i += 3)
+				{
+					glm::vec3 normal = glm::cross(vertices[ordered[i + 1]].position - vertices[ordered[i]].position, vertices[ordered[i + 2]].position - vertices[ordered[i]].position);
+
+					float length = glm::length(normal);
+
+					if (length > 0.0f) normals.push_back(normal * (1.0f / length));
+				}
+
+				glm::vec3 axis = glm::vec3(0.0f);
+
+				for (auto& normal : normals)
+					axis += normal;
+
+				float axis_length = glm::length(axis);
+
+				if (axis_length > 0.0f)
+				{
+					meshlet.cone_axis = axis * (1.0f / axis_length);
+
+					// smallest cosine between axis and normals
+					float min_dot = 1.0f;
+
+					for (auto& normal : normals)
+						min_dot = std::min(min_dot, glm::dot(meshlet.cone_axis, normal));
+
+					// cone wider than a hemisphere can't be culled
+					meshlet.cone_cutoff = (min_dot <= 0.1f) ? 1.0f : std::sqrt(1.0f - min_dot * min_dot);
+				}
+
+				meshlets.push_back(meshlet);
+			}
+
+			// replace elements by meshlet order
+			indices.swap(ordered);
+
+			return true;
+		}
+
 		unsigned int Mesh::getVao() const
 		{
 			return m_vao;
 		}
 
+		unsigned int Mesh::getBaseVertex() const
+		{
+			return m_base_vertex;
+		}
+
+		unsigned int Mesh::getFirstIndex() const
+		{
+			return m_first_index;
+		}
+
+		bool Mesh::isInArena() const
+		{
+			return m_in_arena;
+		}
+
+		const Helpers::Bounds::Box& Mesh::getBounds() const
+		{
+			return m_bounds;
+		}
+
+		const Helpers::Bounds::Sphere& Mesh::getSphere() const
+		{
+			return m_sphere;
+		}
+
+		Mesh* Mesh::getLod(unsigned int level)
+		{
+			// return this mesh at full detail
+			if (level == 0 || lods.empty()) return this;
+
+			return lods[std::min(level, static_cast<unsigned int>(lods.size())) - 1];
+		}
+
+		const Objects::Bvh* Mesh::getTree() const
+		{
+			// tree of an earlier call
+			Objects::Bvh* tree = m_tree.load(std::memory_order_acquire);
+
+			if (tree) return tree;
+
+			// return if mesh has no triangles
+			if (mode != GL_TRIANGLES || vertices.empty()) return nullptr;
+
+			std::lock_guard<std::mutex> lock(tree_mutex);
+
+			// another thread may have built it while waiting
+			tree = m_tree.load(std::memory_order_acquire);
+
+			if (tree) return tree;
+
+			// triangle boxes
+			unsigned int count = static_cast<unsigned int>((indices.empty() ? vertices.size() : indices.size()) / 3);
+
+			std::vector<Helpers::Bounds::Box> bounds(count);
+
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				glm::vec3 a, b, c;
+
+				getTriangle(i, a, b, c);
+
+				bounds[i] = Helpers::Bounds::empty();
+
+				Helpers::Bounds::expand(bounds[i], a);
+				Helpers::Bounds::expand(bounds[i], b);
+				Helpers::Bounds::expand(bounds[i], c);
+			}
+
+			tree = new Objects::Bvh();
+
+			tree->build(bounds);
+
+			m_tree.store(tree, std::memory_order_release);
+
+			return tree;
+		}
+
+		void Mesh::getTriangle(unsigned int index, glm::vec3& a, glm::vec3& b, glm::vec3& c) const
+		{
+			if (indices.empty())
+			{
+				a = vertices[index * 3].position;
+				b = vertices[index * 3 + 1].position;
+				c = vertices[index * 3 + 2].position;
+			}
+			else
+			{
+				a = vertices[indices[index * 3]].position;
+				b = vertices[indices[index * 3 + 1]].position;
+				c = vertices[indices[index * 3 + 2]].position;
+			}
+		}
+
 		void Mesh::calculateTangents(std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
 		{
 			// triangle edge vector
@@ -316,5 +638,29 @@ namespace hawk
 				v0.bitangent = v1.bitangent = bitangent;
 			}
 		}
+
+		void Mesh::calculateBounds()
+		{
+			// box around vertices
+			m_bounds = Helpers::Bounds::empty();
+
+			for (auto& vertex : vertices)
+				Helpers::Bounds::expand(m_bounds, vertex.position);
+
+			// return if there is no vertex
+			if (vertices.empty())
+			{
+				m_bounds = { glm::vec3(0.0f), glm::vec3(0.0f) };
+				m_sphere = { glm::vec3(0.0f), 0.0f };
+
+				return;
+			}
+
+			// sphere around box center reaching furthest vertex
+			m_sphere = { (m_bounds.min + m_bounds.max) * 0.5f, 0.0f };
+
+			for (auto& vertex : vertices)
+				m_sphere.radius = std::fmax(m_sphere.radius, glm::length(vertex.position - m_sphere.center));
+		}
 	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 // stl
 #include <vector>
+#include <atomic>
 
 // glad
 #include <glad/glad.h>
@@ -12,9 +13,18 @@
 
 // local
 #include "asset.hpp"
+#include "../helpers/bounds.hpp"
 
 namespace hawk
 {
+	namespace Objects
+	{
+		/**
+		 * Bvh forward declaration.
+		 */
+		class Bvh;
+	}
+
 	namespace Assets
 	{
 		/**
@@ -23,6 +33,16 @@ namespace hawk
 		class Mesh : public Asset
 		{
 		public:
+			/**
+			 * Most vertices per meshlet.
+			 */
+			static constexpr unsigned int MESHLET_VERTICES = 64;
+
+			/**
+			 * Most triangles per meshlet.
+			 */
+			static constexpr unsigned int MESHLET_TRIANGLES = 124;
+
 			/**
 			 * Vertex representation.
 			 */
@@ -54,6 +74,37 @@ namespace hawk
 				glm::vec3 bitangent;
 			};
 
+			/**
+			 * Cluster of neighbour triangles stored contiguously in mesh elements.
+			 */
+			struct Meshlet
+			{
+				/**
+				 * First element.
+				 */
+				unsigned int first;
+
+				/**
+				 * Elements count.
+				 */
+				unsigned int count;
+
+				/**
+				 * Local space bounding sphere.
+				 */
+				Helpers::Bounds::Sphere sphere;
+
+				/**
+				 * Average facing of triangles.
+				 */
+				glm::vec3 cone_axis;
+
+				/**
+				 * Sine of cone angle around axis which holds every triangle normal, one if triangles face too many ways.
+				 */
+				float cone_cutoff;
+			};
+
 			/**
 			 * Primitive enum.
 			 */
@@ -111,7 +162,7 @@ namespace hawk
 			void operator=(const Mesh& other);
 
 			/**
-			 * Generate buffers and set their data.
+			 * Upload vertices into shared geometry arena, or generate own buffers if arena is not made or full.
 			 * @return True or False.
 			 */
 			bool build();
@@ -122,10 +173,65 @@ namespace hawk
 			void release();
 
 			/**
-			 * Vertex array object.
+			 * Split triangles into meshlets and reorder elements by meshlet, must be called before build.
+			 * @param max_vertices Most vertices per meshlet.
+			 * @param max_triangles Most triangles per meshlet.
+			 * @return True or False.
+			 */
+			bool buildMeshlets(unsigned int max_vertices = MESHLET_VERTICES, unsigned int max_triangles = MESHLET_TRIANGLES);
+
+			/**
+			 * Vertex array object, shared by meshes in geometry arena.
 			 */
 			unsigned int getVao() const;
 
+			/**
+			 * First vertex in vertex buffer, added to elements by draws.
+			 */
+			unsigned int getBaseVertex() const;
+
+			/**
+			 * First element in index buffer.
+			 */
+			unsigned int getFirstIndex() const;
+
+			/**
+			 * Is mesh stored in shared geometry arena?
+			 */
+			bool isInArena() const;
+
+			/**
+			 * Local space bounding box.
+			 */
+			const Helpers::Bounds::Box& getBounds() const;
+
+			/**
+			 * Local space bounding sphere.
+			 */
+			const Helpers::Bounds::Sphere& getSphere() const;
+
+			/**
+			 * Local space tree over triangles, item index is triangle index. Built on first use from kept vertices,
+			 * safe to call from worker threads.
+			 * @return Tree or null pointer if mesh has no triangles.
+			 */
+			const Objects::Bvh* getTree() const;
+
+			/**
+			 * Local space triangle vertices.
+			 * @param index Triangle index.
+			 * @param a First vertex position.
+			 * @param b Second vertex position.
+			 * @param c Third vertex position.
+			 */
+			void getTriangle(unsigned int index, glm::vec3& a, glm::vec3& b, glm::vec3& c) const;
+
+			/**
+			 * Level of detail mesh.
+			 * @param level Detail level, zero is this mesh and levels past the coarsest give the coarsest.
+			 */
+			Mesh* getLod(unsigned int level);
+
 			/**
 			 * List of mesh vertices.
 			 */
@@ -141,6 +247,16 @@ namespace hawk
 			 */
 			unsigned int mode;
 
+			/**
+			 * Simplified meshes from finer to coarser, released with this mesh.
+			 */
+			std::vector<Mesh*> lods;
+
+			/**
+			 * Triangle clusters, empty if mesh is drawn whole.
+			 */
+			std::vector<Meshlet> meshlets;
+
 		private:
 			/**
 			 * Calculate triangle tangent vectors.
@@ -149,6 +265,11 @@ namespace hawk
 			 */
 			void calculateTangents(std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
 
+			/**
+			 * Calculate bounding box and sphere of vertices.
+			 */
+			void calculateBounds();
+
 			/**
 			 * Vertex array object.
 			 */
@@ -163,6 +284,36 @@ namespace hawk
 			 * Index buffer object.
 			 */
 			unsigned int m_ibo;
+
+			/**
+			 * First vertex in vertex buffer.
+			 */
+			unsigned int m_base_vertex;
+
+			/**
+			 * First element in index buffer.
+			 */
+			unsigned int m_first_index;
+
+			/**
+			 * Is mesh stored in shared geometry arena?
+			 */
+			bool m_in_arena;
+
+			/**
+			 * Local space bounding box.
+			 */
+			Helpers::Bounds::Box m_bounds;
+
+			/**
+			 * Local space bounding sphere.
+			 */
+			Helpers::Bounds::Sphere m_sphere;
+
+			/**
+			 * Triangles tree, built on first use.
+			 */
+			mutable std::atomic<Objects::Bvh*> m_tree;
 		};
 	}
 }
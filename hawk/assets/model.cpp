@@ -1,12 +1,14 @@
 #include "../system/core.hpp"
 #include "model.hpp"
+#include "../objects/mesh_simplifier.hpp"
 #include <sstream>
+#include <cmath>
 
 namespace hawk
 {
 	namespace Assets
 	{
-		Model::Model() : m_importer(nullptr), m_scene(nullptr), m_entity(nullptr)
+		Model::Model() : m_importer(nullptr), m_scene(nullptr), m_entity(nullptr), m_lods(0), m_meshlets(false)
 		{
 			// set asset type
 			m_type = "Model";
@@ -24,7 +26,7 @@ namespace hawk
 		}
 
 		Model::Model(const Model& other) : Asset(other), m_importer(other.m_importer), m_scene(other.m_scene), 
-			m_textures(other.m_textures), m_materials(other.m_materials), m_meshes(other.m_meshes), m_entity(other.m_entity), 
+			m_textures(other.m_textures), m_materials(other.m_materials), m_meshes(other.m_meshes), m_entity(other.m_entity), m_lods(other.m_lods), m_meshlets(other.m_meshlets), 
 			m_textured_shader(other.m_textured_shader), m_textured_normal_shader(other.m_textured_normal_shader), m_textured_parallax_shader(other.m_textured_parallax_shader),
 			m_textured_forward_shader(other.m_textured_forward_shader), m_textured_normal_forward_shader(other.m_textured_normal_forward_shader), m_textured_parallax_forward_shader(other.m_textured_parallax_forward_shader)
 		{
@@ -42,6 +44,8 @@ namespace hawk
 			m_materials = other.m_materials;
 			m_meshes = other.m_meshes;
 			m_entity = other.m_entity;
+			m_lods = other.m_lods;
+			m_meshlets = other.m_meshlets;
 			m_textured_shader = other.m_textured_shader;
 			m_textured_normal_shader = other.m_textured_normal_shader;
 			m_textured_parallax_shader = other.m_textured_parallax_shader;
@@ -50,7 +54,7 @@ namespace hawk
 			m_textured_parallax_forward_shader = other.m_textured_parallax_forward_shader;
 		}
 
-		bool Model::load(const std::string& path)
+		bool Model::load(const std::string& path, unsigned int lods, bool meshlets)
 		{
 			// application
 			System::Core& app = System::Core::getInstance();
@@ -58,6 +62,10 @@ namespace hawk
 			// set asset path
 			setPath(path);
 
+			// set detail levels and meshlets
+			m_lods = lods;
+			m_meshlets = meshlets;
+
 			// make importer
 			m_importer = new Assimp::Importer();
 
@@ -133,6 +141,16 @@ namespace hawk
 			return m_entity;
 		}
 
+		const std::vector<Mesh*>& Model::getMeshes() const
+		{
+			return m_meshes;
+		}
+
+		const std::vector<Material*>& Model::getMaterials() const
+		{
+			return m_materials;
+		}
+
 		bool Model::readAssimpNode(aiNode* node, const aiScene* scene, Objects::Entity* root_entity)
 		{
 			// hawk entity
@@ -253,6 +271,9 @@ namespace hawk
 			// make internal mesh
 			out = new Mesh(vertices, indices);
 
+			// split into meshlets
+			if (m_meshlets) out->buildMeshlets();
+
 			// build mesh
 			if (!out->build())
 			{
@@ -264,6 +285,37 @@ namespace hawk
 				return false;
 			}
 
+			// return if no detail level is required
+			if (m_lods == 0) return true;
+
+			// generate detail levels, each from previous one
+			Objects::MeshSimplifier simplifier;
+
+			if (!simplifier.load(out)) return true;
+
+			for (unsigned int i = 1; i <= m_lods; ++i)
+			{
+				// simplified mesh
+				Mesh* lod = simplifier.simplify(std::pow(0.5f, static_cast<float>(i)));
+
+				// stop if mesh can't be simplified more
+				if (!lod) break;
+
+				// split into meshlets
+				if (m_meshlets) lod->buildMeshlets();
+
+				// build simplified mesh
+				if (!lod->build())
+				{
+					// free mesh
+					lod->release();
+
+					break;
+				}
+
+				out->lods.push_back(lod);
+			}
+
 			return true;
 		}
 
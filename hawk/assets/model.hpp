@@ -52,9 +52,11 @@ namespace hawk
 			/**
 			 * Load model from file.
 			 * @param path Model file path.
+			 * @param lods Simplified meshes to generate per mesh, each keeps half the triangles of previous one.
+			 * @param meshlets Split meshes into meshlets for cluster culling?
 			 * @return True or False.
 			 */
-			bool load(const std::string& path);
+			bool load(const std::string& path, unsigned int lods = 0, bool meshlets = false);
 
 			/**
 			 * Release resources.
@@ -66,6 +68,16 @@ namespace hawk
 			 */
 			Objects::Entity* getEntity() const;
 
+			/**
+			 * Model meshes.
+			 */
+			const std::vector<Mesh*>& getMeshes() const;
+
+			/**
+			 * Model materials.
+			 */
+			const std::vector<Material*>& getMaterials() const;
+
 		private:
 			/**
 			 * Read assimp node recursively.
@@ -139,6 +151,16 @@ namespace hawk
 			 */
 			Objects::Entity* m_entity;
 
+			/**
+			 * Simplified meshes to generate per mesh.
+			 */
+			unsigned int m_lods;
+
+			/**
+			 * Split meshes into meshlets?
+			 */
+			bool m_meshlets;
+
 			/**
 			 * Textured shader.
 			 */
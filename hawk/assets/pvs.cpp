@@ -0,0 +1,429 @@
+#include "../system/core.hpp"
+#include "pvs.hpp"
+#include "../objects/bvh.hpp"
+#include "../components/mesh_renderer.hpp"
+#include <fstream>
+#include <cmath>
+#include <climits>
+
+namespace hawk
+{
+	namespace Assets
+	{
+		Pvs::Pvs() : m_space({ glm::vec3(0.0f), glm::vec3(0.0f) }), m_cell_size(0.0f), m_cells(0), m_words_count(0)
+		{
+			// set asset type
+			m_type = "Pvs";
+		}
+
+		Pvs::~Pvs() {}
+
+		bool Pvs::bake(const std::vector<Components::Renderer*>& renderers, const Helpers::Bounds::Box& space, float cell_size, unsigned int rays)
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// check space
+			if (cell_size <= 0.0f || rays == 0 || space.max.x <= space.min.x || space.max.y <= space.min.y || space.max.z <= space.min.z)
+			{
+				app.logger.error("Invalid visibility bake space!");
+
+				return false;
+			}
+
+			// split space into cells
+			glm::vec3 extent = space.max - space.min;
+
+			m_space = space;
+			m_cell_size = cell_size;
+			m_cells = glm::uvec3(static_cast<unsigned int>(std::fmax(1.0f, std::ceil(extent.x / cell_size))),
+				static_cast<unsigned int>(std::fmax(1.0f, std::ceil(extent.y / cell_size))),
+				static_cast<unsigned int>(std::fmax(1.0f, std::ceil(extent.z / cell_size))));
+
+			// items, boxes and occluder triangles
+			std::vector<Helpers::Bounds::Box> item_bounds;
+			std::vector<glm::uvec2> item_triangles;
+			std::vector<Triangle> triangles;
+
+			m_keys.clear();
+
+			// count keys, renderers sharing a key are left unbaked so they are always drawn
+			std::map<std::string, unsigned int> keys;
+
+			for (auto renderer : renderers)
+				if (renderer->entity && renderer->hasBounds()) keys[getKey(renderer)]++;
+
+			for (auto renderer : renderers)
+			{
+				// continue if renderer can't be placed
+				if (!renderer->entity || !renderer->hasBounds()) continue;
+
+				std::string key = getKey(renderer);
+
+				if (keys[key] > 1)
+				{
+					app.logger.warning("Visibility bake skipped a renderer with a duplicate key!");
+					app.logger.info(key.c_str());
+
+					continue;
+				}
+
+				unsigned int item = static_cast<unsigned int>(m_keys.size());
+				unsigned int first = static_cast<unsigned int>(triangles.size());
+
+				m_keys.push_back(key);
+				item_bounds.push_back(renderer->getWorldBounds());
+
+				// opaque single mesh renderers occlude with their triangles
+				const Mesh* mesh = renderer->mesh;
+
+				bool occluder = renderer->getTypeId() == Components::MeshRenderer::TYPE_ID && mesh && mesh->mode == GL_TRIANGLES &&
+					static_cast<const Components::MeshRenderer*>(renderer)->instances.empty() &&
+					!renderer->materials.empty() && renderer->materials[0]->getMaterialType() != Material::Type::Transparent;
+
+				if (occluder)
+				{
+					// world positions
+					glm::mat4 model = renderer->entity->transform->getModelMatrix();
+
+					std::vector<glm::vec3> positions(mesh->vertices.size());
+
+					for (size_t i = 0; i < mesh->vertices.size(); ++i)
+						positions[i] = glm::vec3(model * glm::vec4(mesh->vertices[i].position, 1.0f));
+
+					// triangles by elements or vertex order
+					size_t count = mesh->indices.empty() ? positions.size() : mesh->indices.size();
+
+					for (size_t i = 0; i + 2 < count; i += 3)
+					{
+						Triangle triangle;
+
+						for (unsigned int k = 0; k < 3; ++k)
+							triangle.vertices[k] = positions[mesh->indices.empty() ? i + k : mesh->indices[i + k]];
+
+						triangle.item = item;
+
+						triangles.push_back(triangle);
+					}
+				}
+
+				item_triangles.push_back(glm::uvec2(first, static_cast<unsigned int>(triangles.size()) - first));
+			}
+
+			unsigned int items_count = static_cast<unsigned int>(m_keys.size());
+			unsigned int cells_count = m_cells.x * m_cells.y * m_cells.z;
+
+			m_words_count = (items_count + 63) / 64;
+			m_bits.assign(static_cast<size_t>(cells_count) * m_words_count, 0);
+
+			// tree over occluder triangles
+			std::vector<Helpers::Bounds::Box> triangle_bounds(triangles.size());
+
+			for (size_t i = 0; i < triangles.size(); ++i)
+			{
+				triangle_bounds[i] = Helpers::Bounds::empty();
+
+				for (unsigned int k = 0; k < 3; ++k)
+					Helpers::Bounds::expand(triangle_bounds[i], triangles[i].vertices[k]);
+			}
+
+			Objects::Bvh tree;
+
+			tree.build(triangle_bounds);
+
+			// bake each cell on workers, a cell writes its own row only
+			for (unsigned int cell = 0; cell < cells_count; ++cell)
+			{
+				app.workers.push([this, cell, rays, items_count, &item_bounds, &item_triangles, &triangles, &tree]()
+				{
+					// cell box
+					glm::vec3 min = m_space.min + glm::vec3(static_cast<float>(cell % m_cells.x), static_cast<float>((cell / m_cells.x) % m_cells.y), static_cast<float>(cell / (m_cells.x * m_cells.y))) * m_cell_size;
+					glm::vec3 size = glm::min(min + glm::vec3(m_cell_size), m_space.max) - min;
+
+					Helpers::Bounds::Box cell_box = { min, min + size };
+
+					// random numbers seeded by cell, bakes are repeatable
+					unsigned int state = cell * 2654435761u + 1u;
+
+					auto random = [&state]()
+					{
+						state ^= state << 13;
+						state ^= state >> 17;
+						state ^= state << 5;
+
+						return static_cast<float>(state & 0xFFFFFF) / 16777216.0f;
+					};
+
+					unsigned long long* row = &m_bits[static_cast<size_t>(cell) * m_words_count];
+
+					for (unsigned int item = 0; item < items_count; ++item)
+					{
+						// items overlapping the cell are visible
+						bool visible = Helpers::Bounds::intersects(cell_box, item_bounds[item]);
+
+						for (unsigned int i = 0; i < rays && !visible; ++i)
+						{
+							// random point in cell
+							glm::vec3 origin = min + size * glm::vec3(random(), random(), random());
+
+							// random point on item triangles or in item box
+							glm::vec3 target;
+
+							if (item_triangles[item].y > 0)
+							{
+								const Triangle& triangle = triangles[item_triangles[item].x + std::min(static_cast<unsigned int>(random() * item_triangles[item].y), item_triangles[item].y - 1)];
+
+								float u = random(), v = random();
+
+								if (u + v > 1.0f)
+								{
+									u = 1.0f - u;
+									v = 1.0f - v;
+								}
+
+								target = triangle.vertices[0] + (triangle.vertices[1] - triangle.vertices[0]) * u + (triangle.vertices[2] - triangle.vertices[0]) * v;
+							}
+							else
+							{
+								const Helpers::Bounds::Box& box = item_bounds[item];
+
+								target = box.min + (box.max - box.min) * glm::vec3(random(), random(), random());
+							}
+
+							// ray towards target
+							glm::vec3 offset = target - origin;
+
+							float distance = glm::length(offset);
+
+							if (distance <= 1e-4f)
+							{
+								visible = true;
+
+								break;
+							}
+
+							Helpers::Bounds::Ray ray = { origin, offset * (1.0f / distance) };
+
+							float length = distance;
+
+							int hit = tree.raycast(ray, length, [&ray, &triangles](unsigned int index, float length)
+							{
+								const Triangle& triangle = triangles[index];
+
+								return Helpers::Bounds::intersects(ray, triangle.vertices[0], triangle.vertices[1], triangle.vertices[2], length);
+							});
+
+							// visible if nothing is in the way or item itself is hit first
+							visible = hit < 0 || triangles[hit].item == item || length >= distance * 0.999f;
+						}
+
+						if (visible) row[item / 64] |= 1ull << (item % 64);
+					}
+				});
+			}
+
+			app.workers.wait();
+
+			// keys lookup
+			mapKeys();
+
+			return true;
+		}
+
+		bool Pvs::save(const std::string& path) const
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// keys section, null terminated strings
+			std::vector<char> keys;
+
+			for (auto& key : m_keys)
+				keys.insert(keys.end(), key.c_str(), key.c_str() + key.size() + 1);
+
+			// header
+			Header header = { MAGIC, VERSION, { m_space.min.x, m_space.min.y, m_space.min.z }, { m_space.max.x, m_space.max.y, m_space.max.z }, m_cell_size,
+				{ m_cells.x, m_cells.y, m_cells.z }, static_cast<unsigned int>(m_keys.size()), m_words_count, static_cast<unsigned int>(keys.size()) };
+
+			// write file
+			std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+			if (!file.is_open())
+			{
+				app.logger.error("Failed to write visibility sets!");
+				app.logger.info(path.c_str());
+
+				return false;
+			}
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+			if (!keys.empty()) file.write(&keys[0], keys.size());
+
+			if (!m_bits.empty()) file.write(reinterpret_cast<const char*>(&m_bits[0]), m_bits.size() * sizeof(unsigned long long));
+
+			file.close();
+
+			return true;
+		}
+
+		bool Pvs::load(const std::string& path)
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// set asset path
+			setPath(path);
+
+			// open file
+			std::ifstream file(path, std::ios::in | std::ios::binary);
+
+			if (!file.is_open())
+			{
+				app.logger.error("Failed to read visibility sets!");
+				app.logger.info(path.c_str());
+
+				return false;
+			}
+
+			// read and check header
+			Header header;
+
+			file.read(reinterpret_cast<char*>(&header), sizeof(Header));
+
+			if (!file || header.magic != MAGIC || header.version != VERSION || header.cell_size <= 0.0f ||
+				header.words_count != (header.items_count + 63) / 64 || header.cells[0] == 0 || header.cells[1] == 0 || header.cells[2] == 0)
+			{
+				app.logger.error("Visibility sets are invalid!");
+				app.logger.info(path.c_str());
+
+				return false;
+			}
+
+			// read keys and bitsets
+			std::vector<char> keys(header.keys_size);
+
+			m_bits.resize(static_cast<size_t>(header.cells[0]) * header.cells[1] * header.cells[2] * header.words_count);
+
+			if (!keys.empty()) file.read(&keys[0], keys.size());
+
+			if (!m_bits.empty()) file.read(reinterpret_cast<char*>(&m_bits[0]), m_bits.size() * sizeof(unsigned long long));
+
+			if (!file)
+			{
+				m_bits.clear();
+
+				app.logger.error("Visibility sets are truncated!");
+				app.logger.info(path.c_str());
+
+				return false;
+			}
+
+			// set properties
+			m_space = { glm::vec3(header.space_min[0], header.space_min[1], header.space_min[2]), glm::vec3(header.space_max[0], header.space_max[1], header.space_max[2]) };
+			m_cell_size = header.cell_size;
+			m_cells = glm::uvec3(header.cells[0], header.cells[1], header.cells[2]);
+			m_words_count = header.words_count;
+
+			// split keys
+			m_keys.clear();
+
+			for (size_t i = 0; i < keys.size() && m_keys.size() < header.items_count;)
+			{
+				size_t end = i;
+
+				while (end < keys.size() && keys[end] != 0) ++end;
+
+				m_keys.push_back(std::string(&keys[i], end - i));
+
+				i = end + 1;
+			}
+
+			m_keys.resize(header.items_count);
+
+			// keys lookup
+			mapKeys();
+
+			return true;
+		}
+
+		void Pvs::release()
+		{
+			// free object
+			delete this;
+		}
+
+		int Pvs::getCell(const glm::vec3& position) const
+		{
+			// return if nothing is baked
+			if (m_bits.empty()) return -1;
+
+			// return if position is outside space
+			if (position.x < m_space.min.x || position.y < m_space.min.y || position.z < m_space.min.z ||
+				position.x > m_space.max.x || position.y > m_space.max.y || position.z > m_space.max.z) return -1;
+
+			// cell coordinates
+			glm::vec3 local = (position - m_space.min) * (1.0f / m_cell_size);
+
+			unsigned int x = std::min(static_cast<unsigned int>(local.x), m_cells.x - 1);
+			unsigned int y = std::min(static_cast<unsigned int>(local.y), m_cells.y - 1);
+			unsigned int z = std::min(static_cast<unsigned int>(local.z), m_cells.z - 1);
+
+			return static_cast<int>(x + m_cells.x * (y + m_cells.y * z));
+		}
+
+		int Pvs::getItem(const Components::Renderer* renderer) const
+		{
+			// return if renderer can't be keyed
+			if (!renderer->entity) return -1;
+
+			auto item = m_items.find(getKey(renderer));
+
+			return (item != m_items.end()) ? static_cast<int>(item->second) : -1;
+		}
+
+		bool Pvs::isVisible(int cell, unsigned int item) const
+		{
+			return (m_bits[static_cast<size_t>(cell) * m_words_count + item / 64] >> (item % 64)) & 1ull;
+		}
+
+		const unsigned long long* Pvs::getBits(int cell) const
+		{
+			return &m_bits[static_cast<size_t>(cell) * m_words_count];
+		}
+
+		unsigned int Pvs::getWordsCount() const
+		{
+			return m_words_count;
+		}
+
+		unsigned int Pvs::getCellsCount() const
+		{
+			return m_cells.x * m_cells.y * m_cells.z;
+		}
+
+		unsigned int Pvs::getItemsCount() const
+		{
+			return static_cast<unsigned int>(m_keys.size());
+		}
+
+		std::string Pvs::getKey(const Components::Renderer* renderer)
+		{
+			// component name and id after entity path of names and ids, ids tell apart siblings of the same name
+			std::string key = renderer->getName() + "#" + std::to_string(renderer->getId());
+
+			for (const Objects::Entity* entity = renderer->entity; entity; entity = entity->parent)
+				key = entity->getName() + "#" + std::to_string(entity->getId()) + "/" + key;
+
+			return key;
+		}
+
+		void Pvs::mapKeys()
+		{
+			m_items.clear();
+
+			for (unsigned int i = 0; i < m_keys.size(); ++i)
+				m_items[m_keys[i]] = i;
+		}
+	}
+}
\ No newline at end of file
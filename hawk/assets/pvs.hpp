@@ -0,0 +1,213 @@
+#ifndef HAWK_ASSETS_PVS_H
+#define HAWK_ASSETS_PVS_H
+
+// stl
+#include <vector>
+#include <map>
+
+// glm
+#include <glm/glm.hpp>
+
+// local
+#include "asset.hpp"
+#include "../helpers/bounds.hpp"
+
+namespace hawk
+{
+	namespace Components
+	{
+		/**
+		 * Renderer forward declaration.
+		 */
+		class Renderer;
+	}
+
+	namespace Assets
+	{
+		/**
+		 * Potentially visible sets of static renderers. A space is split into cells and each cell keeps a bitset of renderers
+		 * seen from inside it, baked by casting rays from random cell points to random points on renderer triangles.
+		 * Renderers are matched by entity path and component name, so sets stay valid across scene loads.
+		 */
+		class Pvs : public Asset
+		{
+		public:
+			/**
+			 * File magic, "HPVS".
+			 */
+			static constexpr unsigned int MAGIC = 0x53565048;
+
+			/**
+			 * File format version.
+			 */
+			static constexpr unsigned int VERSION = 2;
+
+			/**
+			 * Constructor.
+			 */
+			Pvs();
+
+			/**
+			 * Constructor.
+			 * @param other Other object.
+			 */
+			Pvs(const Pvs& other) = delete;
+
+			/**
+			 * Destructor.
+			 */
+			~Pvs();
+
+			/**
+			 * Assignment operator.
+			 * @param other Other object.
+			 */
+			void operator=(const Pvs& other) = delete;
+
+			/**
+			 * Bake visible sets on worker threads. Mesh renderers occlude with their triangles, so their mesh vertices must be kept,
+			 * transparent and instanced renderers are targets only.
+			 * @param renderers Static renderers with world bounds.
+			 * @param space Box camera moves in.
+			 * @param cell_size Cell side length.
+			 * @param rays Rays per cell and renderer.
+			 * @return True or False.
+			 */
+			bool bake(const std::vector<Components::Renderer*>& renderers, const Helpers::Bounds::Box& space, float cell_size, unsigned int rays = 16);
+
+			/**
+			 * Write visible sets to a file.
+			 * @param path File path.
+			 * @return True or False.
+			 */
+			bool save(const std::string& path) const;
+
+			/**
+			 * Read visible sets from a file.
+			 * @param path File path.
+			 * @return True or False.
+			 */
+			bool load(const std::string& path);
+
+			/**
+			 * Release resources.
+			 */
+			void release();
+
+			/**
+			 * Cell containing a position.
+			 * @param position World position.
+			 * @return Cell index or -1 if position is outside space.
+			 */
+			int getCell(const glm::vec3& position) const;
+
+			/**
+			 * Item of a renderer.
+			 * @param renderer Renderer.
+			 * @return Item index or -1 if renderer was not baked.
+			 */
+			int getItem(const Components::Renderer* renderer) const;
+
+			/**
+			 * Is an item visible from a cell?
+			 * @param cell Cell index.
+			 * @param item Item index.
+			 */
+			bool isVisible(int cell, unsigned int item) const;
+
+			/**
+			 * Visible items bitset of a cell, 64 items per word.
+			 * @param cell Cell index.
+			 */
+			const unsigned long long* getBits(int cell) const;
+
+			/**
+			 * Bitset words per cell.
+			 */
+			unsigned int getWordsCount() const;
+
+			/**
+			 * Cells count.
+			 */
+			unsigned int getCellsCount() const;
+
+			/**
+			 * Items count.
+			 */
+			unsigned int getItemsCount() const;
+
+		private:
+			/**
+			 * File header.
+			 */
+			struct Header
+			{
+				unsigned int magic;
+				unsigned int version;
+				float space_min[3];
+				float space_max[3];
+				float cell_size;
+				unsigned int cells[3];
+				unsigned int items_count;
+				unsigned int words_count;
+				unsigned int keys_size;
+			};
+
+			/**
+			 * World space triangle of an item.
+			 */
+			struct Triangle
+			{
+				glm::vec3 vertices[3];
+				unsigned int item;
+			};
+
+			/**
+			 * Renderer key, entity path and component name with their ids, as sibling names may repeat.
+			 * @param renderer Renderer.
+			 */
+			static std::string getKey(const Components::Renderer* renderer);
+
+			/**
+			 * Rebuild keys lookup.
+			 */
+			void mapKeys();
+
+			/**
+			 * Baked space.
+			 */
+			Helpers::Bounds::Box m_space;
+
+			/**
+			 * Cell side length.
+			 */
+			float m_cell_size;
+
+			/**
+			 * Cells count per axis.
+			 */
+			glm::uvec3 m_cells;
+
+			/**
+			 * Item keys by item index.
+			 */
+			std::vector<std::string> m_keys;
+
+			/**
+			 * Item indices by key.
+			 */
+			std::map<std::string, unsigned int> m_items;
+
+			/**
+			 * Bitset words per cell.
+			 */
+			unsigned int m_words_count;
+
+			/**
+			 * Visible items bitsets, one row per cell.
+			 */
+			std::vector<unsigned long long> m_bits;
+		};
+	}
+}
+#endif
\ No newline at end of file
@@ -11,13 +11,13 @@ namespace hawk
 {
 	namespace Assets
 	{
-		Shader::Shader() : m_program(0)
+		Shader::Shader() : m_program(0), m_indirect(false)
 		{
 			// set asset type
 			m_type = "Shader";
 		}
 
-		Shader::Shader(const Shader& other) : Asset(other), m_program(other.m_program), m_uniforms(other.m_uniforms)
+		Shader::Shader(const Shader& other) : Asset(other), m_program(other.m_program), m_uniforms(other.m_uniforms), m_indirect(other.m_indirect)
 		{
 			// set asset type
 			m_type = "Shader";
@@ -29,6 +29,7 @@ namespace hawk
 		{
 			m_program = other.m_program;
 			m_uniforms = other.m_uniforms;
+			m_indirect = other.m_indirect;
 		}
 
 		bool Shader::load(const std::vector<std::string>& paths)
@@ -54,16 +55,20 @@ namespace hawk
 				return false;
 			}
 
-			// add fragment shader slot
-			sources.push_back(std::string());
-
-			// read fragment shader file
-			if (!hawk::Helpers::FileSystem::readTextFile(paths[1].c_str(), sources[1]))
+			// if we have fragment shader, a single path is a compute shader
+			if (paths.size() > 1)
 			{
-				app.logger.error("Failed to read shader source file!");
-				app.logger.info(paths[1].c_str());
+				// add fragment shader slot
+				sources.push_back(std::string());
 
-				return false;
+				// read fragment shader file
+				if (!hawk::Helpers::FileSystem::readTextFile(paths[1].c_str(), sources[1]))
+				{
+					app.logger.error("Failed to read shader source file!");
+					app.logger.info(paths[1].c_str());
+
+					return false;
+				}
 			}
 
 			// if we have geometry shader
@@ -124,9 +129,19 @@ namespace hawk
 				switch (i)
 				{
 				case 0:
-					type = "vertex";
-
-					shaders.push_back(glCreateShader(GL_VERTEX_SHADER));
+					// single source is a compute shader
+					if (sources.size() == 1)
+					{
+						type = "compute";
+
+						shaders.push_back(glCreateShader(GL_COMPUTE_SHADER));
+					}
+					else
+					{
+						type = "vertex";
+
+						shaders.push_back(glCreateShader(GL_VERTEX_SHADER));
+					}
 					break;
 				case 1:
 					type = "fragment";
@@ -224,6 +239,9 @@ namespace hawk
 				}
 			}
 
+			// cache draws buffer support for per frame checks
+			m_indirect = m_uniforms.count("indirect") != 0;
+
 			return true;
 		}
 
@@ -235,6 +253,9 @@ namespace hawk
 				glDeleteProgram(m_program);
 
 				m_program = 0;
+
+				// deleted names may be reused
+				System::Core::getInstance().video.resetBindings();
 			}
 
 			// free object
@@ -251,6 +272,11 @@ namespace hawk
 			return m_uniforms;
 		}
 
+		bool Shader::isIndirect() const
+		{
+			return m_indirect;
+		}
+
 		void Shader::setBool(const char* name, const int value)
 		{
 			setInt(name, value);
@@ -64,14 +64,14 @@ namespace hawk
 
 			/**
 			 * Load shader from file.
-			 * @param paths Shader paths. The order is vertex, fragment, geometry shader.
+			 * @param paths Shader paths. The order is vertex, fragment, geometry shader, or a single compute shader.
 			 * @return True or False.
 			 */
 			bool load(const std::vector<std::string>& paths);
 
 			/**
 			 * Build shader.
-			 * @param sources Shader sources. The order is vertex, fragment, geometry shader.
+			 * @param sources Shader sources. The order is vertex, fragment, geometry shader, or a single compute shader.
 			 * @return True or False.
 			 */
 			bool build(const std::vector<std::string>& sources);
@@ -91,6 +91,11 @@ namespace hawk
 			 */
 			const std::map<std::string, Uniform>& getUniforms() const;
 
+			/**
+			 * Does shader read draw parameters from draws buffer by its indirect uniform?
+			 */
+			bool isIndirect() const;
+
 			/**
 			 * Set a uniform bool variable.
 			 */
@@ -398,6 +403,11 @@ namespace hawk
 			 * Active uniforms list.
 			 */
 			std::map<std::string, Uniform> m_uniforms;
+
+			/**
+			 * Shader has indirect uniform, found at link.
+			 */
+			bool m_indirect;
 		};
 	}
 }
@@ -0,0 +1,698 @@
+#include "../system/core.hpp"
+#include "snapshot.hpp"
+#include "model.hpp"
+#include "../objects/entity.hpp"
+#include "../components/mesh_renderer.hpp"
+#include "../components/audio_listener.hpp"
+#include "../components/audio_player.hpp"
+#include "../components/audio_reverb_zone.hpp"
+#include "../helpers/memory.hpp"
+#include <fstream>
+#ifdef WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace hawk
+{
+	namespace Assets
+	{
+		/**
+		 * Invalid reference or string index.
+		 */
+		static const unsigned int invalid_index = 0xFFFFFFFF;
+
+		/**
+		 * Append a plain value to a byte buffer.
+		 * @param buffer Byte buffer.
+		 * @param value Plain value.
+		 * @return Value offset in buffer.
+		 */
+		template<typename T>
+		static unsigned int append(std::vector<unsigned char>& buffer, const T& value)
+		{
+			// value offset
+			unsigned int offset = static_cast<unsigned int>(buffer.size());
+
+			// copy bytes
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+
+			buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+
+			return offset;
+		}
+
+		/**
+		 * Append a list of plain values to a byte buffer.
+		 * @param buffer Byte buffer.
+		 * @param values Plain values.
+		 * @return List offset in buffer.
+		 */
+		template<typename T>
+		static unsigned int appendList(std::vector<unsigned char>& buffer, const std::vector<T>& values)
+		{
+			// list offset
+			unsigned int offset = static_cast<unsigned int>(buffer.size());
+
+			// copy bytes
+			if (!values.empty())
+			{
+				const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&values[0]);
+
+				buffer.insert(buffer.end(), bytes, bytes + values.size() * sizeof(T));
+			}
+
+			return offset;
+		}
+
+		Snapshot::Snapshot() : m_data(nullptr), m_size(0), m_header(nullptr)
+		{
+			// set asset type
+			m_type = "Snapshot";
+		}
+
+		Snapshot::~Snapshot() {}
+
+		bool Snapshot::save(const std::string& path, const std::vector<Objects::Entity*>& roots)
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// writer state
+			Writer writer;
+
+			// index named assets
+			for (auto& asset : app.assets.textures)
+				writer.assets[asset.second] = { Kind::Texture, writeString(writer, asset.first), invalid_index, -1 };
+
+			for (auto& asset : app.assets.materials)
+				writer.assets[asset.second] = { Kind::Material, writeString(writer, asset.first), invalid_index, -1 };
+
+			for (auto& asset : app.assets.meshes)
+				writer.assets[asset.second] = { Kind::Mesh, writeString(writer, asset.first), invalid_index, -1 };
+
+			for (auto& asset : app.assets.sounds)
+				writer.assets[asset.second] = { Kind::Sound, writeString(writer, asset.first), invalid_index, -1 };
+
+			// index model assets
+			for (auto& model : app.assets.models)
+			{
+				for (size_t i = 0; i < model.second->getMaterials().size(); ++i)
+					writer.assets.insert(std::make_pair(model.second->getMaterials()[i], ReferenceRecord { Kind::Material, invalid_index, writeString(writer, model.first), static_cast<int>(i) }));
+
+				for (size_t i = 0; i < model.second->getMeshes().size(); ++i)
+					writer.assets.insert(std::make_pair(model.second->getMeshes()[i], ReferenceRecord { Kind::Mesh, invalid_index, writeString(writer, model.first), static_cast<int>(i) }));
+			}
+
+			// flatten trees breadth first so parents precede their children
+			std::vector<Objects::Entity*> nodes(roots.begin(), roots.end());
+			std::vector<int> parents(roots.size(), -1);
+
+			for (size_t i = 0; i < nodes.size(); ++i)
+			{
+				for (auto entity : nodes[i]->entities)
+				{
+					nodes.push_back(entity.second);
+					parents.push_back(static_cast<int>(i));
+				}
+			}
+
+			// write entities
+			for (size_t i = 0; i < nodes.size(); ++i)
+			{
+				Objects::Entity* entity = nodes[i];
+
+				// entity record
+				EntityRecord record = { writeString(writer, entity->getName()), parents[i], entity->enable ? 1u : 0u, entity->isStatic() ? 1u : 0u,
+					static_cast<unsigned int>(writer.components.size()), 0 };
+
+				// write components
+				for (auto component : entity->components)
+				{
+					// component record
+					ComponentRecord component_record = { component.second->getTypeId(), writeString(writer, component.second->getName()), component.second->enable ? 1u : 0u, 0 };
+
+					// skip unsupported components
+					if (!writeComponent(writer, component.second, component_record))
+					{
+						app.logger.warning("Snapshot skipped a component with unsupported type!");
+						app.logger.info(component.second->getType());
+
+						continue;
+					}
+
+					writer.components.push_back(component_record);
+
+					record.components_count++;
+				}
+
+				writer.entities.push_back(record);
+			}
+
+			// header
+			Header header;
+
+			header.magic = MAGIC;
+			header.version = VERSION;
+
+			// file content
+			std::vector<unsigned char> buffer(sizeof(Header));
+
+			header.entities_count = static_cast<unsigned int>(writer.entities.size());
+			header.entities_offset = appendList(buffer, writer.entities);
+			header.components_count = static_cast<unsigned int>(writer.components.size());
+			header.components_offset = appendList(buffer, writer.components);
+			header.references_count = static_cast<unsigned int>(writer.references.size());
+			header.references_offset = appendList(buffer, writer.references);
+			header.lists_count = static_cast<unsigned int>(writer.lists.size());
+			header.lists_offset = appendList(buffer, writer.lists);
+			header.data_size = static_cast<unsigned int>(writer.data.size());
+			header.data_offset = appendList(buffer, writer.data);
+
+			// pad strings to keep file size aligned
+			while (writer.strings.size() % 4) writer.strings.push_back(0);
+
+			header.strings_size = static_cast<unsigned int>(writer.strings.size());
+			header.strings_offset = appendList(buffer, writer.strings);
+
+			// set header
+			hawk::Helpers::Memory::copy(&header, &buffer[0], sizeof(Header));
+
+			// write file
+			std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+			if (!file.is_open())
+			{
+				app.logger.error("Failed to write snapshot!");
+				app.logger.info(path.c_str());
+
+				return false;
+			}
+
+			file.write(reinterpret_cast<const char*>(&buffer[0]), buffer.size());
+
+			file.close();
+
+			return true;
+		}
+
+		bool Snapshot::load(const std::string& path)
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// set asset path
+			setPath(path);
+
+#ifdef WINDOWS
+			// open file
+			HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+			if (file != INVALID_HANDLE_VALUE)
+			{
+				// file size
+				LARGE_INTEGER size;
+
+				if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+				{
+					// map whole file, view keeps the mapping alive
+					HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+					if (mapping)
+					{
+						m_data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+						m_size = static_cast<size_t>(size.QuadPart);
+
+						CloseHandle(mapping);
+					}
+				}
+
+				CloseHandle(file);
+			}
+#else
+			// open file
+			int file = open(path.c_str(), O_RDONLY);
+
+			if (file >= 0)
+			{
+				// file size
+				struct stat info;
+
+				if (fstat(file, &info) == 0 && info.st_size > 0)
+				{
+					// map whole file, mapping stays valid after file is closed
+					void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+					if (data != MAP_FAILED)
+					{
+						m_data = static_cast<const unsigned char*>(data);
+						m_size = static_cast<size_t>(info.st_size);
+					}
+				}
+
+				close(file);
+			}
+#endif
+			// check mapping
+			if (!m_data)
+			{
+				app.logger.error("Failed to map snapshot!");
+				app.logger.info(path.c_str());
+
+				return false;
+			}
+
+			// header in place
+			m_header = reinterpret_cast<const Header*>(m_data);
+
+			// check header and sections bounds
+			if (m_size < sizeof(Header) || m_header->magic != MAGIC || m_header->version != VERSION ||
+				m_header->entities_offset + static_cast<size_t>(m_header->entities_count) * sizeof(EntityRecord) > m_size ||
+				m_header->components_offset + static_cast<size_t>(m_header->components_count) * sizeof(ComponentRecord) > m_size ||
+				m_header->references_offset + static_cast<size_t>(m_header->references_count) * sizeof(ReferenceRecord) > m_size ||
+				m_header->lists_offset + static_cast<size_t>(m_header->lists_count) * sizeof(unsigned int) > m_size ||
+				m_header->data_offset + static_cast<size_t>(m_header->data_size) > m_size ||
+				m_header->strings_offset + static_cast<size_t>(m_header->strings_size) > m_size ||
+				(m_header->strings_size > 0 && m_data[m_header->strings_offset + m_header->strings_size - 1] != 0))
+			{
+				app.logger.error("Snapshot is invalid!");
+				app.logger.info(path.c_str());
+
+				return false;
+			}
+
+			// fix up asset references
+			const ReferenceRecord* references = reinterpret_cast<const ReferenceRecord*>(m_data + m_header->references_offset);
+
+			m_references.assign(m_header->references_count, nullptr);
+
+			for (unsigned int i = 0; i < m_header->references_count; ++i)
+			{
+				const ReferenceRecord& reference = references[i];
+
+				// model asset
+				if (reference.index >= 0)
+				{
+					auto model = app.assets.models.find(getString(reference.model));
+
+					if (model != app.assets.models.end())
+					{
+						if (reference.kind == Kind::Material && static_cast<size_t>(reference.index) < model->second->getMaterials().size())
+							m_references[i] = model->second->getMaterials()[reference.index];
+						else if (reference.kind == Kind::Mesh && static_cast<size_t>(reference.index) < model->second->getMeshes().size())
+							m_references[i] = model->second->getMeshes()[reference.index];
+					}
+				}
+				else
+				{
+					// asset name
+					const char* name = getString(reference.name);
+
+					switch (reference.kind)
+					{
+					case Kind::Texture:
+						if (app.assets.textures.count(name)) m_references[i] = app.assets.textures[name];
+						break;
+					case Kind::Material:
+						if (app.assets.materials.count(name)) m_references[i] = app.assets.materials[name];
+						break;
+					case Kind::Mesh:
+						if (app.assets.meshes.count(name)) m_references[i] = app.assets.meshes[name];
+						break;
+					case Kind::Sound:
+						if (app.assets.sounds.count(name)) m_references[i] = app.assets.sounds[name];
+						break;
+					}
+				}
+
+				// assets must be loaded before snapshot
+				if (!m_references[i])
+				{
+					app.logger.error("Snapshot references an asset which is not loaded!");
+					app.logger.info(getString(reference.index >= 0 ? reference.model : reference.name));
+
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		void Snapshot::release()
+		{
+			// unmap file
+			if (m_data)
+			{
+#ifdef WINDOWS
+				UnmapViewOfFile(m_data);
+#else
+				munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+			}
+
+			// free object
+			delete this;
+		}
+
+		std::vector<Objects::Entity*> Snapshot::instantiate(Objects::Entity* parent)
+		{
+			// list of roots
+			std::vector<Objects::Entity*> roots;
+
+			// return if not loaded
+			if (!m_header) return roots;
+
+			// records in place
+			const EntityRecord* records = reinterpret_cast<const EntityRecord*>(m_data + m_header->entities_offset);
+			const ComponentRecord* components = reinterpret_cast<const ComponentRecord*>(m_data + m_header->components_offset);
+
+			// reserve pool slots
+			System::Core::getInstance().scene.pool.reserve(m_header->entities_count);
+
+			// made entities
+			std::vector<Objects::Entity*> entities(m_header->entities_count, nullptr);
+
+			for (unsigned int i = 0; i < m_header->entities_count; ++i)
+			{
+				const EntityRecord& record = records[i];
+
+				// new entity
+				Objects::Entity* entity = new Objects::Entity();
+
+				entity->enable = record.enable != 0;
+
+				// add components, list must be in bounds
+				unsigned int first = record.first_component, count = record.components_count;
+
+				if (first > m_header->components_count || m_header->components_count - first < count) count = 0;
+
+				for (unsigned int c = first; c < first + count; ++c)
+				{
+					Components::Component* component = readComponent(components[c]);
+
+					if (component)
+					{
+						component->enable = components[c].enable != 0;
+
+						entity->addComponent(getString(components[c].name), component);
+					}
+				}
+
+				// add to parent
+				if (record.parent >= 0 && static_cast<unsigned int>(record.parent) < i)
+					entities[record.parent]->addEntity(getString(record.name), entity);
+				else
+				{
+					if (parent) parent->addEntity(getString(record.name), entity);
+
+					roots.push_back(entity);
+				}
+
+				// set movement
+				if (record.is_static) entity->setStatic(true);
+
+				entities[i] = entity;
+			}
+
+			return roots;
+		}
+
+		bool Snapshot::writeComponent(Writer& writer, Components::Component* component, ComponentRecord& record)
+		{
+			// data offset
+			record.data = static_cast<unsigned int>(writer.data.size());
+
+			switch (component->getTypeId())
+			{
+			case Components::Transform::TYPE_ID:
+			{
+				Components::Transform* transform = static_cast<Components::Transform*>(component);
+
+				TransformData data;
+
+				glm::vec3 position = transform->getPosition(), rotation = transform->getRotation(), scale = transform->getScale();
+
+				for (int i = 0; i < 3; ++i)
+				{
+					data.position[i] = position[i];
+					data.rotation[i] = rotation[i];
+					data.scale[i] = scale[i];
+				}
+
+				append(writer.data, data);
+
+				return true;
+			}
+			case Components::Camera::TYPE_ID:
+			{
+				Components::Camera* camera = static_cast<Components::Camera*>(component);
+
+				CameraData data;
+
+				data.projection = static_cast<unsigned int>(camera->projection);
+
+				for (int i = 0; i < 4; ++i)
+				{
+					data.background[i] = camera->background[i];
+					data.viewport[i] = camera->viewport[i];
+				}
+
+				data.fov = camera->fov;
+				data.near_plane = camera->near_plane;
+				data.far_plane = camera->far_plane;
+				data.skybox = writeReference(writer, camera->skybox);
+				data.irradiance = writeReference(writer, camera->irradiance);
+				data.radiance = writeReference(writer, camera->radiance);
+				data.first_material = static_cast<unsigned int>(writer.lists.size());
+				data.materials_count = static_cast<unsigned int>(camera->materials.size());
+
+				for (auto material : camera->materials)
+					writer.lists.push_back(writeReference(writer, material));
+
+				append(writer.data, data);
+
+				return true;
+			}
+			case Components::Light::TYPE_ID:
+			{
+				Components::Light* light = static_cast<Components::Light*>(component);
+
+				LightData data;
+
+				data.type = static_cast<int>(light->getLightType());
+
+				for (int i = 0; i < 4; ++i)
+				{
+					data.color[i] = light->color[i];
+					data.frustum[i] = light->frustum[i];
+				}
+
+				data.intensity = light->intensity;
+				data.range = light->range;
+				data.cut_off = light->cut_off;
+				data.outer_cut_off = light->outer_cut_off;
+				data.cast_shadows = light->cast_shadows ? 1 : 0;
+				data.near_plane = light->near_plane;
+				data.far_plane = light->far_plane;
+
+				append(writer.data, data);
+
+				return true;
+			}
+			case Components::Renderer::TYPE_ID:
+			case Components::MeshRenderer::TYPE_ID:
+			{
+				Components::Renderer* renderer = static_cast<Components::Renderer*>(component);
+
+				RendererData data;
+
+				data.mesh = writeReference(writer, renderer->mesh);
+				data.first_material = static_cast<unsigned int>(writer.lists.size());
+				data.materials_count = static_cast<unsigned int>(renderer->materials.size());
+				data.shadows = static_cast<unsigned int>(renderer->shadows);
+				data.cast_shadows = renderer->cast_shadows ? 1 : 0;
+				data.mode = renderer->mode;
+
+				for (auto material : renderer->materials)
+					writer.lists.push_back(writeReference(writer, material));
+
+				append(writer.data, data);
+
+				return true;
+			}
+			case Components::AudioListener::TYPE_ID:
+				return true;
+			case Components::AudioPlayer::TYPE_ID:
+			{
+				Components::AudioPlayer* player = static_cast<Components::AudioPlayer*>(component);
+
+				AudioPlayerData data = { writeReference(writer, player->sound), player->play_on_start ? 1u : 0u, player->loop ? 1u : 0u };
+
+				append(writer.data, data);
+
+				return true;
+			}
+			case Components::AudioReverbZone::TYPE_ID:
+			{
+				Components::AudioReverbZone* zone = static_cast<Components::AudioReverbZone*>(component);
+
+				AudioReverbZoneData data = { zone->min_dist, zone->max_dist };
+
+				append(writer.data, data);
+
+				return true;
+			}
+			}
+
+			return false;
+		}
+
+		unsigned int Snapshot::writeReference(Writer& writer, const void* asset)
+		{
+			// return if there is no asset
+			if (!asset) return invalid_index;
+
+			// return if already referenced
+			auto index = writer.indices.find(asset);
+
+			if (index != writer.indices.end()) return index->second;
+
+			// find asset name
+			auto record = writer.assets.find(asset);
+
+			if (record == writer.assets.end())
+			{
+				System::Core::getInstance().logger.warning("Snapshot skipped an asset which is not in assets manager!");
+
+				return invalid_index;
+			}
+
+			// add reference
+			unsigned int result = static_cast<unsigned int>(writer.references.size());
+
+			writer.references.push_back(record->second);
+			writer.indices[asset] = result;
+
+			return result;
+		}
+
+		unsigned int Snapshot::writeString(Writer& writer, const std::string& string)
+		{
+			// string offset
+			unsigned int offset = static_cast<unsigned int>(writer.strings.size());
+
+			// copy with terminator
+			writer.strings.insert(writer.strings.end(), string.begin(), string.end());
+			writer.strings.push_back(0);
+
+			return offset;
+		}
+
+		Components::Component* Snapshot::readComponent(const ComponentRecord& record) const
+		{
+			switch (record.type_id)
+			{
+			case Components::Transform::TYPE_ID:
+			{
+				const TransformData* transform = getData<TransformData>(record.data);
+
+				if (!transform) break;
+
+				return new Components::Transform(glm::vec3(transform->position[0], transform->position[1], transform->position[2]),
+					glm::vec3(transform->rotation[0], transform->rotation[1], transform->rotation[2]),
+					glm::vec3(transform->scale[0], transform->scale[1], transform->scale[2]));
+			}
+			case Components::Camera::TYPE_ID:
+			{
+				const CameraData* parameters = getData<CameraData>(record.data);
+
+				if (!parameters) break;
+
+				Components::Camera* camera = new Components::Camera(static_cast<Components::Camera::Projection>(parameters->projection),
+					glm::vec4(parameters->background[0], parameters->background[1], parameters->background[2], parameters->background[3]),
+					glm::ivec4(parameters->viewport[0], parameters->viewport[1], parameters->viewport[2], parameters->viewport[3]));
+
+				camera->fov = parameters->fov;
+				camera->near_plane = parameters->near_plane;
+				camera->far_plane = parameters->far_plane;
+				camera->skybox = getReference<Material>(parameters->skybox);
+				camera->irradiance = getReference<Texture>(parameters->irradiance);
+				camera->radiance = getReference<Texture>(parameters->radiance);
+				camera->materials = getReferences<Material>(parameters->first_material, parameters->materials_count);
+
+				return camera;
+			}
+			case Components::Light::TYPE_ID:
+			{
+				const LightData* parameters = getData<LightData>(record.data);
+
+				if (!parameters) break;
+
+				Components::Light* light = new Components::Light(static_cast<Components::Light::Type>(parameters->type),
+					glm::vec4(parameters->color[0], parameters->color[1], parameters->color[2], parameters->color[3]),
+					parameters->intensity, parameters->range, parameters->cast_shadows != 0, parameters->near_plane, parameters->far_plane);
+
+				light->cut_off = parameters->cut_off;
+				light->outer_cut_off = parameters->outer_cut_off;
+				light->frustum = glm::vec4(parameters->frustum[0], parameters->frustum[1], parameters->frustum[2], parameters->frustum[3]);
+
+				return light;
+			}
+			case Components::Renderer::TYPE_ID:
+			case Components::MeshRenderer::TYPE_ID:
+			{
+				const RendererData* parameters = getData<RendererData>(record.data);
+
+				if (!parameters) break;
+
+				Components::Renderer* renderer = nullptr;
+
+				if (record.type_id == Components::MeshRenderer::TYPE_ID)
+					renderer = new Components::MeshRenderer(nullptr, getReference<Mesh>(parameters->mesh), static_cast<Components::Renderer::Shadows>(parameters->shadows), parameters->mode);
+				else
+				{
+					renderer = new Components::Renderer();
+
+					renderer->mesh = getReference<Mesh>(parameters->mesh);
+					renderer->shadows = static_cast<Components::Renderer::Shadows>(parameters->shadows);
+					renderer->mode = parameters->mode;
+				}
+
+				renderer->cast_shadows = parameters->cast_shadows != 0;
+				renderer->materials = getReferences<Material>(parameters->first_material, parameters->materials_count);
+
+				return renderer;
+			}
+			case Components::AudioListener::TYPE_ID:
+				return new Components::AudioListener();
+			case Components::AudioPlayer::TYPE_ID:
+			{
+				const AudioPlayerData* parameters = getData<AudioPlayerData>(record.data);
+
+				if (!parameters) break;
+
+				return new Components::AudioPlayer(getReference<Sound>(parameters->sound), parameters->play_on_start != 0, parameters->loop != 0);
+			}
+			case Components::AudioReverbZone::TYPE_ID:
+			{
+				const AudioReverbZoneData* parameters = getData<AudioReverbZoneData>(record.data);
+
+				if (!parameters) break;
+
+				return new Components::AudioReverbZone(parameters->min_dist, parameters->max_dist);
+			}
+			}
+
+			return nullptr;
+		}
+
+		const char* Snapshot::getString(unsigned int offset) const
+		{
+			return (offset < m_header->strings_size) ? reinterpret_cast<const char*>(m_data + m_header->strings_offset + offset) : "";
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,372 @@
+#ifndef HAWK_ASSETS_SNAPSHOT_H
+#define HAWK_ASSETS_SNAPSHOT_H
+
+// stl
+#include <vector>
+#include <map>
+
+// local
+#include "asset.hpp"
+
+namespace hawk
+{
+	namespace Objects
+	{
+		/**
+		 * Entity forward declaration.
+		 */
+		class Entity;
+	}
+
+	namespace Components
+	{
+		/**
+		 * Component forward declaration.
+		 */
+		class Component;
+	}
+
+	namespace Assets
+	{
+		/**
+		 * Binary scene snapshot. Stores entity hierarchy, transforms, component parameters and asset references,
+		 * file is memory mapped on load and records are read in place.
+		 */
+		class Snapshot : public Asset
+		{
+		public:
+			/**
+			 * File magic, "HWKS".
+			 */
+			static constexpr unsigned int MAGIC = 0x534B5748;
+
+			/**
+			 * File format version.
+			 */
+			static constexpr unsigned int VERSION = 1;
+
+			/**
+			 * Constructor.
+			 */
+			Snapshot();
+
+			/**
+			 * Constructor.
+			 * @param other Other object.
+			 */
+			Snapshot(const Snapshot& other) = delete;
+
+			/**
+			 * Destructor.
+			 */
+			~Snapshot();
+
+			/**
+			 * Assignment operator.
+			 * @param other Other object.
+			 */
+			void operator=(const Snapshot& other) = delete;
+
+			/**
+			 * Write entity trees to a snapshot file.
+			 * @param path Snapshot file path.
+			 * @param roots Root entities.
+			 * @return True or False.
+			 */
+			static bool save(const std::string& path, const std::vector<Objects::Entity*>& roots);
+
+			/**
+			 * Map snapshot file and resolve its asset references.
+			 * @param path Snapshot file path.
+			 * @return True or False.
+			 */
+			bool load(const std::string& path);
+
+			/**
+			 * Release resources.
+			 */
+			void release();
+
+			/**
+			 * Make entities of snapshot.
+			 * @param parent Entity to add root entities to.
+			 * @return List of root entities.
+			 */
+			std::vector<Objects::Entity*> instantiate(Objects::Entity* parent);
+
+		private:
+			/**
+			 * Asset reference kind enum.
+			 */
+			enum class Kind : unsigned int
+			{
+				Texture,
+				Material,
+				Mesh,
+				Sound
+			};
+
+			/**
+			 * File header.
+			 */
+			struct Header
+			{
+				unsigned int magic;
+				unsigned int version;
+				unsigned int entities_count;
+				unsigned int entities_offset;
+				unsigned int components_count;
+				unsigned int components_offset;
+				unsigned int references_count;
+				unsigned int references_offset;
+				unsigned int lists_count;
+				unsigned int lists_offset;
+				unsigned int data_size;
+				unsigned int data_offset;
+				unsigned int strings_size;
+				unsigned int strings_offset;
+			};
+
+			/**
+			 * Entity record, parents precede their children.
+			 */
+			struct EntityRecord
+			{
+				unsigned int name;
+				int parent;
+				unsigned int enable;
+				unsigned int is_static;
+				unsigned int first_component;
+				unsigned int components_count;
+			};
+
+			/**
+			 * Component record.
+			 */
+			struct ComponentRecord
+			{
+				unsigned int type_id;
+				unsigned int name;
+				unsigned int enable;
+				unsigned int data;
+			};
+
+			/**
+			 * Asset reference record, named assets have index -1, model assets are found by model name and index.
+			 */
+			struct ReferenceRecord
+			{
+				Kind kind;
+				unsigned int name;
+				unsigned int model;
+				int index;
+			};
+
+			/**
+			 * Transform parameters.
+			 */
+			struct TransformData
+			{
+				float position[3];
+				float rotation[3];
+				float scale[3];
+			};
+
+			/**
+			 * Camera parameters.
+			 */
+			struct CameraData
+			{
+				unsigned int projection;
+				float background[4];
+				int viewport[4];
+				float fov;
+				float near_plane;
+				float far_plane;
+				unsigned int skybox;
+				unsigned int irradiance;
+				unsigned int radiance;
+				unsigned int first_material;
+				unsigned int materials_count;
+			};
+
+			/**
+			 * Light parameters.
+			 */
+			struct LightData
+			{
+				int type;
+				float color[4];
+				float intensity;
+				float range;
+				float cut_off;
+				float outer_cut_off;
+				unsigned int cast_shadows;
+				float frustum[4];
+				float near_plane;
+				float far_plane;
+			};
+
+			/**
+			 * Renderer parameters.
+			 */
+			struct RendererData
+			{
+				unsigned int mesh;
+				unsigned int first_material;
+				unsigned int materials_count;
+				unsigned int shadows;
+				unsigned int cast_shadows;
+				unsigned int mode;
+			};
+
+			/**
+			 * Audio player parameters.
+			 */
+			struct AudioPlayerData
+			{
+				unsigned int sound;
+				unsigned int play_on_start;
+				unsigned int loop;
+			};
+
+			/**
+			 * Audio reverb zone parameters.
+			 */
+			struct AudioReverbZoneData
+			{
+				float min_dist;
+				float max_dist;
+			};
+
+			/**
+			 * Snapshot writer state.
+			 */
+			struct Writer
+			{
+				std::vector<EntityRecord> entities;
+				std::vector<ComponentRecord> components;
+				std::vector<ReferenceRecord> references;
+				std::vector<unsigned int> lists;
+				std::vector<unsigned char> data;
+				std::vector<char> strings;
+				std::map<const void*, ReferenceRecord> assets;
+				std::map<const void*, unsigned int> indices;
+			};
+
+			/**
+			 * Write component parameters.
+			 * @param writer Writer state.
+			 * @param component Component object.
+			 * @param record Component record to fill.
+			 * @return False if component type is not supported.
+			 */
+			static bool writeComponent(Writer& writer, Components::Component* component, ComponentRecord& record);
+
+			/**
+			 * Index of an asset reference, added on first use.
+			 * @param writer Writer state.
+			 * @param asset Asset pointer.
+			 * @return Reference index or invalid.
+			 */
+			static unsigned int writeReference(Writer& writer, const void* asset);
+
+			/**
+			 * Offset of a string in strings section.
+			 * @param writer Writer state.
+			 * @param string String value.
+			 */
+			static unsigned int writeString(Writer& writer, const std::string& string);
+
+			/**
+			 * Make a component from its record.
+			 * @param record Component record.
+			 * @return A pointer to component or nullptr if type is not supported.
+			 */
+			Components::Component* readComponent(const ComponentRecord& record) const;
+
+			/**
+			 * Parameters of data section, checked against section size.
+			 * @param offset Parameters offset.
+			 * @return A pointer to parameters or nullptr if out of bounds.
+			 */
+			template<typename T>
+			const T* getData(unsigned int offset) const;
+
+			/**
+			 * Resolved asset of a reference index.
+			 * @param index Reference index.
+			 */
+			template<typename T>
+			T* getReference(unsigned int index) const;
+
+			/**
+			 * Resolved assets of a reference list.
+			 * @param first First list index.
+			 * @param count List size.
+			 */
+			template<typename T>
+			std::vector<T*> getReferences(unsigned int first, unsigned int count) const;
+
+			/**
+			 * String of strings section.
+			 * @param offset String offset.
+			 */
+			const char* getString(unsigned int offset) const;
+
+			/**
+			 * Mapped file content.
+			 */
+			const unsigned char* m_data;
+
+			/**
+			 * Mapped file size.
+			 */
+			size_t m_size;
+
+			/**
+			 * File header.
+			 */
+			const Header* m_header;
+
+			/**
+			 * Resolved asset references.
+			 */
+			std::vector<void*> m_references;
+		};
+
+		template<typename T>
+		const T* Snapshot::getData(unsigned int offset) const
+		{
+			// parameters must fit in data section
+			if (offset > m_header->data_size || m_header->data_size - offset < sizeof(T)) return nullptr;
+
+			return reinterpret_cast<const T*>(m_data + m_header->data_offset + offset);
+		}
+
+		template<typename T>
+		T* Snapshot::getReference(unsigned int index) const
+		{
+			return (index < m_references.size()) ? static_cast<T*>(m_references[index]) : nullptr;
+		}
+
+		template<typename T>
+		std::vector<T*> Snapshot::getReferences(unsigned int first, unsigned int count) const
+		{
+			// list of assets
+			std::vector<T*> result;
+
+			// return if list is out of bounds
+			if (first > m_header->lists_count || m_header->lists_count - first < count) return result;
+
+			// list indices
+			const unsigned int* list = reinterpret_cast<const unsigned int*>(m_data + m_header->lists_offset);
+
+			for (unsigned int i = first; i < first + count; ++i)
+				result.push_back(getReference<T>(list[i]));
+
+			return result;
+		}
+	}
+}
+#endif
\ No newline at end of file
@@ -405,6 +405,9 @@ namespace hawk
 			// unbind texture
 			glBindTexture(target, 0);
 
+			// bindings changed behind video manager
+			System::Core::getInstance().video.resetBindings();
+
 			// set properties
 			m_width = width[0];
 			m_height = height[0];
@@ -421,6 +424,9 @@ namespace hawk
 				glDeleteTextures(1, &m_texture);
 
 				m_texture = 0;
+
+				// deleted names may be reused
+				System::Core::getInstance().video.resetBindings();
 			}
 
 			// free object
@@ -429,11 +435,8 @@ namespace hawk
 
 		void Texture::bind(unsigned int unit)
 		{
-			// activate texture
-			glActiveTexture(GL_TEXTURE0 + unit);
-
-			// bind texture
-			glBindTexture(m_target, m_texture);
+			// bind texture unless unit already holds it
+			System::Core::getInstance().video.bindTexture(unit, m_texture);
 		}
 
 		unsigned int Texture::getTexture() const
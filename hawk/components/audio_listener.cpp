@@ -9,6 +9,10 @@ namespace hawk
 		{
 			// set component type
 			m_type = "AudioListener";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update;
 		}
 
 		AudioListener::AudioListener(const AudioListener& other) : Component(other), 
@@ -16,6 +20,10 @@ namespace hawk
 		{
 			// set component type
 			m_type = "AudioListener";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update;
 		}
 
 		AudioListener::~AudioListener() {}
@@ -32,18 +40,6 @@ namespace hawk
 			return new AudioListener(*this);
 		}
 
-		void AudioListener::sendMessage(const char* message)
-		{
-			// return if not enable
-			if (!enable) return;
-
-			// events
-			if (std::strcmp(message, "Start") == 0)
-				start();
-			else if (std::strcmp(message, "Update") == 0)
-				update();
-		}
-
 		void AudioListener::release()
 		{
 			// free object
@@ -17,6 +17,11 @@ namespace hawk
 		class AudioListener : public Component
 		{
 		public:
+			/**
+			 * Component type id.
+			 */
+			static constexpr unsigned int TYPE_ID = 6;
+
 			/**
 			 * Constructor.
 			 */
@@ -44,12 +49,6 @@ namespace hawk
 			 */
 			AudioListener* copy();
 
-			/**
-			 * Send message to trigger events.
-			 * @param message Message context.
-			 */
-			void sendMessage(const char* message);
-
 			/**
 			 * Release resources.
 			 */
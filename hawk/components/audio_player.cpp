@@ -10,6 +10,10 @@ namespace hawk
 		{
 			// set component type
 			m_type = "AudioPlayer";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update;
 		}
 
 		AudioPlayer::AudioPlayer(const AudioPlayer& other) : Component(other), 
@@ -17,6 +21,10 @@ namespace hawk
 		{
 			// set component type
 			m_type = "AudioPlayer";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update;
 		}
 
 		AudioPlayer::AudioPlayer(Assets::Sound* sound, bool play_on_start, bool loop) : sound(sound), 
@@ -24,6 +32,10 @@ namespace hawk
 		{
 			// set component type
 			m_type = "AudioPlayer";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update;
 		}
 
 		AudioPlayer::~AudioPlayer() {}
@@ -41,18 +53,6 @@ namespace hawk
 			return new AudioPlayer(*this);
 		}
 
-		void AudioPlayer::sendMessage(const char* message)
-		{
-			// return if not enable
-			if (!enable) return;
-
-			// events
-			if (std::strcmp(message, "Start") == 0)
-				start();
-			else if (std::strcmp(message, "Update") == 0)
-				update();
-		}
-
 		void AudioPlayer::release()
 		{
 			// free object
@@ -18,6 +18,11 @@ namespace hawk
 		class AudioPlayer : public Component
 		{
 		public:
+			/**
+			 * Component type id.
+			 */
+			static constexpr unsigned int TYPE_ID = 7;
+
 			/**
 			 * Constructor.
 			 */
@@ -53,12 +58,6 @@ namespace hawk
 			 */
 			AudioPlayer* copy();
 
-			/**
-			 * Send message to trigger events.
-			 * @param message Message context.
-			 */
-			void sendMessage(const char* message);
-
 			/**
 			 * Release resources.
 			 */
@@ -9,18 +9,30 @@ namespace hawk
 		{
 			// set component type
 			m_type = "AudioReverbZone";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update;
 		}
 
 		AudioReverbZone::AudioReverbZone(const AudioReverbZone& other) : min_dist(other.min_dist), max_dist(other.max_dist), m_reverb(other.m_reverb)
 		{
 			// set component type
 			m_type = "AudioReverbZone";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update;
 		}
 
 		AudioReverbZone::AudioReverbZone(float min_dist, float max_dist) : min_dist(min_dist), max_dist(max_dist), m_reverb(nullptr)
 		{
 			// set component type
 			m_type = "AudioReverbZone";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update;
 		}
 
 		AudioReverbZone::~AudioReverbZone() {}
@@ -37,18 +49,6 @@ namespace hawk
 			return new AudioReverbZone(*this);
 		}
 
-		void AudioReverbZone::sendMessage(const char* message)
-		{
-			// return if not enable
-			if (!enable) return;
-
-			// events
-			if (std::strcmp(message, "Start") == 0)
-				start();
-			else if (std::strcmp(message, "Update") == 0)
-				update();
-		}
-
 		void AudioReverbZone::release()
 		{
 			// release reverb zone
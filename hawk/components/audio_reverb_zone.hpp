@@ -17,6 +17,11 @@ namespace hawk
 		class AudioReverbZone : public Component
 		{
 		public:
+			/**
+			 * Component type id.
+			 */
+			static constexpr unsigned int TYPE_ID = 8;
+
 			/**
 			 * Constructor.
 			 */
@@ -51,12 +56,6 @@ namespace hawk
 			 */
 			AudioReverbZone* copy();
 
-			/**
-			 * Send message to trigger events.
-			 * @param message Message context.
-			 */
-			void sendMessage(const char* message);
-
 			/**
 			 * Release resources.
 			 */
@@ -11,10 +11,14 @@ namespace hawk
 		Camera::Camera() : onPreRender(nullptr), onPostRender(nullptr), projection(Projection::Perspective), background(0.0f), skybox(nullptr),
 			irradiance(nullptr), radiance(nullptr), fov(45.0f), near_plane(0.1f), far_plane(100.0f), 
 			front(glm::vec3(0.0f, 0.0f, -1.0f)), up(glm::vec3(0.0f, 1.0f, 0.0f)), right(glm::vec3(1.0f, 0.0f, 0.0f)),
-			m_default_framebuffer(nullptr), m_deferred_framebuffer(nullptr), m_screen_framebuffer(nullptr), m_final_framebuffer(nullptr)
+			m_default_framebuffer(nullptr), m_deferred_framebuffer(nullptr), m_screen_framebuffer(nullptr), m_final_framebuffer(nullptr), m_video_slot(-1)
 		{
 			// set component type
 			m_type = "Camera";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update | Phase::Destroy;
 
 			// application
 			System::Core& app = System::Core::getInstance();
@@ -27,19 +31,27 @@ namespace hawk
 			background(other.background), skybox(other.skybox), viewport(other.viewport), materials(other.materials), 
 			fov(other.fov), near_plane(other.near_plane), far_plane(other.far_plane), front(other.front), up(other.up), right(other.right), 
 			m_default_framebuffer(other.m_default_framebuffer), m_deferred_framebuffer(other.m_deferred_framebuffer), m_screen_framebuffer(other.m_screen_framebuffer),
-			m_final_framebuffer(other.m_final_framebuffer)
+			m_final_framebuffer(other.m_final_framebuffer), m_video_slot(-1)
 		{
 			// set component type
 			m_type = "Camera";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update | Phase::Destroy;
 		}
 
 		Camera::Camera(Camera::Projection projection, const glm::vec4& background, const glm::ivec4& viewport) : onPreRender(nullptr), onPostRender(nullptr),
 			projection(projection), background(background), skybox(nullptr), viewport(viewport), fov(45.0f), near_plane(0.1f), far_plane(100.0f),
 			front(glm::vec3(0.0f, 0.0f, -1.0f)), up(glm::vec3(0.0f, 1.0f, 0.0f)), right(glm::vec3(1.0f, 0.0f, 0.0f)), 
-			m_default_framebuffer(nullptr), m_deferred_framebuffer(nullptr), m_screen_framebuffer(nullptr), m_final_framebuffer(nullptr)
+			m_default_framebuffer(nullptr), m_deferred_framebuffer(nullptr), m_screen_framebuffer(nullptr), m_final_framebuffer(nullptr), m_video_slot(-1)
 		{
 			// set component type
 			m_type = "Camera";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update | Phase::Destroy;
 		}
 
 		Camera::~Camera() 
@@ -80,24 +92,6 @@ namespace hawk
 			return new Camera(*this);
 		}
 
-		void Camera::sendMessage(const char* message)
-		{
-			// return if not enable
-			if (!enable) return;
-
-			// events
-			if (std::strcmp(message, "Start") == 0)
-				start();
-			else if (std::strcmp(message, "Update") == 0)
-				update();
-			else if (std::strcmp(message, "PreRender") == 0)
-				preRender();
-			else if (std::strcmp(message, "PostRender") == 0)
-				postRender();
-			else if (std::strcmp(message, "Destroy") == 0)
-				destroy();
-		}
-
 		void Camera::release()
 		{
 			// free default frame buffer
@@ -255,17 +249,27 @@ namespace hawk
 					break;
 			}
 
-			// raise pre-render event
-			if (onPreRender) (*onPreRender)(this);
+			// raise pre-render event, it may bind anything
+			if (onPreRender)
+			{
+				(*onPreRender)(this);
+
+				app.video.resetBindings();
+			}
 		}
 
 		void Camera::postRender()
 		{
 			// unbind frame buffer
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			System::Core::getInstance().video.bindFramebuffer(0);
 
-			// raise post-render event
-			if (onPostRender) (*onPostRender)(this);
+			// raise post-render event, it may bind anything
+			if (onPostRender)
+			{
+				(*onPostRender)(this);
+
+				System::Core::getInstance().video.resetBindings();
+			}
 		}
 
 		void Camera::destroy()
@@ -365,24 +369,14 @@ namespace hawk
 
 		void Camera::addToVideoCameras()
 		{
-			// application
-			System::Core& app = System::Core::getInstance();
-
 			// add to cameras list
-			app.video.cameras.push_back(this);
+			System::Core::getInstance().video.addCamera(this);
 		}
 
 		void Camera::removeFromVideoCameras()
 		{
-			// application
-			System::Core& app = System::Core::getInstance();
-
-			// camera iterator
-			auto iterator = std::find(app.video.cameras.begin(), app.video.cameras.end(), this);
-
 			// remove from cameras list
-			if (iterator != app.video.cameras.end())
-				app.video.cameras.erase(iterator);
+			System::Core::getInstance().video.removeCamera(this);
 		}
 	}
 }
\ No newline at end of file
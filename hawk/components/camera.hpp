@@ -18,7 +18,17 @@ namespace hawk
 		 */
 		class Camera : public Component
 		{
+			/**
+			 * Video friend class.
+			 */
+			friend class hawk::Managers::Video;
+
 		public:
+			/**
+			 * Component type id.
+			 */
+			static constexpr unsigned int TYPE_ID = 2;
+
 			/**
 			 * Projection enum.
 			 */
@@ -63,12 +73,6 @@ namespace hawk
 			 */
 			Camera* copy();
 
-			/**
-			 * Send message to trigger events.
-			 * @param message Message context.
-			 */
-			void sendMessage(const char* message);
-
 			/**
 			 * Release resources.
 			 */
@@ -255,6 +259,11 @@ namespace hawk
 			 * Final frame buffer to apply gamma correction and hdr in post-process.
 			 */
 			Assets::Framebuffer* m_final_framebuffer;
+
+			/**
+			 * Slot index in video cameras list, -1 if not listed.
+			 */
+			int m_video_slot;
 		};
 	}
 }
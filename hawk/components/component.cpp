@@ -1,24 +1,67 @@
 #include "../system/core.hpp"
 #include "component.hpp"
+#include "audio_listener.hpp"
+#include "audio_player.hpp"
+#include "audio_reverb_zone.hpp"
+#include "camera.hpp"
+#include "light.hpp"
+#include "mesh_renderer.hpp"
+#include "renderer.hpp"
+#include "transform.hpp"
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
 
 namespace hawk
 {
 	namespace Components
 	{
-		Component::Component() : enable(true), m_type("Component"), m_id(0), entity(nullptr) {}
+		/**
+		 * Type ids lock, components may be added on worker threads.
+		 */
+		static std::mutex type_ids_mutex;
 
-		Component::Component(const Component& other) : enable(other.enable), m_type(other.m_type), m_id(other.m_id), 
-			m_name(other.m_name), entity(other.entity) {}
+		/**
+		 * Type ids by class, built-in classes are listed with their fixed ids.
+		 */
+		static std::unordered_map<std::type_index, unsigned int> type_ids =
+		{
+			{ typeid(Component), Component::TYPE_ID },
+			{ typeid(Transform), Transform::TYPE_ID },
+			{ typeid(Camera), Camera::TYPE_ID },
+			{ typeid(Light), Light::TYPE_ID },
+			{ typeid(Renderer), Renderer::TYPE_ID },
+			{ typeid(MeshRenderer), MeshRenderer::TYPE_ID },
+			{ typeid(AudioListener), AudioListener::TYPE_ID },
+			{ typeid(AudioPlayer), AudioPlayer::TYPE_ID },
+			{ typeid(AudioReverbZone), AudioReverbZone::TYPE_ID }
+		};
+
+		/**
+		 * Next type id for classes without a fixed id.
+		 */
+		static unsigned int next_type_id = Component::USER_TYPE_ID;
 
-		Component::~Component() {}
+		Component::Component() : enable(true), entity(nullptr), m_type("Component"), m_type_id(TYPE_ID), m_id(0), m_phases(Phase::None), m_registry_bucket(-1) {}
+
+		Component::Component(const Component& other) : enable(other.enable), entity(other.entity), m_type(other.m_type), m_type_id(other.m_type_id), 
+			m_id(other.m_id), m_name(other.m_name), m_phases(other.m_phases), m_registry_bucket(-1) {}
+
+		Component::~Component()
+		{
+			// remove from scene registries
+			if (m_registry_bucket >= 0) System::Core::getInstance().scene.removeComponent(this);
+		}
 
 		void Component::operator=(const Component& other)
 		{
 			enable = other.enable;
 			m_type = other.m_type;
+			m_type_id = other.m_type_id;
 			m_id = other.m_id;
 			m_name = other.m_name;
 			entity = other.entity;
+			m_phases = other.m_phases;
 		}
 
 		Component* Component::copy()
@@ -30,6 +73,37 @@ namespace hawk
 		{
 			// return if not enable
 			if (!enable) return;
+
+			// events
+			if (std::strcmp(message, "Start") == 0)
+				start();
+			else if (std::strcmp(message, "FixedUpdate") == 0)
+				fixedUpdate();
+			else if (std::strcmp(message, "Update") == 0)
+				update();
+			else if (std::strcmp(message, "LateUpdate") == 0)
+				lateUpdate();
+			else if (std::strcmp(message, "Render") == 0)
+				render();
+			else if (std::strcmp(message, "Destroy") == 0)
+				destroy();
+		}
+
+		void Component::start() {}
+
+		void Component::fixedUpdate() {}
+
+		void Component::update() {}
+
+		void Component::lateUpdate() {}
+
+		void Component::render() {}
+
+		void Component::destroy() {}
+
+		bool Component::hasPhase(Phase phase) const
+		{
+			return (static_cast<unsigned int>(m_phases) & static_cast<unsigned int>(phase)) != 0;
 		}
 
 		const char* Component::getType() const
@@ -37,11 +111,28 @@ namespace hawk
 			return m_type;
 		}
 
+		unsigned int Component::getTypeId() const
+		{
+			return m_type_id;
+		}
+
 		unsigned int Component::getId() const
 		{
 			return m_id;
 		}
 
+		unsigned int Component::typeId(const std::type_info& type)
+		{
+			std::lock_guard<std::mutex> lock(type_ids_mutex);
+
+			// number class on first use
+			auto it = type_ids.find(type);
+
+			if (it == type_ids.end()) it = type_ids.insert(std::make_pair(std::type_index(type), next_type_id++)).first;
+
+			return it->second;
+		}
+
 		const std::string& Component::getName() const
 		{
 			return m_name;
@@ -3,6 +3,7 @@
 
 // stl
 #include <string>
+#include <typeinfo>
 
 namespace hawk
 {
@@ -14,6 +15,19 @@ namespace hawk
 		class Entity;
 	}
 
+	namespace Managers
+	{
+		/**
+		 * Scene forward declaration.
+		 */
+		class Scene;
+
+		/**
+		 * Video forward declaration.
+		 */
+		class Video;
+	}
+
 	namespace Components
 	{
 		/**
@@ -26,7 +40,36 @@ namespace hawk
 			 */
 			friend class hawk::Objects::Entity;
 
+			/**
+			 * Scene friend class.
+			 */
+			friend class hawk::Managers::Scene;
+
 		public:
+			/**
+			 * Component type id. Built-in components declare fixed ids below USER_TYPE_ID, other classes are numbered by typeId.
+			 */
+			static constexpr unsigned int TYPE_ID = 0;
+
+			/**
+			 * First type id handed out to classes without a fixed id.
+			 */
+			static constexpr unsigned int USER_TYPE_ID = 16;
+
+			/**
+			 * Lifecycle phases enum.
+			 */
+			enum class Phase : unsigned int
+			{
+				None = 0,
+				Start = 1 << 0,
+				FixedUpdate = 1 << 1,
+				Update = 1 << 2,
+				LateUpdate = 1 << 3,
+				Render = 1 << 4,
+				Destroy = 1 << 5
+			};
+
 			/**
 			 * Constructor.
 			 */
@@ -60,16 +103,70 @@ namespace hawk
 			 */
 			virtual void sendMessage(const char* message);
 
+			/**
+			 * Start event.
+			 */
+			virtual void start();
+
+			/**
+			 * Fixed update event.
+			 */
+			virtual void fixedUpdate();
+
+			/**
+			 * Update event.
+			 */
+			virtual void update();
+
+			/**
+			 * Late update event.
+			 */
+			virtual void lateUpdate();
+
+			/**
+			 * Render event.
+			 */
+			virtual void render();
+
+			/**
+			 * Destroy event.
+			 */
+			virtual void destroy();
+
+			/**
+			 * Does component implement a lifecycle phase?
+			 * @param phase Lifecycle phase.
+			 */
+			bool hasPhase(Phase phase) const;
+
 			/**
 			 * Underlying type.
 			 */
 			const char* getType() const;
 
+			/**
+			 * Underlying type id.
+			 */
+			unsigned int getTypeId() const;
+
 			/**
 			 * Component id.
 			 */
 			unsigned int getId() const;
 
+			/**
+			 * Type id of a component class. Built-in classes keep their fixed id, others are numbered on first use, derived classes never share an id with their base.
+			 */
+			template<typename T>
+			static unsigned int typeId();
+
+			/**
+			 * Type id of a component class.
+			 * @param type Exact class of component.
+			 * @return Fixed id of built-in classes or an id numbered on first use.
+			 */
+			static unsigned int typeId(const std::type_info& type);
+
 			/**
 			 * Component name.
 			 */
@@ -91,6 +188,11 @@ namespace hawk
 			 */
 			const char* m_type;
 
+			/**
+			 * Underlying type id.
+			 */
+			unsigned int m_type_id;
+
 			/**
 			 * Component id.
 			 */
@@ -100,7 +202,42 @@ namespace hawk
 			 * Component name.
 			 */
 			std::string m_name;
+
+			/**
+			 * Implemented lifecycle phases.
+			 */
+			Phase m_phases;
+
+		private:
+			/**
+			 * Type bucket index in scene registries, -1 if not registered.
+			 */
+			int m_registry_bucket;
+
+			/**
+			 * Slot indices in scene phase registries.
+			 */
+			unsigned int m_registry_slots[4];
 		};
+
+		template<typename T>
+		unsigned int Component::typeId()
+		{
+			// look up once per class
+			static const unsigned int id = typeId(typeid(T));
+
+			return id;
+		}
+
+		/**
+		 * Combine lifecycle phases.
+		 * @param a First phase.
+		 * @param b Second phase.
+		 */
+		inline Component::Phase operator|(Component::Phase a, Component::Phase b)
+		{
+			return static_cast<Component::Phase>(static_cast<unsigned int>(a) | static_cast<unsigned int>(b));
+		}
 	}
 }
 #endif
\ No newline at end of file
@@ -9,27 +9,39 @@ namespace hawk
 	{
 		Light::Light() : color(1.0f), intensity(1.0f), range(10.0f),
 			cut_off(glm::cos(glm::radians(12.5f))), outer_cut_off(glm::cos(glm::radians(17.5f))), cast_shadows(false),
-			frustum(-10.0f, 10.0f, -10.0f, 10.0f), near_plane(1.0f), far_plane(25.0f), m_light_type(Type::Point), m_shadow_map_frame_buffer(nullptr)
+			frustum(-10.0f, 10.0f, -10.0f, 10.0f), near_plane(1.0f), far_plane(25.0f), m_light_type(Type::Point), m_shadow_map_frame_buffer(nullptr), m_video_slot(-1)
 		{
 			// set component type
 			m_type = "Light";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Destroy;
 		}
 
 		Light::Light(const Light& other) : Component(other), color(other.color), intensity(other.intensity), range(other.range),
 			cut_off(other.cut_off), outer_cut_off(other.outer_cut_off), cast_shadows(other.cast_shadows),
 			frustum(other.frustum), near_plane(other.near_plane), far_plane(other.far_plane),
-			m_light_type(other.m_light_type), m_shadow_map_frame_buffer(other.m_shadow_map_frame_buffer)
+			m_light_type(other.m_light_type), m_shadow_map_frame_buffer(other.m_shadow_map_frame_buffer), m_video_slot(-1)
 		{
 			// set component type
 			m_type = "Light";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Destroy;
 		}
 
 		Light::Light(Light::Type type, const glm::vec4& color, float intensity, float range, bool cast_shadows, float near_plane, float far_plane) : 
 			color(color), intensity(intensity), range(range), cut_off(glm::cos(glm::radians(12.5f))), outer_cut_off(glm::cos(glm::radians(17.5f))), cast_shadows(cast_shadows),
-			frustum(-10.0f, 10.0f, -10.0f, 10.0f), near_plane(near_plane), far_plane(far_plane), m_light_type(type), m_shadow_map_frame_buffer(nullptr)
+			frustum(-10.0f, 10.0f, -10.0f, 10.0f), near_plane(near_plane), far_plane(far_plane), m_light_type(type), m_shadow_map_frame_buffer(nullptr), m_video_slot(-1)
 		{
 			// set component type
 			m_type = "Light";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Destroy;
 		}
 
 		Light::~Light()
@@ -58,18 +70,6 @@ namespace hawk
 			return new Light(*this);
 		}
 
-		void Light::sendMessage(const char* message)
-		{
-			// return if not enable
-			if (!enable) return;
-
-			// events
-			if (std::strcmp(message, "Start") == 0)
-				start();
-			else if (std::strcmp(message, "Destroy") == 0)
-				destroy();
-		}
-
 		void Light::release()
 		{
 			// free shadow map frame buffer
@@ -149,24 +149,14 @@ namespace hawk
 
 		void Light::addToVideoLights()
 		{
-			// application
-			System::Core& app = System::Core::getInstance();
-
 			// add to lights list
-			app.video.lights.push_back(this);
+			System::Core::getInstance().video.addLight(this);
 		}
 
 		void Light::removeFromVideoLights()
 		{
-			// application
-			System::Core& app = System::Core::getInstance();
-
-			// light iterator
-			auto iterator = std::find(app.video.lights.begin(), app.video.lights.end(), this);
-
 			// remove from lights list
-			if (iterator != app.video.lights.end())
-				app.video.lights.erase(iterator);
+			System::Core::getInstance().video.removeLight(this);
 		}
 
 		Light::Type Light::getLightType() const
@@ -20,7 +20,17 @@ namespace hawk
 		 */
 		class Light : public Component
 		{
+			/**
+			 * Video friend class.
+			 */
+			friend class hawk::Managers::Video;
+
 		public:
+			/**
+			 * Component type id.
+			 */
+			static constexpr unsigned int TYPE_ID = 3;
+
 			/**
 			 * Type enum.
 			 */
@@ -70,12 +80,6 @@ namespace hawk
 			 */
 			Light* copy();
 
-			/**
-			 * Send message to trigger events.
-			 * @param message Message context.
-			 */
-			void sendMessage(const char* message);
-
 			/**
 			 * Release resources.
 			 */
@@ -182,6 +186,11 @@ namespace hawk
 			 * Shadow map frame buffer.
 			 */
 			Assets::Framebuffer* m_shadow_map_frame_buffer;
+
+			/**
+			 * Slot index in video lights list, -1 if not listed.
+			 */
+			int m_video_slot;
 		};
 	}
 }
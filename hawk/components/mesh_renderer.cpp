@@ -2,28 +2,69 @@
 #include "mesh_renderer.hpp"
 #include "../objects/entity.hpp"
 #include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <climits>
+#include <cfloat>
+#include <cmath>
 #include <glm/gtc/type_ptr.hpp>
 
 namespace hawk
 {
 	namespace Components
 	{
-		MeshRenderer::MeshRenderer() : onRender(nullptr), m_instance_buffer(0)
+		MeshRenderer::MeshRenderer() : onRender(nullptr), m_instance_buffer(0), m_instance_mapping(nullptr), m_instance_capacity(0), m_instance_region(0), m_parent_version(0), m_instances_moved(false), m_visible_instances(0), m_lod_level(0), m_visible_meshlets(0)
 		{
 			// set component type
 			m_type = "MeshRenderer";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update | Phase::Destroy;
+
+			// reset instance regions
+			for (unsigned int i = 0; i < INSTANCE_REGIONS; ++i)
+			{
+				m_instance_fences[i] = nullptr;
+				m_dirty_first[i] = 0;
+				m_dirty_last[i] = 0;
+			}
 		}
 
-		MeshRenderer::MeshRenderer(const MeshRenderer& other) : Renderer(other), onRender(other.onRender), instances(other.instances), m_instance_buffer(other.m_instance_buffer)
+		MeshRenderer::MeshRenderer(const MeshRenderer& other) : Renderer(other), onRender(other.onRender), instances(other.instances), m_instance_buffer(0), m_instance_mapping(nullptr), m_instance_capacity(0), m_instance_region(0), m_parent_version(0), m_instances_moved(false), m_visible_instances(0), m_lod_level(0), m_visible_meshlets(0)
 		{
 			// set component type
 			m_type = "MeshRenderer";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update | Phase::Destroy;
+
+			// reset instance regions
+			for (unsigned int i = 0; i < INSTANCE_REGIONS; ++i)
+			{
+				m_instance_fences[i] = nullptr;
+				m_dirty_first[i] = 0;
+				m_dirty_last[i] = 0;
+			}
 		}
 
-		MeshRenderer::MeshRenderer(hawk::Assets::Material* material, hawk::Assets::Mesh* mesh, Shadows shadows, unsigned int mode) : onRender(nullptr), m_instance_buffer(0)
+		MeshRenderer::MeshRenderer(hawk::Assets::Material* material, hawk::Assets::Mesh* mesh, Shadows shadows, unsigned int mode) : onRender(nullptr), m_instance_buffer(0), m_instance_mapping(nullptr), m_instance_capacity(0), m_instance_region(0), m_parent_version(0), m_instances_moved(false), m_visible_instances(0), m_lod_level(0), m_visible_meshlets(0)
 		{
 			// set component type
 			m_type = "MeshRenderer";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update | Phase::Destroy;
+
+			// reset instance regions
+			for (unsigned int i = 0; i < INSTANCE_REGIONS; ++i)
+			{
+				m_instance_fences[i] = nullptr;
+				m_dirty_first[i] = 0;
+				m_dirty_last[i] = 0;
+			}
 
 			// set properties
 			this->shadows = shadows;
@@ -49,34 +90,12 @@ namespace hawk
 		{
 			onRender = other.onRender;
 			instances = other.instances;
-			m_instance_buffer = other.m_instance_buffer;
-		}
-
-		void MeshRenderer::sendMessage(const char* message)
-		{
-			// return if not enable
-			if (!enable) return;
-
-			// events
-			if (std::strcmp(message, "Start") == 0)
-				start();
-			else if (std::strcmp(message, "Update") == 0)
-				update();
-			else if (std::strcmp(message, "Render") == 0)
-				render();
-			else if (std::strcmp(message, "Destroy") == 0)
-				destroy();
 		}
 
 		void MeshRenderer::release()
 		{
-			// free models buffer
-			if (m_instance_buffer)
-			{
-				glDeleteBuffers(1, &m_instance_buffer);
-
-				m_instance_buffer = 0;
-			}
+			// free instance buffer
+			releaseInstances();
 
 			// free object
 			delete this;
@@ -87,104 +106,74 @@ namespace hawk
 			// if instancing is required
 			if (instances.size() > 0)
 			{
-				// list of instances model matrices
-				std::vector<glm::mat4> models;
-
-				// world position vector
-				const glm::vec3 world_position = entity->transform->getWorldPosition();
-
-				// world position vector
-				const glm::vec3 world_rotation = entity->transform->getWorldRotation();
-
-				// world position vector
-				const glm::vec3 world_scale = entity->transform->getWorldScale();
+				// calculate all instances and fill instance buffer
+				update();
+			}
 
-				// set matrices
-				for (int i = 0; i < instances.size(); ++i)
-				{
-					// calculate instance vectors
-					instances[i]->calculate(world_position, world_rotation, world_scale);
+			// add mesh renderer to be rendered
+			addToVideoRenderers();
+		}
 
-					// push to the list
-					models.push_back(instances[i]->getModelMatrix());
-				}
+		void MeshRenderer::update()
+		{
+			// return if instancing is not required
+			if (instances.empty()) return;
 
-				// make instances buffer
-				glGenBuffers(1, &m_instance_buffer);
+			// parent matrix and its version, getter brings parent up to date first
+			entity->transform->getModelMatrix();
 
-				// bind mesh vertex array
-				glBindVertexArray(mesh->getVao());
+			unsigned int version = entity->transform->getVersion();
 
-				// bind and fill instances buffer
-				glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
-				glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof glm::mat4, &models[0], GL_DYNAMIC_DRAW);
+			// recalculate all instances if parent moved or instances changed
+			bool all = version != m_parent_version || m_instance_matrices.size() != instances.size();
 
-				// vec4 size
-				std::size_t vec4_size = sizeof glm::vec4;
+			m_instance_matrices.resize(instances.size());
+			m_instance_bounds.resize(instances.size());
 
-				// set model matrix first row and change once per instance
-				glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof glm::mat4, (void*)0);
-				glEnableVertexAttribArray(5);
-				glVertexAttribDivisor(5, 1);
+			// changed range
+			unsigned int first = static_cast<unsigned int>(instances.size());
+			unsigned int last = 0;
 
-				// set model matrix second row and change once per instance
-				glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof glm::mat4, (void*)(1 * vec4_size));
-				glEnableVertexAttribArray(6);
-				glVertexAttribDivisor(6, 1);
+			for (unsigned int i = 0; i < instances.size(); ++i)
+			{
+				// continue if instance has not changed
+				if (!all && !instances[i]->isDirty()) continue;
 
-				// set model matrix third row and change once per instance
-				glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof glm::mat4, (void*)(2 * vec4_size));
-				glEnableVertexAttribArray(7);
-				glVertexAttribDivisor(7, 1);
+				// calculate instance matrices against entity transform
+				instances[i]->calculate(entity->transform);
 
-				// set model matrix fourth row and change once per instance
-				glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, sizeof glm::mat4, (void*)(3 * vec4_size));
-				glEnableVertexAttribArray(8);
-				glVertexAttribDivisor(8, 1);
+				m_instance_matrices[i] = instances[i]->getModelMatrix();
 
-				// unbind vertex array
-				glBindVertexArray(0);
+				if (mesh) m_instance_bounds[i] = Helpers::Bounds::transform(mesh->getBounds(), m_instance_matrices[i]);
 
-				// unbind instance buffer
-				glBindBuffer(GL_ARRAY_BUFFER, 0);
+				first = std::min(first, i);
+				last = i + 1;
 			}
 
-			// add mesh renderer to be rendered
-			addToVideoRenderers();
-		}
-
-		void MeshRenderer::update()
-		{
-			// if instancing is required
-			if (instances.size() > 0)
-			{
-				// list of instances model matrices
-				std::vector<glm::mat4> models;
-
-				// world position vector
-				const glm::vec3 world_position = entity->transform->getWorldPosition();
-
-				// world position vector
-				const glm::vec3 world_rotation = entity->transform->getWorldRotation();
+			m_parent_version = version;
 
-				// world position vector
-				const glm::vec3 world_scale = entity->transform->getWorldScale();
+			// return if nothing changed
+			if (first >= last) return;
 
-				// set matrices
-				for (int i = 0; i < instances.size(); ++i)
+			// every region misses this range
+			for (unsigned int i = 0; i < INSTANCE_REGIONS; ++i)
+			{
+				if (m_dirty_first[i] < m_dirty_last[i])
 				{
-					// calculate instance vectors
-					instances[i]->calculate(world_position, world_rotation, world_scale);
-
-					// push to the list
-					models.push_back(instances[i]->getModelMatrix());
+					m_dirty_first[i] = std::min(m_dirty_first[i], first);
+					m_dirty_last[i] = std::max(m_dirty_last[i], last);
+				}
+				else
+				{
+					m_dirty_first[i] = first;
+					m_dirty_last[i] = last;
 				}
-
-				// fill instances buffer
-				glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
-				glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof glm::mat4, &models[0], GL_DYNAMIC_DRAW);
-				glBindBuffer(GL_ARRAY_BUFFER, 0);
 			}
+
+			m_instances_moved = true;
+
+			// write instance buffer on main thread
+			System::Core::getInstance().workers.defer([this]() { uploadInstances(); });
 		}
 
 		void MeshRenderer::render()
@@ -201,8 +190,19 @@ namespace hawk
 			// get model matrices
 			getModelMatrices(model, normal);
 
+			// cull instances against render camera
+			if (!instances.empty()) cullInstances();
+
+			// mesh of camera detail level
+			m_lod_level = selectLod(app.video.getRenderCamera());
+
+			Assets::Mesh* lod_mesh = mesh ? mesh->getLod(m_lod_level) : mesh;
+
+			// cull meshlets of single draws against render camera
+			bool clustered = instances.empty() && lod_mesh && cullMeshlets(lod_mesh, model);
+
 			// set fill mode
-			glPolygonMode(GL_FRONT_AND_BACK, mode);
+			app.video.setPolygonMode(mode);
 
 			// render
 			for (auto material : materials)
@@ -214,8 +214,8 @@ namespace hawk
 				// set renderer properties
 				material->setInt("renderer.shadows", (int)shadows);
 
-				// use material
-				material->use();
+				// use material and its samplers unless last queued draw bound them
+				app.video.bindMaterial(material);
 
 				// set material render states
 				material->setStates();
@@ -223,18 +223,22 @@ namespace hawk
 				// set shader uniform values
 				material->setUniforms();
 
-				// set shader sampler values
-				material->setSamplers();
-
-				// draw mesh
-				app.video.draw(mesh, (int)instances.size());
+				// draw visible instances, visible meshlets or whole mesh
+				if (!instances.empty())
+					app.video.drawInstances(lod_mesh, m_instance_buffer, m_instance_runs);
+				else if (clustered)
+					app.video.drawRanges(lod_mesh, m_meshlet_ranges);
+				else
+					app.video.draw(lod_mesh);
 			}
 
-			// raise render event
-			if (onRender) (*onRender)(this);
+			// raise render event, it may bind anything
+			if (onRender)
+			{
+				(*onRender)(this);
 
-			// reset render states
-			app.video.reset();
+				app.video.resetBindings();
+			}
 		}
 
 		void MeshRenderer::render(Assets::Material* material, Assets::Mesh* mesh)
@@ -271,13 +275,17 @@ namespace hawk
 			material->setSamplers();
 
 			// set fill mode
-			glPolygonMode(GL_FRONT_AND_BACK, mode);
+			app.video.setPolygonMode(mode);
 
-			// draw mesh
-			app.video.draw(mesh, (int)instances.size());
+			// draw mesh or all instances
+			if (instances.empty())
+				app.video.draw(mesh);
+			else
+			{
+				allInstances();
 
-			// reset render states
-			app.video.reset();
+				app.video.drawInstances(mesh, m_instance_buffer, m_instance_runs);
+			}
 		}
 
 		void MeshRenderer::render(Assets::Material* material, const Light* light)
@@ -323,23 +331,350 @@ namespace hawk
 				material->setFloat("light_far_plane", light->far_plane);
 			}
 
-			// set shader program
-			material->use();
+			// set shader program unless last caster used it
+			app.video.useProgram(material->getShader()->getProgram());
 
 			// set shader uniforms
 			material->setUniforms();
 
+			// coarser level than finest camera level
+			unsigned int level = UINT_MAX;
+
+			for (auto& item : m_lod_levels)
+				level = std::min(level, item.second);
+
+			if (level == UINT_MAX) level = 0;
+
+			Assets::Mesh* lod_mesh = mesh ? mesh->getLod(level + app.video.shadow_lod_bias) : mesh;
+
 			// set fill mode
-			glPolygonMode(GL_FRONT_AND_BACK, mode);
+			app.video.setPolygonMode(mode);
 
-			// draw mesh
-			app.video.draw(mesh, (int)instances.size());
+			// draw mesh or all instances
+			if (instances.empty())
+				app.video.draw(lod_mesh);
+			else
+			{
+				allInstances();
+
+				app.video.drawInstances(lod_mesh, m_instance_buffer, m_instance_runs);
+			}
 		}
 
 		void MeshRenderer::destroy()
 		{
 			// remove mesh renderers from render 
 			removeFromVideoRenderers();
+
+			// stop drawing merged geometry of renderer
+			removeFromStaticBatch();
+		}
+
+		bool MeshRenderer::calculateBounds()
+		{
+			// single draw bounds
+			if (instances.empty()) return Renderer::calculateBounds();
+
+			// return if there is nothing to bound
+			if (!mesh || m_instance_bounds.empty()) return false;
+
+			// return if instances and mesh are unchanged
+			if (!m_instances_moved && m_bounds_mesh == mesh) return false;
+
+			// instance boxes of another mesh are outdated
+			if (m_bounds_mesh != mesh)
+			{
+				for (size_t i = 0; i < m_instance_bounds.size(); ++i)
+					m_instance_bounds[i] = Helpers::Bounds::transform(mesh->getBounds(), m_instance_matrices[i]);
+			}
+
+			// box and sphere around all instances
+			m_world_bounds = Helpers::Bounds::empty();
+
+			for (auto& box : m_instance_bounds)
+				Helpers::Bounds::expand(m_world_bounds, box);
+
+			m_world_sphere = { (m_world_bounds.min + m_world_bounds.max) * 0.5f, glm::length(m_world_bounds.max - m_world_bounds.min) * 0.5f };
+
+			m_bounds_mesh = mesh;
+			m_instances_moved = false;
+
+			return true;
+		}
+
+		unsigned int MeshRenderer::getVisibleInstances() const
+		{
+			return m_visible_instances;
+		}
+
+		unsigned int MeshRenderer::getLodLevel() const
+		{
+			return m_lod_level;
+		}
+
+		unsigned int MeshRenderer::getVisibleMeshlets() const
+		{
+			return m_visible_meshlets;
+		}
+
+		void MeshRenderer::removeLod(const Camera* camera)
+		{
+			m_lod_levels.erase(std::remove_if(m_lod_levels.begin(), m_lod_levels.end(), [camera](const std::pair<const Camera*, unsigned int>& item) { return item.first == camera; }), m_lod_levels.end());
+		}
+
+		void MeshRenderer::uploadInstances()
+		{
+			// return if matrices are not calculated
+			if (m_instance_matrices.empty()) return;
+
+			// instances count
+			unsigned int count = static_cast<unsigned int>(m_instance_matrices.size());
+
+			// grow buffer, every region is written again
+			if (count > m_instance_capacity)
+			{
+				releaseInstances();
+
+				m_instance_capacity = count + count / 2;
+
+				// make immutable buffer mapped for the renderer lifetime
+				glGenBuffers(1, &m_instance_buffer);
+				glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
+				glBufferStorage(GL_ARRAY_BUFFER, INSTANCE_REGIONS * m_instance_capacity * sizeof glm::mat4, nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+
+				m_instance_mapping = static_cast<glm::mat4*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, INSTANCE_REGIONS * m_instance_capacity * sizeof glm::mat4, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
+
+				glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+				for (unsigned int i = 0; i < INSTANCE_REGIONS; ++i)
+				{
+					m_dirty_first[i] = 0;
+					m_dirty_last[i] = count;
+				}
+			}
+
+			// fence draws of current region
+			if (m_instance_fences[m_instance_region]) glDeleteSync(m_instance_fences[m_instance_region]);
+
+			m_instance_fences[m_instance_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+			// move to next region and wait until its draws are done
+			m_instance_region = (m_instance_region + 1) % INSTANCE_REGIONS;
+
+			if (m_instance_fences[m_instance_region])
+			{
+				while (glClientWaitSync(m_instance_fences[m_instance_region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+
+				glDeleteSync(m_instance_fences[m_instance_region]);
+
+				m_instance_fences[m_instance_region] = nullptr;
+			}
+
+			// write ranges this region missed
+			unsigned int first = m_dirty_first[m_instance_region];
+			unsigned int last = std::min(m_dirty_last[m_instance_region], count);
+
+			if (first < last)
+				std::memcpy(m_instance_mapping + m_instance_region * m_instance_capacity + first, &m_instance_matrices[first], (last - first) * sizeof glm::mat4);
+
+			m_dirty_first[m_instance_region] = 0;
+			m_dirty_last[m_instance_region] = 0;
+		}
+
+		void MeshRenderer::releaseInstances()
+		{
+			// free fences
+			for (unsigned int i = 0; i < INSTANCE_REGIONS; ++i)
+			{
+				if (m_instance_fences[i])
+				{
+					glDeleteSync(m_instance_fences[i]);
+
+					m_instance_fences[i] = nullptr;
+				}
+			}
+
+			// free instance buffer, deleting it also unmaps it
+			if (m_instance_buffer)
+			{
+				glDeleteBuffers(1, &m_instance_buffer);
+
+				m_instance_buffer = 0;
+			}
+
+			m_instance_mapping = nullptr;
+			m_instance_capacity = 0;
+			m_instance_region = 0;
+		}
+
+		void MeshRenderer::cullInstances()
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// render camera
+			const Camera* camera = app.video.getRenderCamera();
+
+			// draw all if culling is off
+			if (!camera || !app.video.culling || m_instance_bounds.size() != instances.size())
+			{
+				allInstances();
+
+				return;
+			}
+
+			// camera frustum
+			Helpers::Bounds::Frustum frustum = Helpers::Bounds::frustum(camera->getProjectionMatrix() * camera->getViewMatrix());
+
+			// test instance boxes, large layers in chunks on workers
+			unsigned int count = static_cast<unsigned int>(m_instance_bounds.size());
+
+			m_instance_visible.resize(count);
+
+			for (unsigned int first = 0; first < count; first += INSTANCE_CULL_CHUNK)
+			{
+				unsigned int last = std::min(first + INSTANCE_CULL_CHUNK, count);
+
+				app.workers.push([this, &frustum, first, last]()
+				{
+					for (unsigned int i = first; i < last; ++i)
+						m_instance_visible[i] = Helpers::Bounds::intersects(frustum, m_instance_bounds[i]) ? 1 : 0;
+				});
+			}
+
+			app.workers.wait();
+
+			// merge visible instances into ranges of current region
+			unsigned int base = m_instance_region * m_instance_capacity;
+
+			m_instance_runs.clear();
+			m_visible_instances = 0;
+
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				// continue if instance is hidden
+				if (!m_instance_visible[i]) continue;
+
+				// extend last range or start a new one
+				if (!m_instance_runs.empty() && m_instance_runs.back().x + m_instance_runs.back().y == base + i)
+					m_instance_runs.back().y++;
+				else
+					m_instance_runs.push_back(glm::uvec2(base + i, 1));
+
+				m_visible_instances++;
+			}
+		}
+
+		void MeshRenderer::allInstances()
+		{
+			// one range of current region
+			m_instance_runs.clear();
+			m_instance_runs.push_back(glm::uvec2(m_instance_region * m_instance_capacity, static_cast<unsigned int>(m_instance_matrices.size())));
+
+			m_visible_instances = static_cast<unsigned int>(m_instance_matrices.size());
+		}
+
+		unsigned int MeshRenderer::selectLod(const Camera* camera)
+		{
+			// return full detail if there is nothing to select
+			if (!camera || !mesh || mesh->lods.empty() || !hasBounds()) return 0;
+
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// level of last frame
+			auto item = std::find_if(m_lod_levels.begin(), m_lod_levels.end(), [camera](const std::pair<const Camera*, unsigned int>& item) { return item.first == camera; });
+
+			if (item == m_lod_levels.end())
+			{
+				m_lod_levels.push_back(std::make_pair(camera, 0u));
+
+				item = m_lod_levels.end() - 1;
+			}
+
+			// projected height of world sphere over screen height, orthographic projections ignore distance
+			glm::mat4 projection = camera->getProjectionMatrix();
+
+			float size = m_world_sphere.radius * projection[1][1];
+
+			if (projection[3][3] != 1.0f)
+			{
+				float distance = glm::length(m_world_sphere.center - camera->entity->transform->getWorldPosition());
+
+				size = (distance > m_world_sphere.radius) ? size / distance : FLT_MAX;
+			}
+
+			size *= app.video.lod_bias;
+
+			// level thresholds
+			unsigned int count = static_cast<unsigned int>(mesh->lods.size());
+			unsigned int level = std::min(item->second, count);
+
+			auto threshold = [](unsigned int index) { return LOD_SCREEN_SIZE * std::pow(0.5f, static_cast<float>(index - 1)); };
+
+			// go coarser past next threshold or finer past current one
+			while (level < count && size < threshold(level + 1) * (1.0f - LOD_HYSTERESIS)) level++;
+
+			while (level > 0 && size > threshold(level) * (1.0f + LOD_HYSTERESIS)) level--;
+
+			item->second = level;
+
+			return level;
+		}
+
+		bool MeshRenderer::cullMeshlets(const Assets::Mesh* mesh, const glm::mat4& model)
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// render camera
+			const Camera* camera = app.video.getRenderCamera();
+
+			// return if mesh is drawn whole
+			if (mesh->meshlets.empty() || !camera || !app.video.culling) return false;
+
+			// camera frustum and position in mesh space
+			glm::mat4 projection = camera->getProjectionMatrix();
+
+			Helpers::Bounds::Frustum frustum = Helpers::Bounds::frustum(projection * camera->getViewMatrix() * model);
+
+			glm::vec3 camera_position = glm::vec3(glm::inverse(model) * glm::vec4(camera->entity->transform->getWorldPosition(), 1.0f));
+
+			// cone test needs a perspective camera, uniform scale and back faces culled by every material
+			float scale_x = glm::length(glm::vec3(model[0])), scale_y = glm::length(glm::vec3(model[1])), scale_z = glm::length(glm::vec3(model[2]));
+
+			bool cones = projection[3][3] != 1.0f && std::fabs(scale_x - scale_y) <= 0.01f * scale_x && std::fabs(scale_x - scale_z) <= 0.01f * scale_x;
+
+			for (auto material : materials)
+				if (!material->face_cull || material->face_side != GL_BACK || material->face_orientation != GL_CCW) cones = false;
+
+			// merge visible meshlets into element ranges
+			m_meshlet_ranges.clear();
+			m_visible_meshlets = 0;
+
+			for (auto& meshlet : mesh->meshlets)
+			{
+				// continue if meshlet is outside frustum
+				if (!Helpers::Bounds::intersects(frustum, meshlet.sphere)) continue;
+
+				// continue if every triangle faces away from camera
+				if (cones)
+				{
+					glm::vec3 offset = meshlet.sphere.center - camera_position;
+
+					if (glm::dot(offset, meshlet.cone_axis) >= meshlet.cone_cutoff * glm::length(offset) + meshlet.sphere.radius) continue;
+				}
+
+				// extend last range or start a new one
+				if (!m_meshlet_ranges.empty() && m_meshlet_ranges.back().x + m_meshlet_ranges.back().y == meshlet.first)
+					m_meshlet_ranges.back().y += meshlet.count;
+				else
+					m_meshlet_ranges.push_back(glm::uvec2(meshlet.first, meshlet.count));
+
+				m_visible_meshlets++;
+			}
+
+			return true;
 		}
 
 		void MeshRenderer::getModelMatrices(glm::mat4& model, glm::mat4& normal)
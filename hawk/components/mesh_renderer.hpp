@@ -15,12 +15,42 @@ namespace hawk
 {
 	namespace Components
 	{
+		/**
+		 * Camera forward declaration.
+		 */
+		class Camera;
+
 		/**
 		 * Mesh renderer component.
 		 */
 		class MeshRenderer : public Renderer
 		{
 		public:
+			/**
+			 * Component type id.
+			 */
+			static constexpr unsigned int TYPE_ID = 5;
+
+			/**
+			 * Instance buffer regions, graphics device reads one while another is written.
+			 */
+			static constexpr unsigned int INSTANCE_REGIONS = 3;
+
+			/**
+			 * Instances tested per worker task.
+			 */
+			static constexpr unsigned int INSTANCE_CULL_CHUNK = 1024;
+
+			/**
+			 * Projected height over screen height below which first simplified mesh is drawn, halves per detail level.
+			 */
+			static constexpr float LOD_SCREEN_SIZE = 0.5f;
+
+			/**
+			 * Fraction of a level threshold projected size must cross to change level, avoids popping at thresholds.
+			 */
+			static constexpr float LOD_HYSTERESIS = 0.1f;
+
 			/**
 			 * Constructor.
 			 */
@@ -56,12 +86,6 @@ namespace hawk
 			 */
 			MeshRenderer* copy();
 
-			/**
-			 * Send message to trigger events.
-			 * @param message Message context.
-			 */
-			void sendMessage(const char* message);
-
 			/**
 			 * Release resources.
 			 */
@@ -83,7 +107,7 @@ namespace hawk
 			void render();
 
 			/**
-			 * Render with provided material and mesh.
+			 * Render with provided material and mesh, states are left set until queue ends tracking bindings.
 			 * @param material Material to draw.
 			 * @param mesh Mesh to draw.
 			 */
@@ -101,6 +125,12 @@ namespace hawk
 			 */
 			void destroy();
 
+			/**
+			 * Update world bounds, instanced renderers bound all instances.
+			 * @return True if bounds changed.
+			 */
+			bool calculateBounds();
+
 			/**
 			 * Render callback type.
 			 */
@@ -116,6 +146,27 @@ namespace hawk
 			 */
 			std::vector<Transform*> instances;
 
+			/**
+			 * Instances drawn by last render camera.
+			 */
+			unsigned int getVisibleInstances() const;
+
+			/**
+			 * Detail level drawn by last render camera.
+			 */
+			unsigned int getLodLevel() const;
+
+			/**
+			 * Meshlets drawn by last render camera.
+			 */
+			unsigned int getVisibleMeshlets() const;
+
+			/**
+			 * Forget detail level of a camera which stops rendering.
+			 * @param camera Removed camera.
+			 */
+			void removeLod(const Camera* camera);
+
 		private:
 			/**
 			 * Get model matrices from transform.
@@ -125,9 +176,129 @@ namespace hawk
 			void getModelMatrices(glm::mat4& model, glm::mat4& normal);
 
 			/**
-			 * Instancing matrices buffer.
+			 * Write changed instance matrices to next buffer region, must run on main thread.
+			 */
+			void uploadInstances();
+
+			/**
+			 * Free instance buffer and fences.
+			 */
+			void releaseInstances();
+
+			/**
+			 * Fill instance ranges visible to render camera.
+			 */
+			void cullInstances();
+
+			/**
+			 * Fill one range of all instances.
+			 */
+			void allInstances();
+
+			/**
+			 * Select detail level for a camera from projected size of world sphere, moving from level of last frame.
+			 * @param camera Render camera.
+			 * @return Detail level.
+			 */
+			unsigned int selectLod(const Camera* camera);
+
+			/**
+			 * Fill element ranges of meshlets inside render camera frustum and not facing away from it.
+			 * @param mesh Drawn mesh.
+			 * @param model Model matrix.
+			 * @return False if mesh has to be drawn whole.
+			 */
+			bool cullMeshlets(const Assets::Mesh* mesh, const glm::mat4& model);
+
+			/**
+			 * Instancing matrices buffer, persistently mapped and split in regions.
 			 */
 			unsigned int m_instance_buffer;
+
+			/**
+			 * Mapped instance buffer.
+			 */
+			glm::mat4* m_instance_mapping;
+
+			/**
+			 * Instances per buffer region.
+			 */
+			unsigned int m_instance_capacity;
+
+			/**
+			 * Region of last upload.
+			 */
+			unsigned int m_instance_region;
+
+			/**
+			 * Fences of draws reading each region.
+			 */
+			GLsync m_instance_fences[INSTANCE_REGIONS];
+
+			/**
+			 * First changed instance not yet written to each region.
+			 */
+			unsigned int m_dirty_first[INSTANCE_REGIONS];
+
+			/**
+			 * Instance after last changed instance not yet written to each region.
+			 */
+			unsigned int m_dirty_last[INSTANCE_REGIONS];
+
+			/**
+			 * Entity transform version of instance matrices.
+			 */
+			unsigned int m_parent_version;
+
+			/**
+			 * Have instances moved since bounds were calculated?
+			 */
+			bool m_instances_moved;
+
+			/**
+			 * Instancing matrices of last update.
+			 */
+			std::vector<glm::mat4> m_instance_matrices;
+
+			/**
+			 * World boxes of instances.
+			 */
+			std::vector<Helpers::Bounds::Box> m_instance_bounds;
+
+			/**
+			 * Visibility of instances to render camera.
+			 */
+			std::vector<unsigned char> m_instance_visible;
+
+			/**
+			 * Instance ranges to draw, first instance in buffer and count.
+			 */
+			std::vector<glm::uvec2> m_instance_runs;
+
+			/**
+			 * Instances drawn by last render camera.
+			 */
+			unsigned int m_visible_instances;
+
+			/**
+			 * Detail level per camera of last frame.
+			 */
+			std::vector<std::pair<const Camera*, unsigned int>> m_lod_levels;
+
+			/**
+			 * Detail level drawn by last render camera.
+			 */
+			unsigned int m_lod_level;
+
+			/**
+			 * Element ranges of visible meshlets, first element and count.
+			 */
+			std::vector<glm::uvec2> m_meshlet_ranges;
+
+			/**
+			 * Meshlets drawn by last render camera.
+			 */
+			unsigned int m_visible_meshlets;
 		};
 	}
 }
@@ -8,17 +8,25 @@ namespace hawk
 {
 	namespace Components
 	{
-		Renderer::Renderer() : onRender(nullptr), shadows(Shadows::On), cast_shadows(true), mesh(nullptr), mode(GL_FILL)
+		Renderer::Renderer() : onRender(nullptr), shadows(Shadows::On), cast_shadows(true), mesh(nullptr), mode(GL_FILL), occluder(false), m_video_slot(-1), m_tree_item(-1), m_world_matrix(1.0f), m_normal_matrix(1.0f), m_bounds_mesh(nullptr), m_bounds_version(0), m_batch(nullptr)
 		{
 			// set component type
 			m_type = "Renderer";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Destroy;
 		}
 
 		Renderer::Renderer(const Renderer& other) : Component(other), onRender(other.onRender), 
-			shadows(other.shadows), cast_shadows(other.cast_shadows), materials(other.materials), mesh(other.mesh), mode(other.mode)
+			shadows(other.shadows), cast_shadows(other.cast_shadows), materials(other.materials), mesh(other.mesh), mode(other.mode), occluder(other.occluder), m_video_slot(-1), m_tree_item(-1), m_world_matrix(1.0f), m_normal_matrix(1.0f), m_bounds_mesh(nullptr), m_bounds_version(0), m_batch(nullptr)
 		{
 			// set component type
 			m_type = "Renderer";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Destroy;
 		}
 
 		Renderer::~Renderer()
@@ -40,12 +48,7 @@ namespace hawk
 			materials = other.materials;
 			mesh = other.mesh;
 			mode = other.mode;
-		}
-
-		void Renderer::sendMessage(const char* message)
-		{
-			// return if not enable
-			if (!enable) return;
+			occluder = other.occluder;
 		}
 
 		void Renderer::release()
@@ -64,28 +67,87 @@ namespace hawk
 		{
 			// remove mesh renderers from render 
 			removeFromVideoRenderers();
+
+			// stop drawing merged geometry of renderer
+			removeFromStaticBatch();
 		}
 
-		void Renderer::addToVideoRenderers()
+		bool Renderer::calculateBounds()
+		{
+			// return if there is nothing to bound
+			if (!mesh || !entity || !entity->transform) return false;
+
+			// model matrix, read first as it recalculates a dirty transform and bumps its version
+			glm::mat4 model = entity->transform->getModelMatrix();
+
+			// transform version
+			unsigned int version = entity->transform->getVersion();
+
+			// return if bounds are up to date
+			if (m_bounds_mesh == mesh && m_bounds_version == version) return false;
+
+			// transform mesh bounds to world
+			m_world_bounds = Helpers::Bounds::transform(mesh->getBounds(), model);
+			m_world_sphere = Helpers::Bounds::transform(mesh->getSphere(), model);
+			m_world_matrix = model;
+
+			// normal matrix only changes with transform
+			if (m_bounds_version != version || !m_bounds_mesh) m_normal_matrix = glm::transpose(glm::inverse(model));
+
+			m_bounds_mesh = mesh;
+			m_bounds_version = version;
+
+			return true;
+		}
+
+		bool Renderer::hasBounds() const
+		{
+			return m_bounds_mesh != nullptr && m_bounds_mesh == mesh;
+		}
+
+		const Helpers::Bounds::Box& Renderer::getWorldBounds() const
+		{
+			return m_world_bounds;
+		}
+
+		const Helpers::Bounds::Sphere& Renderer::getWorldSphere() const
+		{
+			return m_world_sphere;
+		}
+
+		const glm::mat4& Renderer::getWorldMatrix() const
+		{
+			return m_world_matrix;
+		}
+
+		const glm::mat4& Renderer::getNormalMatrix() const
 		{
-			// application
-			System::Core& app = System::Core::getInstance();
+			return m_normal_matrix;
+		}
 
-			// add to mesh renderers list
-			app.video.renderers.push_back(this);
+		void Renderer::addToVideoRenderers()
+		{
+			// add to renderers list
+			System::Core::getInstance().video.addRenderer(this);
 		}
 
 		void Renderer::removeFromVideoRenderers()
 		{
-			// application
-			System::Core& app = System::Core::getInstance();
+			// remove from renderers list
+			System::Core::getInstance().video.removeRenderer(this);
+		}
+
+		void Renderer::removeFromStaticBatch()
+		{
+			// return if not merged
+			Objects::Entity* root = Objects::StaticBatcher::getRoot(this);
+
+			if (!root) return;
 
-			// mesh renderer iterator
-			auto iterator = std::find(app.video.renderers.begin(), app.video.renderers.end(), this);
+			// build batch again from remaining sources
+			System::Core::getInstance().scene.addToStaticBatches(root, true);
 
-			// remove from mesh renderers list
-			if (iterator != app.video.renderers.end())
-				app.video.renderers.erase(iterator);
+			m_batch = nullptr;
 		}
 	}
 }
\ No newline at end of file
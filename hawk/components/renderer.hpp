@@ -13,6 +13,14 @@
 
 namespace hawk
 {
+	namespace Objects
+	{
+		/**
+		 * StaticBatcher forward declaration.
+		 */
+		class StaticBatcher;
+	}
+
 	namespace Components
 	{
 		/**
@@ -20,7 +28,22 @@ namespace hawk
 		 */
 		class Renderer : public Component
 		{
+			/**
+			 * Video friend class.
+			 */
+			friend class hawk::Managers::Video;
+
+			/**
+			 * StaticBatcher friend class.
+			 */
+			friend class hawk::Objects::StaticBatcher;
+
 		public:
+			/**
+			 * Component type id.
+			 */
+			static constexpr unsigned int TYPE_ID = 4;
+
 			/**
 			 * Shadow contribution enum.
 			 */
@@ -58,12 +81,6 @@ namespace hawk
 			 */
 			virtual Renderer* copy();
 
-			/**
-			 * Send message to trigger events.
-			 * @param message Message context.
-			 */
-			virtual void sendMessage(const char* message);
-
 			/**
 			 * Release resources.
 			 */
@@ -93,6 +110,37 @@ namespace hawk
 			 */
 			virtual void destroy();
 
+			/**
+			 * Update world bounds if transform or mesh changed.
+			 * @return True if bounds changed.
+			 */
+			virtual bool calculateBounds();
+
+			/**
+			 * Are world bounds calculated?
+			 */
+			bool hasBounds() const;
+
+			/**
+			 * World space bounding box.
+			 */
+			const Helpers::Bounds::Box& getWorldBounds() const;
+
+			/**
+			 * World space bounding sphere.
+			 */
+			const Helpers::Bounds::Sphere& getWorldSphere() const;
+
+			/**
+			 * Model matrix of world bounds.
+			 */
+			const glm::mat4& getWorldMatrix() const;
+
+			/**
+			 * Normal matrix of world bounds.
+			 */
+			const glm::mat4& getNormalMatrix() const;
+
 			/**
 			 * Render callback type.
 			 */
@@ -128,6 +176,11 @@ namespace hawk
 			 */
 			unsigned int mode;
 
+			/**
+			 * Is renderer always used as an occluder for software occlusion culling?
+			 */
+			bool occluder;
+
 		protected:
 			/**
 			 * Add renderer to render.
@@ -138,6 +191,56 @@ namespace hawk
 			 * Remove renderer from render.
 			 */
 			void removeFromVideoRenderers();
+
+			/**
+			 * Leave static batch, its root is merged again without this renderer on end of frame.
+			 */
+			void removeFromStaticBatch();
+
+			/**
+			 * Slot index in video renderers list, -1 if not listed.
+			 */
+			int m_video_slot;
+
+			/**
+			 * Item index in static, dynamic or unbounded list of video spatial index, -1 if not listed.
+			 */
+			int m_tree_item;
+
+			/**
+			 * World space bounding box.
+			 */
+			Helpers::Bounds::Box m_world_bounds;
+
+			/**
+			 * World space bounding sphere.
+			 */
+			Helpers::Bounds::Sphere m_world_sphere;
+
+			/**
+			 * Model matrix of world bounds.
+			 */
+			glm::mat4 m_world_matrix;
+
+			/**
+			 * Normal matrix of world bounds.
+			 */
+			glm::mat4 m_normal_matrix;
+
+			/**
+			 * Mesh of world bounds, nullptr if not calculated.
+			 */
+			const Assets::Mesh* m_bounds_mesh;
+
+			/**
+			 * Transform version of world bounds.
+			 */
+			unsigned int m_bounds_version;
+
+			/**
+			 * Merged renderer drawing this one, nullptr if not batched.
+			 */
+			Renderer* m_batch;
 		};
 	}
 }
@@ -1,42 +1,70 @@
+#include "../system/core.hpp"
 #include "transform.hpp"
 #include "../objects/entity.hpp"
+#include "../objects/transform_store.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace hawk
 {
 	namespace Components
 	{
-		Transform::Transform() : position(0.0f), rotation(0.0f), scale(1.0f), m_world_position(0.0f), m_world_rotation(0.0f), m_world_scale(1.0f) 
+		/**
+		 * Are lazily calculated transforms read only? Workers of a parallel scene update may read any transform.
+		 */
+		static inline bool isFrozen()
+		{
+			return System::Core::getInstance().scene.transforms.isParallel();
+		}
+
+		Transform::Transform() : m_position(0.0f), m_rotation(0.0f), m_scale(1.0f), m_world_position(0.0f), m_world_rotation(0.0f), m_world_scale(1.0f),
+			m_local_matrix(1.0f), m_model_matrix(1.0f), m_dirty(true), m_version(0), m_store(nullptr), m_store_index(0)
 		{
 			// set component type
 			m_type = "Transform";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update;
 		}
 
-		Transform::Transform(const Transform& other) : position(other.position), rotation(other.rotation), scale(other.scale),
-			m_world_position(other.m_world_position), m_world_rotation(other.m_world_rotation), m_world_scale(other.m_world_scale) 
+		Transform::Transform(const Transform& other) : Component(other), m_position(other.getPosition()), m_rotation(other.getRotation()), m_scale(other.getScale()),
+			m_world_position(0.0f), m_world_rotation(0.0f), m_world_scale(1.0f), m_local_matrix(1.0f), m_model_matrix(1.0f), m_dirty(true), m_version(0),
+			m_store(nullptr), m_store_index(0)
 		{
 			// set component type
 			m_type = "Transform";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update;
 		}
 
-		Transform::Transform(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale) : position(position),
-			rotation(rotation), scale(scale), m_world_position(0.0f), m_world_rotation(0.0f), m_world_scale(1.0f)
+		Transform::Transform(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale) : m_position(position),
+			m_rotation(rotation), m_scale(scale), m_world_position(0.0f), m_world_rotation(0.0f), m_world_scale(1.0f),
+			m_local_matrix(1.0f), m_model_matrix(1.0f), m_dirty(true), m_version(0), m_store(nullptr), m_store_index(0)
 		{
 			// set component type
 			m_type = "Transform";
+			m_type_id = TYPE_ID;
+
+			// set component phases
+			m_phases = Phase::Start | Phase::Update;
 		}
 
-		Transform::~Transform() {}
+		Transform::~Transform()
+		{
+			// release store slot
+			if (m_store) m_store->remove(m_store_index);
+		}
 
 		void Transform::operator=(const Transform& other)
 		{
 			enable = other.enable;
-			position = other.position;
-			rotation = other.rotation;
-			scale = other.scale;
-			m_world_position = other.m_world_position;
-			m_world_rotation = other.m_world_rotation;
-			m_world_scale = other.m_world_scale;
+
+			// set local values, recalculates against our own parent
+			setPosition(other.getPosition());
+			setRotation(other.getRotation());
+			setScale(other.getScale());
 		}
 
 		Transform* Transform::copy()
@@ -44,18 +72,6 @@ namespace hawk
 			return new Transform(*this);
 		}
 
-		void Transform::sendMessage(const char* message)
-		{
-			// return if not enable
-			if (!enable) return;
-
-			// events
-			if (std::strcmp(message, "Start") == 0)
-				start();
-			else if (std::strcmp(message, "Update") == 0)
-				update();
-		}
-
 		void Transform::release()
 		{
 			// free object
@@ -64,99 +80,288 @@ namespace hawk
 
 		void Transform::start()
 		{
-			// calculate vectors
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			// return if already stored
+			if (m_store) return;
+
+			// parent transform
+			const Transform* parent = (entity && entity->parent) ? entity->parent->transform : nullptr;
+
+			// move into transform store, parent must be stored first to keep slots ordered
+			if (entity && app.scene.transforms.enable && !app.scene.transforms.isParallel() && (!parent || parent->m_store == &app.scene.transforms))
+			{
+				m_store = &app.scene.transforms;
+				m_store_index = m_store->add(this, parent ? static_cast<int>(parent->m_store_index) : -1, m_position, m_rotation, m_scale);
+
+				return;
+			}
+
+			// calculate matrices
 			calculate();
 		}
 
 		void Transform::update()
 		{
-			// calculate vectors
-			if (!entity->isStatic()) calculate();
+			// stored transforms are calculated by transform store, others after parallel update
+			if (m_store || isFrozen()) return;
+
+			// calculate matrices only if this transform or one of its parents has changed
+			if (m_dirty) calculate();
 		}
 
-		void Transform::calculate(const glm::vec3& world_position, const glm::vec3& world_rotation, const glm::vec3& world_scale)
+		void Transform::calculate(const Transform* parent)
 		{
-			// set model matrix to identity
-			m_model_matrix = glm::mat4(1.0f);
+			// calculate against parent world values
+			if (parent)
+				calculate(parent->getModelMatrix(), parent->getWorldRotation(), parent->getWorldScale());
+			else
+				calculate(glm::mat4(1.0f), glm::vec3(0.0f), glm::vec3(1.0f));
+		}
 
-			// translate
-			m_model_matrix = glm::translate(m_model_matrix, world_position + position);
+		void Transform::markDirty()
+		{
+			// stored transforms propagate through parent slots
+			if (m_store)
+				m_store->markDirty(m_store_index);
+			else
+			{
+				// return if already dirty, child transforms are already dirty as well
+				if (m_dirty) return;
 
-			// rotate
-			m_model_matrix = glm::rotate(m_model_matrix, glm::radians((world_rotation + rotation).x), glm::vec3(1.0f, 0.0f, 0.0f));
-			m_model_matrix = glm::rotate(m_model_matrix, glm::radians((world_rotation + rotation).y), glm::vec3(0.0f, 1.0f, 0.0f));
-			m_model_matrix = glm::rotate(m_model_matrix, glm::radians((world_rotation + rotation).z), glm::vec3(0.0f, 0.0f, 1.0f));
+				// set flag
+				m_dirty = true;
+			}
 
-			// scale
-			m_model_matrix = glm::scale(m_model_matrix, world_scale * scale);
+			// invalidate children outside of store
+			markChildrenDirty();
+		}
+
+		void Transform::markChildrenDirty()
+		{
+			// return if transform is not attached to an entity
+			if (!entity) return;
+
+			// mark child transforms which are not stored
+			for (auto child : entity->entities)
+				if (child.second->transform && !child.second->transform->m_store) child.second->transform->markDirty();
+		}
+
+		void Transform::reparent()
+		{
+			// link to new parent slot
+			if (m_store)
+			{
+				// parent transform
+				const Transform* parent = (entity && entity->parent) ? entity->parent->transform : nullptr;
+
+				if (!parent || parent->m_store == m_store)
+					m_store->reparent(m_store_index, parent ? static_cast<int>(parent->m_store_index) : -1);
+				else
+				{
+					// parent is not stored, take local values back and leave store
+					m_position = m_store->getPosition(m_store_index);
+					m_rotation = m_store->getRotation(m_store_index);
+					m_scale = m_store->getScale(m_store_index);
+
+					m_store->remove(m_store_index);
+					m_store = nullptr;
+
+					m_dirty = false;
+				}
+			}
+
+			// recalculate
+			markDirty();
+		}
+
+		glm::vec3 Transform::getPosition() const
+		{
+			return m_store ? m_store->getPosition(m_store_index) : m_position;
+		}
+
+		glm::vec3 Transform::getRotation() const
+		{
+			return m_store ? m_store->getRotation(m_store_index) : m_rotation;
+		}
+
+		glm::vec3 Transform::getScale() const
+		{
+			return m_store ? m_store->getScale(m_store_index) : m_scale;
+		}
+
+		void Transform::setPosition(const glm::vec3& position)
+		{
+			// set stored value
+			if (m_store)
+			{
+				m_store->setPosition(m_store_index, position);
+
+				// children started in parallel update or moved out of store are not swept with it
+				markChildrenDirty();
+
+				return;
+			}
+
+			// set value
+			m_position = position;
+
+			// invalidate subtree
+			markDirty();
+		}
+
+		void Transform::setRotation(const glm::vec3& rotation)
+		{
+			// set stored value
+			if (m_store)
+			{
+				m_store->setRotation(m_store_index, rotation);
+
+				// children started in parallel update or moved out of store are not swept with it
+				markChildrenDirty();
+
+				return;
+			}
+
+			// set value
+			m_rotation = rotation;
+
+			// invalidate subtree
+			markDirty();
+		}
+
+		void Transform::setScale(const glm::vec3& scale)
+		{
+			// set stored value
+			if (m_store)
+			{
+				m_store->setScale(m_store_index, scale);
+
+				// children started in parallel update or moved out of store are not swept with it
+				markChildrenDirty();
+
+				return;
+			}
+
+			// set value
+			m_scale = scale;
+
+			// invalidate subtree
+			markDirty();
 		}
 
 		glm::vec3 Transform::getWorldPosition() const
 		{
+			// stored value
+			if (m_store) return glm::vec3(m_store->getWorldMatrix(m_store_index)[3]);
+
+			// recalculate if outdated, values of frame start are kept during parallel update
+			if (!isFrozen() && m_dirty && entity) calculate();
+
 			return m_world_position;
 		}
 
 		glm::vec3 Transform::getWorldRotation() const
 		{
+			// stored value
+			if (m_store) return m_store->getWorldRotation(m_store_index);
+
+			// recalculate if outdated, values of frame start are kept during parallel update
+			if (!isFrozen() && m_dirty && entity) calculate();
+
 			return m_world_rotation;
 		}
 
 		glm::vec3 Transform::getWorldScale() const
 		{
+			// stored value
+			if (m_store) return m_store->getWorldScale(m_store_index);
+
+			// recalculate if outdated, values of frame start are kept during parallel update
+			if (!isFrozen() && m_dirty && entity) calculate();
+
 			return m_world_scale;
 		}
 
+		glm::mat4 Transform::getLocalMatrix() const
+		{
+			// stored value
+			if (m_store) return m_store->getLocalMatrix(m_store_index);
+
+			// recalculate if outdated, values of frame start are kept during parallel update
+			if (!isFrozen() && m_dirty && entity) calculate();
+
+			return m_local_matrix;
+		}
+
 		glm::mat4 Transform::getModelMatrix() const
 		{
+			// stored value
+			if (m_store) return m_store->getWorldMatrix(m_store_index);
+
+			// recalculate if outdated, values of frame start are kept during parallel update
+			if (!isFrozen() && m_dirty && entity) calculate();
+
 			return m_model_matrix;
 		}
 
-		void Transform::calculate()
+		bool Transform::isDirty() const
 		{
-			// if entity has no parent
-			if (!entity->parent)
-			{
-				// set world vectors to local vectors
-				m_world_position = position;
-				m_world_rotation = rotation;
-				m_world_scale = scale;
-
-				return;
-			}
+			return m_store ? m_store->isDirty(m_store_index) : m_dirty;
+		}
 
-			// set initial values
-			m_world_position = position;
-			m_world_rotation = rotation;
-			m_world_scale = scale;
+		unsigned int Transform::getVersion() const
+		{
+			return m_store ? m_store->getVersion(m_store_index) : m_version;
+		}
 
-			// entity parent
-			const Objects::Entity* parent_entity = entity->parent;
+		bool Transform::isStored() const
+		{
+			return m_store != nullptr;
+		}
 
-			// traverse entity parents
-			while (parent_entity)
-			{
-				// calculate world vectors
-				m_world_position += parent_entity->transform->position;
-				m_world_rotation += parent_entity->transform->rotation;
-				m_world_scale *= parent_entity->transform->scale;
+		void Transform::calculate() const
+		{
+			// parent transform
+			const Transform* parent = (entity && entity->parent) ? entity->parent->transform : nullptr;
 
-				// get next parent
-				parent_entity = parent_entity->parent;
-			}
+			// calculate against parent, parent getters bring parent up to date first
+			if (parent)
+				calculate(parent->getModelMatrix(), parent->getWorldRotation(), parent->getWorldScale());
+			else
+				calculate(glm::mat4(1.0f), glm::vec3(0.0f), glm::vec3(1.0f));
+		}
 
-			// set model matrix to identity
-			m_model_matrix = glm::mat4(1.0f);
+		void Transform::calculate(const glm::mat4& parent_matrix, const glm::vec3& parent_rotation, const glm::vec3& parent_scale) const
+		{
+			// set local matrix to identity
+			m_local_matrix = glm::mat4(1.0f);
 
 			// translate
-			m_model_matrix = glm::translate(m_model_matrix, m_world_position);
+			m_local_matrix = glm::translate(m_local_matrix, m_position);
 
 			// rotate
-			m_model_matrix = glm::rotate(m_model_matrix, glm::radians(m_world_rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-			m_model_matrix = glm::rotate(m_model_matrix, glm::radians(m_world_rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-			m_model_matrix = glm::rotate(m_model_matrix, glm::radians(m_world_rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+			m_local_matrix = glm::rotate(m_local_matrix, glm::radians(m_rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+			m_local_matrix = glm::rotate(m_local_matrix, glm::radians(m_rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+			m_local_matrix = glm::rotate(m_local_matrix, glm::radians(m_rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
 
 			// scale
-			m_model_matrix = glm::scale(m_model_matrix, m_world_scale);
+			m_local_matrix = glm::scale(m_local_matrix, m_scale);
+
+			// model matrix in world space
+			m_model_matrix = parent_matrix * m_local_matrix;
+
+			// world vectors
+			m_world_position = glm::vec3(m_model_matrix[3]);
+			m_world_rotation = parent_rotation + m_rotation;
+			m_world_scale = parent_scale * m_scale;
+
+			// reset flag
+			m_dirty = false;
+
+			// increase version
+			m_version++;
 		}
 	}
-}
\ No newline at end of file
+}
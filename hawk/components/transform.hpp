@@ -9,14 +9,29 @@
 
 namespace hawk
 {
+	namespace Objects
+	{
+		/**
+		 * Transform store forward declaration.
+		 */
+		class TransformStore;
+	}
+
 	namespace Components
 	{
 		/**
-		 * Transform component.
+		 * Transform component. Acts as a handle into scene transform store when it is stored there.
 		 */
 		class Transform : public Component
 		{
+			friend class Objects::TransformStore;
+
 		public:
+			/**
+			 * Component type id.
+			 */
+			static constexpr unsigned int TYPE_ID = 1;
+
 			/**
 			 * Constructor.
 			 */
@@ -52,12 +67,6 @@ namespace hawk
 			 */
 			Transform* copy();
 
-			/**
-			 * Send message to trigger events.
-			 * @param message Message context.
-			 */
-			void sendMessage(const char* message);
-
 			/**
 			 * Release resources.
 			 */
@@ -74,12 +83,55 @@ namespace hawk
 			void update();
 
 			/**
-			 * Manually calculate vectors.
-			 * @param world_position Manual world position.
-			 * @param world_rotation Manual world rotation.
-			 * @param world_scale Manual world scale.
+			 * Manually calculate matrices against a parent transform. Used for transforms outside of entity hierarchy like instances.
+			 * @param parent Parent transform.
+			 */
+			void calculate(const Transform* parent);
+
+			/**
+			 * Mark world matrix of this transform and its child transforms for recalculation.
+			 */
+			void markDirty();
+
+			/**
+			 * Mark child transforms which are not stored for recalculation, store sweeps only reach stored ones.
+			 */
+			void markChildrenDirty();
+
+			/**
+			 * Recalculate against a new parent entity transform.
+			 */
+			void reparent();
+
+			/**
+			 * Local position.
+			 */
+			glm::vec3 getPosition() const;
+
+			/**
+			 * Local rotation.
+			 */
+			glm::vec3 getRotation() const;
+
+			/**
+			 * Local scale.
+			 */
+			glm::vec3 getScale() const;
+
+			/**
+			 * Set local position.
+			 */
+			void setPosition(const glm::vec3& position);
+
+			/**
+			 * Set local rotation.
 			 */
-			void calculate(const glm::vec3& world_position, const glm::vec3& world_rotation, const glm::vec3& world_scale);
+			void setRotation(const glm::vec3& rotation);
+
+			/**
+			 * Set local scale.
+			 */
+			void setScale(const glm::vec3& scale);
 
 			/**
 			 * Position in world.
@@ -96,51 +148,104 @@ namespace hawk
 			 */
 			glm::vec3 getWorldScale() const;
 
+			/**
+			 * Model matrix in local space.
+			 */
+			glm::mat4 getLocalMatrix() const;
+
 			/**
 			 * Model matrix in world space.
 			 */
 			glm::mat4 getModelMatrix() const;
 
 			/**
-			 * Local position.
+			 * Is world matrix waiting for recalculation?
 			 */
-			glm::vec3 position;
+			bool isDirty() const;
 
 			/**
-			 * Local rotation.
+			 * World matrix version. Increases every time world matrix is recalculated.
 			 */
-			glm::vec3 rotation;
+			unsigned int getVersion() const;
 
 			/**
-			 * Local scale.
+			 * Is transform kept in scene transform store?
 			 */
-			glm::vec3 scale;
+			bool isStored() const;
 
 		private:
 			/**
-			 * Calculate vectors.
+			 * Calculate matrices from parent entity transform.
+			 */
+			void calculate() const;
+
+			/**
+			 * Calculate matrices from parent world values.
+			 * @param parent_matrix Parent world matrix.
+			 * @param parent_rotation Parent world rotation.
+			 * @param parent_scale Parent world scale.
+			 */
+			void calculate(const glm::mat4& parent_matrix, const glm::vec3& parent_rotation, const glm::vec3& parent_scale) const;
+
+			/**
+			 * Local position.
+			 */
+			glm::vec3 m_position;
+
+			/**
+			 * Local rotation.
 			 */
-			void calculate();
+			glm::vec3 m_rotation;
+
+			/**
+			 * Local scale.
+			 */
+			glm::vec3 m_scale;
 
 			/**
 			 * World position.
 			 */
-			glm::vec3 m_world_position;
+			mutable glm::vec3 m_world_position;
 
 			/**
 			 * World rotation.
 			 */
-			glm::vec3 m_world_rotation;
+			mutable glm::vec3 m_world_rotation;
 
 			/**
 			 * World scale.
 			 */
-			glm::vec3 m_world_scale;
+			mutable glm::vec3 m_world_scale;
+
+			/**
+			 * Local matrix.
+			 */
+			mutable glm::mat4 m_local_matrix;
 
 			/**
 			 * Model matrix.
 			 */
-			glm::mat4 m_model_matrix;
+			mutable glm::mat4 m_model_matrix;
+
+			/**
+			 * World matrix needs recalculation.
+			 */
+			mutable bool m_dirty;
+
+			/**
+			 * World matrix version.
+			 */
+			mutable unsigned int m_version;
+
+			/**
+			 * Transform store which keeps this transform.
+			 */
+			Objects::TransformStore* m_store;
+
+			/**
+			 * Slot index in transform store.
+			 */
+			unsigned int m_store_index;
 		};
 	}
 }
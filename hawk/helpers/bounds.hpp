@@ -0,0 +1,283 @@
+#ifndef HAWK_HELPERS_BOUNDS_H
+#define HAWK_HELPERS_BOUNDS_H
+
+// stl
+#include <cmath>
+#include <limits>
+#include <utility>
+
+// glm
+#include <glm/glm.hpp>
+
+namespace hawk
+{
+	namespace Helpers
+	{
+		namespace Bounds
+		{
+			/**
+			 * Axis aligned bounding box.
+			 */
+			struct Box
+			{
+				/**
+				 * Minimum corner.
+				 */
+				glm::vec3 min;
+
+				/**
+				 * Maximum corner.
+				 */
+				glm::vec3 max;
+			};
+
+			/**
+			 * Bounding sphere.
+			 */
+			struct Sphere
+			{
+				/**
+				 * Sphere center.
+				 */
+				glm::vec3 center;
+
+				/**
+				 * Sphere radius.
+				 */
+				float radius;
+			};
+
+			/**
+			 * View frustum planes, left, right, bottom, top, near and far, normals point inside.
+			 */
+			struct Frustum
+			{
+				/**
+				 * Plane normal and distance.
+				 */
+				glm::vec4 planes[6];
+			};
+
+			/**
+			 * Half line from an origin, direction is unit length.
+			 */
+			struct Ray
+			{
+				/**
+				 * Ray origin.
+				 */
+				glm::vec3 origin;
+
+				/**
+				 * Ray direction.
+				 */
+				glm::vec3 direction;
+			};
+
+			/**
+			 * Empty box which any point expands.
+			 */
+			inline Box empty()
+			{
+				return { glm::vec3(std::numeric_limits<float>::max()), glm::vec3(-std::numeric_limits<float>::max()) };
+			}
+
+			/**
+			 * Is box empty?
+			 */
+			inline bool isEmpty(const Box& box)
+			{
+				return box.min.x > box.max.x || box.min.y > box.max.y || box.min.z > box.max.z;
+			}
+
+			/**
+			 * Expand box to contain a point.
+			 */
+			inline void expand(Box& box, const glm::vec3& point)
+			{
+				box.min = glm::min(box.min, point);
+				box.max = glm::max(box.max, point);
+			}
+
+			/**
+			 * Expand box to contain another box.
+			 */
+			inline void expand(Box& box, const Box& other)
+			{
+				box.min = glm::min(box.min, other.min);
+				box.max = glm::max(box.max, other.max);
+			}
+
+			/**
+			 * Box transformed by a matrix, result is the box around transformed corners.
+			 */
+			inline Box transform(const Box& box, const glm::mat4& matrix)
+			{
+				// return if there is nothing to transform
+				if (isEmpty(box)) return box;
+
+				// center and half extents
+				glm::vec3 center = (box.min + box.max) * 0.5f;
+				glm::vec3 extents = (box.max - box.min) * 0.5f;
+
+				// transformed center
+				glm::vec3 world_center = glm::vec3(matrix * glm::vec4(center, 1.0f));
+
+				// transformed extents by absolute rotation and scale
+				glm::vec3 world_extents = glm::vec3(
+					std::fabs(matrix[0][0]) * extents.x + std::fabs(matrix[1][0]) * extents.y + std::fabs(matrix[2][0]) * extents.z,
+					std::fabs(matrix[0][1]) * extents.x + std::fabs(matrix[1][1]) * extents.y + std::fabs(matrix[2][1]) * extents.z,
+					std::fabs(matrix[0][2]) * extents.x + std::fabs(matrix[1][2]) * extents.y + std::fabs(matrix[2][2]) * extents.z);
+
+				return { world_center - world_extents, world_center + world_extents };
+			}
+
+			/**
+			 * Sphere transformed by a matrix, radius is scaled by largest axis scale.
+			 */
+			inline Sphere transform(const Sphere& sphere, const glm::mat4& matrix)
+			{
+				// largest axis scale
+				float scale = std::fmax(glm::length(glm::vec3(matrix[0])), std::fmax(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+
+				return { glm::vec3(matrix * glm::vec4(sphere.center, 1.0f)), sphere.radius * scale };
+			}
+
+			/**
+			 * Frustum planes of a view projection matrix.
+			 */
+			inline Frustum frustum(const glm::mat4& view_projection)
+			{
+				// matrix rows
+				glm::vec4 x = glm::vec4(view_projection[0][0], view_projection[1][0], view_projection[2][0], view_projection[3][0]);
+				glm::vec4 y = glm::vec4(view_projection[0][1], view_projection[1][1], view_projection[2][1], view_projection[3][1]);
+				glm::vec4 z = glm::vec4(view_projection[0][2], view_projection[1][2], view_projection[2][2], view_projection[3][2]);
+				glm::vec4 w = glm::vec4(view_projection[0][3], view_projection[1][3], view_projection[2][3], view_projection[3][3]);
+
+				Frustum result = { { w + x, w - x, w + y, w - y, w + z, w - z } };
+
+				// normalize planes
+				for (int i = 0; i < 6; ++i)
+					result.planes[i] = result.planes[i] * (1.0f / glm::length(glm::vec3(result.planes[i])));
+
+				return result;
+			}
+
+			/**
+			 * Is box inside or intersecting frustum?
+			 */
+			inline bool intersects(const Frustum& frustum, const Box& box)
+			{
+				for (int i = 0; i < 6; ++i)
+				{
+					const glm::vec4& plane = frustum.planes[i];
+
+					// corner furthest along plane normal
+					glm::vec3 corner = glm::vec3(plane.x >= 0.0f ? box.max.x : box.min.x, plane.y >= 0.0f ? box.max.y : box.min.y, plane.z >= 0.0f ? box.max.z : box.min.z);
+
+					// return if whole box is behind plane
+					if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) return false;
+				}
+
+				return true;
+			}
+
+			/**
+			 * Do boxes overlap?
+			 */
+			inline bool intersects(const Box& a, const Box& b)
+			{
+				return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y && a.min.z <= b.max.z && a.max.z >= b.min.z;
+			}
+
+			/**
+			 * Does sphere overlap box?
+			 */
+			inline bool intersects(const Sphere& sphere, const Box& box)
+			{
+				// closest box point to sphere center
+				glm::vec3 closest = glm::clamp(sphere.center, box.min, box.max);
+				glm::vec3 delta = closest - sphere.center;
+
+				return glm::dot(delta, delta) <= sphere.radius * sphere.radius;
+			}
+
+			/**
+			 * Is sphere inside or intersecting frustum?
+			 */
+			inline bool intersects(const Frustum& frustum, const Sphere& sphere)
+			{
+				for (int i = 0; i < 6; ++i)
+				{
+					// return if whole sphere is behind plane
+					if (glm::dot(glm::vec3(frustum.planes[i]), sphere.center) + frustum.planes[i].w < -sphere.radius) return false;
+				}
+
+				return true;
+			}
+
+			/**
+			 * Distance along a ray where it enters a box, zero if origin is inside, negative if ray misses within a length.
+			 */
+			inline float intersects(const Ray& ray, const Box& box, float length)
+			{
+				float near_distance = 0.0f, far_distance = length;
+
+				for (int i = 0; i < 3; ++i)
+				{
+					// slab of this axis
+					float inverse = 1.0f / ray.direction[i];
+					float t0 = (box.min[i] - ray.origin[i]) * inverse;
+					float t1 = (box.max[i] - ray.origin[i]) * inverse;
+
+					if (t0 > t1) std::swap(t0, t1);
+
+					near_distance = std::fmax(near_distance, t0);
+					far_distance = std::fmin(far_distance, t1);
+
+					// return if slabs do not overlap
+					if (!(near_distance <= far_distance)) return -1.0f;
+				}
+
+				return near_distance;
+			}
+
+			/**
+			 * Distance along a ray where it hits a triangle from either side, negative if ray misses within a length.
+			 */
+			inline float intersects(const Ray& ray, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, float length)
+			{
+				glm::vec3 edge1 = b - a;
+				glm::vec3 edge2 = c - a;
+
+				// return if ray is parallel to triangle
+				glm::vec3 p = glm::cross(ray.direction, edge2);
+
+				float determinant = glm::dot(edge1, p);
+
+				if (std::fabs(determinant) < 1e-12f) return -1.0f;
+
+				float inverse = 1.0f / determinant;
+
+				// barycentric coordinates
+				glm::vec3 offset = ray.origin - a;
+
+				float u = glm::dot(offset, p) * inverse;
+
+				if (u < 0.0f || u > 1.0f) return -1.0f;
+
+				glm::vec3 q = glm::cross(offset, edge1);
+
+				float v = glm::dot(ray.direction, q) * inverse;
+
+				if (v < 0.0f || u + v > 1.0f) return -1.0f;
+
+				// distance along ray
+				float distance = glm::dot(edge2, q) * inverse;
+
+				return (distance >= 0.0f && distance <= length) ? distance : -1.0f;
+			}
+		}
+	}
+}
+#endif
\ No newline at end of file
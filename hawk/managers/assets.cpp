@@ -33,6 +33,8 @@ namespace hawk
 			if (!addShader("PostProcessFinal", std::vector<std::string> { "../data/shaders/post-process/screen.vert", "../data/shaders/post-process/final.frag" })) return false;
 			if (!addShader("UnlitColored", std::vector<std::string> { "../data/shaders/unlit/colored.vert", "../data/shaders/unlit/colored.frag" })) return false;
 			if (!addShader("UnlitTextured", std::vector<std::string> { "../data/shaders/unlit/textured.vert", "../data/shaders/unlit/textured.frag" })) return false;
+			if (!addShader("CullingDraws", std::vector<std::string> { "../data/shaders/culling/draws.comp" })) return false;
+			if (!addShader("CullingDepthPyramid", std::vector<std::string> { "../data/shaders/culling/depth_pyramid.comp" })) return false;
 
 			// load lighting shaders based on render path and ligthing method
 			if (app.video.getRendering() == Managers::Video::Rendering::Forward)
@@ -520,14 +522,14 @@ namespace hawk
 			}
 		}
 
-		hawk::Assets::Model* Assets::addModel(const char* name, const std::string& path)
+		hawk::Assets::Model* Assets::addModel(const char* name, const std::string& path, unsigned int lods, bool meshlets)
 		{
 			// model asset
 			hawk::Assets::Model* asset = new hawk::Assets::Model();
 			asset->m_name = name;
 
 			// load model file
-			if (!asset->load(path))
+			if (!asset->load(path, lods, meshlets))
 			{
 				// delete asset if failed
 				delete asset;
@@ -12,6 +12,7 @@
 #include "../assets/mesh.hpp"
 #include "../assets/model.hpp"
 #include "../assets/sound.hpp"
+#include "../assets/snapshot.hpp"
 
 namespace hawk
 {
@@ -175,9 +176,11 @@ namespace hawk
 			 * Add model.
 			 * @param name Asset name.
 			 * @param path Model file path.
+			 * @param lods Simplified meshes to generate per mesh.
+			 * @param meshlets Split meshes into meshlets for cluster culling?
 			 * @return Pointer to asset otherwise null pointer.
 			 */
-			hawk::Assets::Model* addModel(const char* name, const std::string& path);
+			hawk::Assets::Model* addModel(const char* name, const std::string& path, unsigned int lods = 0, bool meshlets = false);
 
 			/**
 			 * Add a list of pre-made models.
@@ -1,10 +1,23 @@
+#include "../system/core.hpp"
 #include "scene.hpp"
+#include "../components/mesh_renderer.hpp"
+#include <algorithm>
 
 namespace hawk
 {
 	namespace Managers
 	{
-		Scene::Scene() : world(nullptr)
+		/**
+		 * Phases which have a registry, in registry order.
+		 */
+		static const Components::Component::Phase registry_phases[4] = {
+			Components::Component::Phase::FixedUpdate,
+			Components::Component::Phase::Update,
+			Components::Component::Phase::LateUpdate,
+			Components::Component::Phase::Render
+		};
+
+		Scene::Scene() : world(nullptr), parallel(false), m_active_stamp(1), m_updating_parallel(false)
 		{
 			// set manager name
 			m_name = "Scene";
@@ -36,21 +49,723 @@ namespace hawk
 
 				world = nullptr;
 			}
+
+			// clear transform store
+			transforms.clear();
+
+			// clear registries
+			m_buckets.clear();
+			m_entities.clear();
+			m_destroyed_objects.clear();
+			m_static_batches.clear();
+			m_deferred.clear();
 		}
 
 		void Scene::addToDestroyedObjects(Objects::Entity* entity)
 		{
-			m_destroyed_objects.insert(m_destroyed_objects.end(), std::make_pair(entity->getName().c_str(), entity));
+			// list is shared by workers
+			if (m_updating_parallel)
+			{
+				defer([this, entity]() { addToDestroyedObjects(entity); });
+
+				return;
+			}
+
+			m_destroyed_objects.push_back(std::make_pair(entity->getHandle(), entity));
 		}
 
 		void Scene::processDestroyedObjects()
 		{
-			// destroy collected objects
-			for (auto entity : m_destroyed_objects)
-				Objects::Entity::destroyImmediate(entity.second);
+			// return if there is nothing to destroy
+			if (m_destroyed_objects.empty()) return;
+
+			// destroy collected objects, duplicates and children of destroyed entities are already stale
+			for (size_t i = 0; i < m_destroyed_objects.size(); ++i)
+			{
+				Objects::Entity* entity = m_destroyed_objects[i].first.isValid() ? pool.resolve(m_destroyed_objects[i].first) : m_destroyed_objects[i].second;
+
+				if (entity) Objects::Entity::destroyImmediate(entity);
+			}
 
 			// clear list
 			m_destroyed_objects.clear();
 		}
+
+		void Scene::addToStaticBatches(Objects::Entity* entity, bool state)
+		{
+			// list is shared by workers
+			if (m_updating_parallel)
+			{
+				defer([this, entity, state]() { addToStaticBatches(entity, state); });
+
+				return;
+			}
+
+			// skip repeated requests, sources of one batch may all ask for it to be built again
+			if (!m_static_batches.empty() && m_static_batches.back().first.second == entity && m_static_batches.back().second == state) return;
+
+			m_static_batches.push_back(std::make_pair(std::make_pair(entity->getHandle(), entity), state));
+		}
+
+		void Scene::processStaticBatches()
+		{
+			// return if there is nothing to batch
+			if (m_static_batches.empty()) return;
+
+			// requests in order, so a later request of a subtree overrides earlier ones
+			for (size_t i = 0; i < m_static_batches.size(); ++i)
+			{
+				const auto& request = m_static_batches[i].first;
+
+				Objects::Entity* root = request.first.isValid() ? pool.resolve(request.first) : request.second;
+
+				// skip destroyed subtrees
+				if (!root) continue;
+
+				// split batches holding subtree renderers, then merge what is still static in their roots
+				std::vector<Objects::Entity*> roots(1, root);
+
+				if (!m_static_batches[i].second) roots = m_static_batcher.invalidate(root);
+
+				for (auto item : roots)
+				{
+					Objects::Entity* batch = m_static_batcher.build(item);
+
+					// start merged renderers of registered subtrees
+					if (!batch || item->m_scene_slot < 0) continue;
+
+					for (auto component : batch->components)
+					{
+						if (component.second->enable && component.second->hasPhase(Components::Component::Phase::Start))
+							component.second->start();
+					}
+				}
+			}
+
+			// clear list
+			m_static_batches.clear();
+		}
+
+		void Scene::fixedUpdate()
+		{
+			// components
+			dispatch(0, &Components::Component::fixedUpdate);
+
+			// entity callbacks
+			for (size_t i = 0; i < m_entities.size(); ++i)
+			{
+				Objects::Entity* entity = m_entities[i];
+
+				if (entity->onFixedUpdate && entity->isActive()) (*entity->onFixedUpdate)(entity);
+			}
+		}
+
+		void Scene::update()
+		{
+			// update subtrees on worker threads
+			if (parallel && world)
+			{
+				updateParallel();
+
+				return;
+			}
+
+			// components
+			dispatch(1, &Components::Component::update);
+
+			// entity callbacks
+			for (size_t i = 0; i < m_entities.size(); ++i)
+			{
+				Objects::Entity* entity = m_entities[i];
+
+				if (entity->onUpdate && entity->isActive()) (*entity->onUpdate)(entity);
+			}
+		}
+
+		void Scene::updateParallel()
+		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			// calculate stored transforms so workers only read them
+			transforms.update();
+
+			// queue changes from here on
+			m_updating_parallel = true;
+
+			transforms.setParallel(true);
+
+			// a few subtrees per thread to balance load
+			size_t target = (app.workers.getCount() + 1) * 4;
+
+			// split breadth first, split nodes are updated on main thread before their children
+			m_subtrees.clear();
+			m_subtrees.push_back(world);
+
+			size_t first = 0;
+
+			while (first < m_subtrees.size() && m_subtrees.size() - first < target)
+			{
+				Objects::Entity* entity = m_subtrees[first++];
+
+				// skip disabled and unregistered entities with their children
+				if (!entity->enable || entity->m_scene_slot < 0) continue;
+
+				updateEntity(entity);
+
+				// children become subtrees
+				for (auto child : entity->entities)
+					m_subtrees.push_back(child.second);
+			}
+
+			// update remaining subtrees on workers
+			for (size_t i = first; i < m_subtrees.size(); ++i)
+			{
+				Objects::Entity* entity = m_subtrees[i];
+
+				app.workers.push([this, entity]() { updateTree(entity); });
+			}
+
+			app.workers.wait();
+
+			// apply queued transform changes
+			m_updating_parallel = false;
+
+			transforms.setParallel(false);
+
+			// apply deferred changes in order they were made
+			std::vector<std::function<void()>> jobs;
+
+			jobs.swap(m_deferred);
+
+			for (auto& job : jobs)
+				job();
+
+			// run main thread work like buffer uploads
+			app.workers.flush();
+
+			// calculate transforms outside store which were changed during update
+			if (Components::Transform::TYPE_ID < m_buckets.size())
+			{
+				std::vector<Components::Component*>& registry = m_buckets[Components::Transform::TYPE_ID].components[1];
+
+				for (size_t i = 0; i < registry.size(); ++i)
+					registry[i]->update();
+			}
+		}
+
+		void Scene::updateEntity(Objects::Entity* entity)
+		{
+			// components
+			for (auto component : entity->components)
+			{
+				Components::Component* item = component.second;
+
+				if (item->enable && item->m_registry_bucket >= 0 && item->hasPhase(Components::Component::Phase::Update)) item->update();
+			}
+
+			// entity callback
+			if (entity->onUpdate) (*entity->onUpdate)(entity);
+		}
+
+		void Scene::updateTree(Objects::Entity* entity)
+		{
+			// skip disabled and unregistered entities with their children
+			if (!entity->enable || entity->m_scene_slot < 0) return;
+
+			updateEntity(entity);
+
+			// child entities
+			for (auto child : entity->entities)
+				updateTree(child.second);
+		}
+
+		void Scene::lateUpdate()
+		{
+			// components
+			dispatch(2, &Components::Component::lateUpdate);
+
+			// entity callbacks
+			for (size_t i = 0; i < m_entities.size(); ++i)
+			{
+				Objects::Entity* entity = m_entities[i];
+
+				if (entity->onLateUpdate && entity->isActive()) (*entity->onLateUpdate)(entity);
+			}
+		}
+
+		void Scene::render()
+		{
+			// components
+			dispatch(3, &Components::Component::render);
+		}
+
+		bool Scene::saveSnapshot(const char* path)
+		{
+			// world children
+			std::vector<Objects::Entity*> roots;
+
+			for (auto entity : world->entities)
+				roots.push_back(entity.second);
+
+			return hawk::Assets::Snapshot::save(path, roots);
+		}
+
+		bool Scene::loadSnapshot(const char* path)
+		{
+			// map snapshot
+			hawk::Assets::Snapshot* snapshot = new hawk::Assets::Snapshot();
+
+			if (!snapshot->load(path))
+			{
+				snapshot->release();
+
+				return false;
+			}
+
+			// make entities under world
+			std::vector<Objects::Entity*> roots = snapshot->instantiate(world);
+
+			// call start event once per root
+			for (auto root : roots)
+				root->start();
+
+			// unmap snapshot
+			snapshot->release();
+
+			return true;
+		}
+
+		bool Scene::raycast(const Helpers::Bounds::Ray& ray, float length, Hit& hit, bool exact) const
+		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			hit.renderer = nullptr;
+			hit.distance = length;
+
+			// normal of nearest accepted hit
+			glm::vec3 normal(0.0f);
+
+			// static renderers first, their hit shortens dynamic ray
+			const Objects::Bvh* trees[2] = { &app.video.getStaticTree(), &app.video.getDynamicTree() };
+			const std::vector<Components::Renderer*>* lists[2] = { &app.video.getStaticRenderers(), &app.video.getDynamicRenderers() };
+
+			for (unsigned int i = 0; i < 2; ++i)
+			{
+				const std::vector<Components::Renderer*>& renderers = *lists[i];
+
+				int item = trees[i]->raycast(ray, hit.distance, [&](unsigned int index, float nearest) -> float
+				{
+					if (!renderers[index]) return -1.0f;
+
+					glm::vec3 surface;
+
+					float distance = raycastRenderer(renderers[index], ray, nearest, exact, surface);
+
+					if (distance >= 0.0f && distance <= nearest) normal = surface;
+
+					return distance;
+				});
+
+				if (item >= 0) hit.renderer = renderers[item];
+			}
+
+			// return if ray hit nothing
+			if (!hit.renderer) return false;
+
+			hit.point = ray.origin + ray.direction * hit.distance;
+			hit.normal = normal;
+
+			return true;
+		}
+
+		void Scene::raycast(const std::vector<RayQuery>& queries, std::vector<Hit>& hits) const
+		{
+			hits.resize(queries.size());
+
+			batch(queries.size(), [this, &queries, &hits](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+					raycast(queries[i].ray, queries[i].length, hits[i], queries[i].exact);
+			});
+		}
+
+		void Scene::overlap(const Helpers::Bounds::Sphere& sphere, std::vector<Components::Renderer*>& result) const
+		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			result.clear();
+
+			std::vector<unsigned int> items;
+
+			// static renderers
+			app.video.getStaticTree().query(sphere, items);
+
+			for (auto item : items)
+				if (app.video.getStaticRenderers()[item]) result.push_back(app.video.getStaticRenderers()[item]);
+
+			// dynamic renderers
+			items.clear();
+
+			app.video.getDynamicTree().query(sphere, items);
+
+			for (auto item : items)
+				if (app.video.getDynamicRenderers()[item]) result.push_back(app.video.getDynamicRenderers()[item]);
+		}
+
+		void Scene::overlap(const std::vector<Helpers::Bounds::Sphere>& spheres, std::vector<std::vector<Components::Renderer*>>& results) const
+		{
+			results.resize(spheres.size());
+
+			batch(spheres.size(), [this, &spheres, &results](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+					overlap(spheres[i], results[i]);
+			});
+		}
+
+		void Scene::overlap(const Helpers::Bounds::Box& box, std::vector<Components::Renderer*>& result) const
+		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			result.clear();
+
+			std::vector<unsigned int> items;
+
+			// static renderers
+			app.video.getStaticTree().query(box, items);
+
+			for (auto item : items)
+				if (app.video.getStaticRenderers()[item]) result.push_back(app.video.getStaticRenderers()[item]);
+
+			// dynamic renderers
+			items.clear();
+
+			app.video.getDynamicTree().query(box, items);
+
+			for (auto item : items)
+				if (app.video.getDynamicRenderers()[item]) result.push_back(app.video.getDynamicRenderers()[item]);
+		}
+
+		void Scene::overlap(const std::vector<Helpers::Bounds::Box>& boxes, std::vector<std::vector<Components::Renderer*>>& results) const
+		{
+			results.resize(boxes.size());
+
+			batch(boxes.size(), [this, &boxes, &results](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+					overlap(boxes[i], results[i]);
+			});
+		}
+
+		void Scene::nearest(const glm::vec3& point, unsigned int count, float length, std::vector<Components::Renderer*>& result) const
+		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			result.clear();
+
+			// nearest of each tree, removed renderers are skipped so they may return less than count
+			std::vector<std::pair<float, unsigned int>> statics, dynamics;
+
+			app.video.getStaticTree().nearest(point, count, length, statics);
+			app.video.getDynamicTree().nearest(point, count, length, dynamics);
+
+			// merge sorted lists
+			size_t i = 0, j = 0;
+
+			while (result.size() < count && (i < statics.size() || j < dynamics.size()))
+			{
+				Components::Renderer* renderer = nullptr;
+
+				if (j == dynamics.size() || (i < statics.size() && statics[i].first <= dynamics[j].first))
+					renderer = app.video.getStaticRenderers()[statics[i++].second];
+				else
+					renderer = app.video.getDynamicRenderers()[dynamics[j++].second];
+
+				if (renderer) result.push_back(renderer);
+			}
+		}
+
+		void Scene::nearest(const std::vector<glm::vec3>& points, unsigned int count, float length, std::vector<std::vector<Components::Renderer*>>& results) const
+		{
+			results.resize(points.size());
+
+			batch(points.size(), [this, &points, count, length, &results](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+					nearest(points[i], count, length, results[i]);
+			});
+		}
+
+		bool Scene::isUpdatingParallel() const
+		{
+			return m_updating_parallel;
+		}
+
+		void Scene::defer(const std::function<void()>& job)
+		{
+			// run right away outside parallel update
+			if (!m_updating_parallel)
+			{
+				job();
+
+				return;
+			}
+
+			std::lock_guard<std::mutex> lock(m_deferred_mutex);
+
+			m_deferred.push_back(job);
+		}
+
+		void Scene::invalidateActive()
+		{
+			// stamp is shared by workers
+			if (m_updating_parallel)
+			{
+				defer([this]() { invalidateActive(); });
+
+				return;
+			}
+
+			// skip zero, new entities hold it
+			if (++m_active_stamp == 0) m_active_stamp = 1;
+		}
+
+		unsigned int Scene::getActiveStamp() const
+		{
+			return m_active_stamp;
+		}
+
+		void Scene::addEntity(Objects::Entity* entity)
+		{
+			// registries are shared by workers
+			if (m_updating_parallel)
+			{
+				defer([this, entity]() { addEntity(entity); });
+
+				return;
+			}
+
+			// return if already registered
+			if (entity->m_scene_slot >= 0) return;
+
+			// push to the list
+			entity->m_scene_slot = static_cast<int>(m_entities.size());
+
+			m_entities.push_back(entity);
+		}
+
+		void Scene::removeEntity(Objects::Entity* entity)
+		{
+			// registries are shared by workers
+			if (m_updating_parallel)
+			{
+				defer([this, entity]() { removeEntity(entity); });
+
+				return;
+			}
+
+			// return if not registered
+			if (entity->m_scene_slot < 0) return;
+
+			// move last entity to the free slot
+			Objects::Entity* last = m_entities.back();
+
+			m_entities[entity->m_scene_slot] = last;
+			last->m_scene_slot = entity->m_scene_slot;
+
+			m_entities.pop_back();
+
+			// reset slot
+			entity->m_scene_slot = -1;
+		}
+
+		void Scene::addComponent(Components::Component* component)
+		{
+			// registries are shared by workers
+			if (m_updating_parallel)
+			{
+				defer([this, component]() { addComponent(component); });
+
+				return;
+			}
+
+			// return if already registered
+			if (component->m_registry_bucket >= 0) return;
+
+			// type bucket
+			unsigned int bucket = component->getTypeId();
+
+			// make buckets up to this type
+			if (bucket >= m_buckets.size()) m_buckets.resize(bucket + 1);
+
+			// set bucket
+			component->m_registry_bucket = static_cast<int>(bucket);
+
+			// push to registries of implemented phases
+			for (unsigned int i = 0; i < 4; ++i)
+			{
+				if (!component->hasPhase(registry_phases[i])) continue;
+
+				std::vector<Components::Component*>& registry = m_buckets[bucket].components[i];
+
+				component->m_registry_slots[i] = static_cast<unsigned int>(registry.size());
+
+				registry.push_back(component);
+			}
+		}
+
+		void Scene::removeComponent(Components::Component* component)
+		{
+			// registries are shared by workers
+			if (m_updating_parallel)
+			{
+				defer([this, component]() { removeComponent(component); });
+
+				return;
+			}
+
+			// return if not registered
+			if (component->m_registry_bucket < 0) return;
+
+			// remove from registries of implemented phases
+			for (unsigned int i = 0; i < 4; ++i)
+			{
+				if (!component->hasPhase(registry_phases[i])) continue;
+
+				std::vector<Components::Component*>& registry = m_buckets[component->m_registry_bucket].components[i];
+
+				// move last component to the free slot
+				Components::Component* last = registry.back();
+
+				registry[component->m_registry_slots[i]] = last;
+				last->m_registry_slots[i] = component->m_registry_slots[i];
+
+				registry.pop_back();
+			}
+
+			// reset bucket
+			component->m_registry_bucket = -1;
+		}
+
+		float Scene::raycastRenderer(const Components::Renderer* renderer, const Helpers::Bounds::Ray& ray, float length, bool exact, glm::vec3& normal)
+		{
+			// triangles of single draw meshes, instanced renderers are tested by bounds
+			const Objects::Bvh* tree = nullptr;
+
+			bool instanced = renderer->getTypeId() == Components::MeshRenderer::TYPE_ID && !static_cast<const Components::MeshRenderer*>(renderer)->instances.empty();
+
+			if (exact && renderer->mesh && !instanced) tree = renderer->mesh->getTree();
+
+			if (!tree)
+			{
+				const Helpers::Bounds::Box& box = renderer->getWorldBounds();
+
+				float distance = Helpers::Bounds::intersects(ray, box, length);
+
+				if (distance < 0.0f) return distance;
+
+				// face of box nearest to hit point, ray starting inside faces back
+				glm::vec3 offset = ray.origin + ray.direction * distance - (box.min + box.max) * 0.5f;
+				glm::vec3 extent = glm::max((box.max - box.min) * 0.5f, glm::vec3(1e-6f));
+
+				glm::vec3 scaled = offset / extent;
+				glm::vec3 side = glm::abs(scaled);
+
+				unsigned int axis = (side.x >= side.y && side.x >= side.z) ? 0 : (side.y >= side.z ? 1 : 2);
+
+				normal = glm::vec3(0.0f);
+				normal[axis] = scaled[axis] < 0.0f ? -1.0f : 1.0f;
+
+				if (distance == 0.0f) normal = -ray.direction;
+
+				return distance;
+			}
+
+			// ray in mesh space, model matrix is affine so distances scale linearly
+			const hawk::Assets::Mesh* mesh = renderer->mesh;
+
+			glm::mat4 inverse = glm::inverse(renderer->getWorldMatrix());
+
+			glm::vec3 origin = glm::vec3(inverse * glm::vec4(ray.origin, 1.0f));
+			glm::vec3 direction = glm::vec3(inverse * glm::vec4(ray.direction * length, 0.0f));
+
+			float local_length = glm::length(direction);
+
+			if (local_length <= 0.0f) return -1.0f;
+
+			Helpers::Bounds::Ray local = { origin, direction * (1.0f / local_length) };
+
+			float nearest = local_length;
+
+			int triangle = tree->raycast(local, nearest, [mesh, &local](unsigned int index, float range) -> float
+			{
+				glm::vec3 a, b, c;
+
+				mesh->getTriangle(index, a, b, c);
+
+				return Helpers::Bounds::intersects(local, a, b, c, range);
+			});
+
+			if (triangle < 0) return -1.0f;
+
+			// world normal facing ray origin
+			glm::vec3 a, b, c;
+
+			mesh->getTriangle(static_cast<unsigned int>(triangle), a, b, c);
+
+			normal = glm::normalize(glm::vec3(glm::transpose(inverse) * glm::vec4(glm::cross(b - a, c - a), 0.0f)));
+
+			if (glm::dot(normal, ray.direction) > 0.0f) normal = -normal;
+
+			return nearest * (length / local_length);
+		}
+
+		void Scene::batch(size_t count, const std::function<void(size_t, size_t)>& job) const
+		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			// run small batches and batches issued from jobs inline, jobs can't wait for other jobs
+			if (count <= QUERY_CHUNK || !app.workers.isMainThread() || app.workers.isInJob())
+			{
+				job(0, count);
+
+				return;
+			}
+
+			for (size_t first = 0; first < count; first += QUERY_CHUNK)
+			{
+				size_t last = std::min(first + QUERY_CHUNK, count);
+
+				app.workers.push([&job, first, last]() { job(first, last); });
+			}
+
+			app.workers.wait();
+		}
+
+		void Scene::dispatch(unsigned int registry, void (Components::Component::*event)())
+		{
+			// pick up enable flags written since last phase
+			invalidateActive();
+
+			// iterate type buckets, lists may grow while iterating
+			for (size_t b = 0; b < m_buckets.size(); ++b)
+			{
+				for (size_t i = 0; i < m_buckets[b].components[registry].size(); ++i)
+				{
+					Components::Component* component = m_buckets[b].components[registry][i];
+
+					// skip disabled components and components of inactive entities
+					if (!component->enable || (component->entity && !component->entity->isActive())) continue;
+
+					(component->*event)();
+				}
+			}
+		}
 	}
 }
\ No newline at end of file
@@ -3,10 +3,20 @@
 
 // stl
 #include <map>
+#include <mutex>
+#include <vector>
+#include <functional>
+
+// glm
+#include <glm/glm.hpp>
 
 // local
 #include "manager.hpp"
+#include "../helpers/bounds.hpp"
 #include "../objects/entity.hpp"
+#include "../objects/entity_pool.hpp"
+#include "../objects/static_batcher.hpp"
+#include "../objects/transform_store.hpp"
 
 namespace hawk
 {
@@ -18,6 +28,58 @@ namespace hawk
 		class Scene : public Manager
 		{
 		public:
+			/**
+			 * Raycast hit.
+			 */
+			struct Hit
+			{
+				/**
+				 * Hit renderer, nullptr if ray hit nothing.
+				 */
+				Components::Renderer* renderer;
+
+				/**
+				 * Distance along ray.
+				 */
+				float distance;
+
+				/**
+				 * World hit point.
+				 */
+				glm::vec3 point;
+
+				/**
+				 * World surface normal facing ray origin.
+				 */
+				glm::vec3 normal;
+			};
+
+			/**
+			 * Raycast of a batch.
+			 */
+			struct RayQuery
+			{
+				/**
+				 * Ray with normalized direction.
+				 */
+				Helpers::Bounds::Ray ray;
+
+				/**
+				 * Ray length.
+				 */
+				float length;
+
+				/**
+				 * Test mesh triangles instead of bounds.
+				 */
+				bool exact;
+			};
+
+			/**
+			 * Queries per worker job of a batch.
+			 */
+			static constexpr unsigned int QUERY_CHUNK = 32;
+
 			/**
 			 * Constructor.
 			 */
@@ -67,16 +129,285 @@ namespace hawk
 			 */
 			void processDestroyedObjects();
 
+			/**
+			 * Add subtree to have its static geometry merged or split on end of frame. Splitting also splits batches of
+			 * ancestors holding subtree renderers, and merges their remaining static renderers again.
+			 * @param entity Subtree root.
+			 * @param state Merge if true, split if false.
+			 */
+			void addToStaticBatches(Objects::Entity* entity, bool state);
+
+			/**
+			 * Handle static batches, merged renderers of registered subtrees are started.
+			 */
+			void processStaticBatches();
+
+			/**
+			 * Fixed update registered components and entities.
+			 */
+			void fixedUpdate();
+
+			/**
+			 * Update registered components and entities.
+			 */
+			void update();
+
+			/**
+			 * Late update registered components and entities.
+			 */
+			void lateUpdate();
+
+			/**
+			 * Render registered components.
+			 */
+			void render();
+
+			/**
+			 * Write world entities to a binary snapshot file.
+			 * @param path Snapshot file path.
+			 * @return True or False.
+			 */
+			bool saveSnapshot(const char* path);
+
+			/**
+			 * Add entities of a binary snapshot file to world, referenced assets must be loaded already.
+			 * @param path Snapshot file path.
+			 * @return True or False.
+			 */
+			bool loadSnapshot(const char* path);
+
+			/**
+			 * Nearest renderer along a ray. Queries use renderer trees of last rendered frame and must not run while video renders.
+			 * @param ray Ray with normalized direction.
+			 * @param length Ray length.
+			 * @param hit Nearest hit.
+			 * @param exact Test mesh triangles instead of bounds, instanced renderers are tested by bounds.
+			 * @return True or False.
+			 */
+			bool raycast(const Helpers::Bounds::Ray& ray, float length, Hit& hit, bool exact = true) const;
+
+			/**
+			 * Raycast a batch on worker threads.
+			 * @param queries Raycasts.
+			 * @param hits Nearest hit of each raycast.
+			 */
+			void raycast(const std::vector<RayQuery>& queries, std::vector<Hit>& hits) const;
+
+			/**
+			 * Renderers with bounds overlapping a sphere.
+			 * @param sphere World sphere.
+			 * @param result List to fill.
+			 */
+			void overlap(const Helpers::Bounds::Sphere& sphere, std::vector<Components::Renderer*>& result) const;
+
+			/**
+			 * Sphere overlaps of a batch on worker threads.
+			 * @param spheres World spheres.
+			 * @param results Renderers of each sphere.
+			 */
+			void overlap(const std::vector<Helpers::Bounds::Sphere>& spheres, std::vector<std::vector<Components::Renderer*>>& results) const;
+
+			/**
+			 * Renderers with bounds overlapping a box.
+			 * @param box World box.
+			 * @param result List to fill.
+			 */
+			void overlap(const Helpers::Bounds::Box& box, std::vector<Components::Renderer*>& result) const;
+
+			/**
+			 * Box overlaps of a batch on worker threads.
+			 * @param boxes World boxes.
+			 * @param results Renderers of each box.
+			 */
+			void overlap(const std::vector<Helpers::Bounds::Box>& boxes, std::vector<std::vector<Components::Renderer*>>& results) const;
+
+			/**
+			 * Renderers with bounds nearest to a point.
+			 * @param point World point.
+			 * @param count Maximum renderers count.
+			 * @param length Maximum distance.
+			 * @param result List to fill, nearest first.
+			 */
+			void nearest(const glm::vec3& point, unsigned int count, float length, std::vector<Components::Renderer*>& result) const;
+
+			/**
+			 * Nearest renderers of a batch on worker threads.
+			 * @param points World points.
+			 * @param count Maximum renderers count per point.
+			 * @param length Maximum distance.
+			 * @param results Renderers of each point, nearest first.
+			 */
+			void nearest(const std::vector<glm::vec3>& points, unsigned int count, float length, std::vector<std::vector<Components::Renderer*>>& results) const;
+
+			/**
+			 * Is world being updated on worker threads? Structural changes are deferred to main thread while it is.
+			 */
+			bool isUpdatingParallel() const;
+
+			/**
+			 * Queue a change to run on main thread after parallel update.
+			 * @param job Change function.
+			 */
+			void defer(const std::function<void()>& job);
+
+			/**
+			 * Drop cached entity activity, called when entities are enabled, disabled or moved to another parent.
+			 */
+			void invalidateActive();
+
+			/**
+			 * Stamp of cached entity activity.
+			 */
+			unsigned int getActiveStamp() const;
+
+			/**
+			 * Register an entity for its callbacks.
+			 * @param entity Entity object.
+			 */
+			void addEntity(Objects::Entity* entity);
+
+			/**
+			 * Unregister an entity.
+			 * @param entity Entity object.
+			 */
+			void removeEntity(Objects::Entity* entity);
+
+			/**
+			 * Register a component to registries of phases it implements.
+			 * @param component Component object.
+			 */
+			void addComponent(Components::Component* component);
+
+			/**
+			 * Unregister a component.
+			 * @param component Component object.
+			 */
+			void removeComponent(Components::Component* component);
+
+			/**
+			 * Entity pool.
+			 */
+			Objects::EntityPool pool;
+
 			/**
 			 * World entity.
 			 */
 			Objects::Entity* world;
 
+			/**
+			 * Transform store.
+			 */
+			Objects::TransformStore transforms;
+
+			/**
+			 * Update independent subtrees of world on worker threads. Entity and component changes made by updates are applied
+			 * after all subtrees are done and world values of transforms stay those of frame start until then.
+			 */
+			bool parallel;
+
 		private:
 			/**
-			 * Destroyed objects list.
+			 * Per type component registries.
+			 */
+			struct Bucket
+			{
+				/**
+				 * Components per registered phase.
+				 */
+				std::vector<Components::Component*> components[4];
+			};
+
+			/**
+			 * Call an event on registered components of a phase.
+			 * @param registry Phase registry index.
+			 * @param event Component event.
+			 */
+			void dispatch(unsigned int registry, void (Components::Component::*event)());
+
+			/**
+			 * Split world into subtrees and update them on worker threads.
+			 */
+			void updateParallel();
+
+			/**
+			 * Update components and callback of a registered entity.
+			 * @param entity Entity object.
+			 */
+			void updateEntity(Objects::Entity* entity);
+
+			/**
+			 * Update a registered entity and its children.
+			 * @param entity Subtree root.
+			 */
+			void updateTree(Objects::Entity* entity);
+
+			/**
+			 * Test a ray against one renderer.
+			 * @param renderer Renderer.
+			 * @param ray World ray.
+			 * @param length Ray length.
+			 * @param exact Test mesh triangles.
+			 * @param normal World normal of hit.
+			 * @return Hit distance or -1 if ray misses.
+			 */
+			static float raycastRenderer(const Components::Renderer* renderer, const Helpers::Bounds::Ray& ray, float length, bool exact, glm::vec3& normal);
+
+			/**
+			 * Run a batch of queries in chunks on worker threads, inline if caller is a worker or a job.
+			 * @param count Queries count.
+			 * @param job Function running a range of queries.
+			 */
+			void batch(size_t count, const std::function<void(size_t, size_t)>& job) const;
+
+			/**
+			 * Component registries indexed by component type id.
+			 */
+			std::vector<Bucket> m_buckets;
+
+			/**
+			 * Registered entities.
+			 */
+			std::vector<Objects::Entity*> m_entities;
+
+			/**
+			 * Subtrees of last parallel update.
+			 */
+			std::vector<Objects::Entity*> m_subtrees;
+
+			/**
+			 * Entity activity stamp, advanced on every phase so direct enable writes are seen on next phase.
+			 */
+			unsigned int m_active_stamp;
+
+			/**
+			 * Is world being updated on worker threads?
+			 */
+			bool m_updating_parallel;
+
+			/**
+			 * Deferred changes lock.
+			 */
+			std::mutex m_deferred_mutex;
+
+			/**
+			 * Changes deferred during parallel update.
+			 */
+			std::vector<std::function<void()>> m_deferred;
+
+			/**
+			 * Destroyed objects queue, handles of entities which are already destroyed resolve to nothing.
+			 */
+			std::vector<std::pair<Objects::EntityHandle, Objects::Entity*>> m_destroyed_objects;
+
+			/**
+			 * Static batches queue, latest request of a subtree wins.
+			 */
+			std::vector<std::pair<std::pair<Objects::EntityHandle, Objects::Entity*>, bool>> m_static_batches;
+
+			/**
+			 * Static geometry merger.
 			 */
-			std::map<const char*, Objects::Entity*> m_destroyed_objects;
+			Objects::StaticBatcher m_static_batcher;
 		};
 	}
 }
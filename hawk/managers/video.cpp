@@ -1,24 +1,33 @@
 #include "../system/core.hpp"
 #include "video.hpp"
 #include "../objects/entity.hpp"
+#include "../components/mesh_renderer.hpp"
 #include <sstream>
 #include <glm/gtc/type_ptr.hpp>
 #include "../helpers/memory.hpp"
 #include <random>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
 
 namespace hawk
 {
 	namespace Managers
 	{
-		Video::Video() : camera(nullptr), ambient(0.2f, 0.2f, 0.2f, 1.0f), ssao(false), fxaa(false), bloom(false),
-			m_rendering(Rendering::Forward), m_lighting(Lighting::BlinnPhong), m_max_lights(4), m_max_shadows(4), m_video_mode(nullptr),
+		Video::Video() : camera(nullptr), ambient(0.2f, 0.2f, 0.2f, 1.0f), ssao(false), fxaa(false), bloom(false), culling(true), spatial_index(true), occlusion(false), max_occluders(16), gpu_culling(false), lod_bias(1.0f), shadow_lod_bias(1), pvs(nullptr), instancing(true),
+			m_rendering(Rendering::Forward), m_lighting(Lighting::BlinnPhong), m_max_lights(4), m_max_shadows(4), m_video_mode(nullptr), m_render_camera(nullptr),
 			m_color_mask(false), m_depth_test(false), m_depth_func(GL_NONE), m_depth_mask(false), m_stencil_test(false), m_stencil_func(GL_NONE), m_stencil_func_ref(0), m_stencil_func_mask(0x00), 
 			m_stencil_op_fail(GL_NONE), m_stencil_op_zfail(GL_NONE), m_stencil_op_zpass(GL_NONE), m_stencil_mask(0x00), 
 			m_blend(false), m_blend_src_factor(GL_NONE), m_blend_dst_factor(GL_NONE), m_blend_equation(GL_NONE), m_blend_color(0.0f), 
-			m_face_cull(false), m_face_side(GL_NONE), m_face_orientation(GL_NONE), m_render_camera(nullptr), m_video_ubo(0), m_camera_ubo(0), m_scene_ubo(0), 
+			m_face_cull(false), m_face_side(GL_NONE), m_face_orientation(GL_NONE), m_polygon_mode(GL_NONE), m_viewport(-1), m_video_ubo(0), m_camera_ubo(0), m_scene_ubo(0), 
 			m_main_framebuffer(nullptr), m_ssao_noise_texture(nullptr), m_last_blur_framebuffer(0),
 			m_screen_mesh(nullptr), m_dsm_material(nullptr), m_odsm_material(nullptr), m_deferred_material(nullptr), m_screen_material(nullptr),
-			m_ssao_material(nullptr), m_ssao_blur_material(nullptr), m_fxaa_material(nullptr), m_blur_material(nullptr), m_final_material(nullptr)
+			m_ssao_material(nullptr), m_ssao_blur_material(nullptr), m_fxaa_material(nullptr), m_blur_material(nullptr), m_final_material(nullptr),
+			m_culled_renderers(0), m_drawn_renderers(0), m_occluded_renderers(0), m_culled_casters(0), m_drawn_casters(0), m_casters_count(0), m_culling_time(0.0), m_pvs_mapped(nullptr), m_instance_commands_buffer(0), m_instance_commands_mapping(nullptr),
+			m_instance_commands_capacity(0), m_instance_commands_region(0), m_instance_commands_offset(0), m_pyramid_camera(nullptr),
+			m_batch_buffer(0), m_batch_commands_buffer(0), m_tracking(false), m_bound_vao(UNKNOWN_BINDING), m_bound_program(UNKNOWN_BINDING), m_bound_material(nullptr), 
+			m_bound_draw_framebuffer(UNKNOWN_BINDING), m_bound_read_framebuffer(UNKNOWN_BINDING)
 		{
 			// set manager name
 			m_name = "Video";
@@ -26,6 +35,15 @@ namespace hawk
 			// zeroize
 			hawk::Helpers::Memory::zeroize(m_ssao_framebuffers, sizeof m_ssao_framebuffers);
 			hawk::Helpers::Memory::zeroize(m_blur_framebuffers, sizeof m_blur_framebuffers);
+			hawk::Helpers::Memory::zeroize(&m_skipped_calls, sizeof m_skipped_calls);
+
+			// texture units are not known until bound
+			for (unsigned int i = 0; i < MAX_TEXTURE_UNITS; ++i)
+				m_bound_textures[i] = UNKNOWN_BINDING;
+
+			// no draws read instance commands yet
+			for (unsigned int i = 0; i < COMMAND_REGIONS; ++i)
+				m_instance_commands_fences[i] = nullptr;
 		}
 
 		Video::~Video() {}
@@ -41,6 +59,9 @@ namespace hawk
 			// reset graphics to initial states
 			reset();
 
+			// make geometry arena, meshes build own buffers if it fails
+			if (!m_geometry_arena.initialize()) app.logger.warning("Failed to create geometry arena!");
+
 			// enable interpolation between cube map faces (prevent uneven faces artifact for mipped radiance maps)
 			glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 
@@ -282,6 +303,31 @@ namespace hawk
 				m_ssao_noise_texture = nullptr;
 			}
 
+			// free instance commands buffer
+			releaseInstanceCommands();
+
+			// free batch transforms buffer
+			if (m_batch_buffer)
+			{
+				glDeleteBuffers(1, &m_batch_buffer);
+
+				m_batch_buffer = 0;
+			}
+
+			// free batch commands buffer
+			if (m_batch_commands_buffer)
+			{
+				glDeleteBuffers(1, &m_batch_commands_buffer);
+
+				m_batch_commands_buffer = 0;
+			}
+
+			// free graphics device culling buffers
+			m_gpu_culler.release();
+
+			// free geometry arena, meshes are already released by assets
+			m_geometry_arena.deinitialize();
+
 			// free resources
 			release();
 		}
@@ -293,10 +339,32 @@ namespace hawk
 			ambient = glm::vec4(0.2f);
 			m_render_camera = nullptr;
 
+			// reset slots of listed components
+			for (auto item : cameras)
+				item->m_video_slot = -1;
+
+			for (auto item : lights)
+				item->m_video_slot = -1;
+
+			for (auto item : renderers)
+				item->m_video_slot = -1;
+
 			// clear lists
 			cameras.clear();
 			lights.clear();
 			renderers.clear();
+			m_active_cameras.clear();
+			m_active_lights.clear();
+			m_active_renderers.clear();
+			m_direct_renderers.clear();
+			m_pyramid_camera = nullptr;
+
+			// clear trees
+			m_static_renderers.clear();
+			m_static_tree.clear();
+			m_pvs_mapped = nullptr;
+			m_dynamic_renderers.clear();
+			m_dynamic_tree.clear();
 		}
 
 		void Video::reset()
@@ -327,7 +395,7 @@ namespace hawk
 			setFaceOrientation(GL_CCW);
 
 			// configure fill mode
-			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+			setPolygonMode(GL_FILL);
 		}
 		
 		void Video::start()
@@ -353,6 +421,9 @@ namespace hawk
 			if (m_rendering == Rendering::Deferred)
 				m_deferred_material = app.assets.materials["DeferredLighting"];
 
+			// get culling compute shaders
+			m_gpu_culler.setShaders(app.assets.shaders["CullingDraws"], app.assets.shaders["CullingDepthPyramid"]);
+
 			// set ssao sample kernel uniform
 			m_ssao_material->getShader()->setFloatVec3("kernel", m_ssao_kernel);
 		}
@@ -365,6 +436,12 @@ namespace hawk
 			// bloom integer equivalent
 			int bloom_int = (bloom) ? 1 : 0;
 
+			// start instance commands of this frame
+			advanceInstanceCommands();
+
+			// collect enabled components
+			gatherActive();
+
 			// fill video ubo
 			glBindBuffer(GL_UNIFORM_BUFFER, m_video_ubo);
 			glBufferSubData(GL_UNIFORM_BUFFER, 0, 16, glm::value_ptr(ambient));
@@ -376,7 +453,7 @@ namespace hawk
 			glBindBuffer(GL_UNIFORM_BUFFER, m_scene_ubo);
 
 			// fill scene lights
-			if (!lights.empty())
+			if (!m_active_lights.empty())
 			{
 				// list of active lights
 				std::vector<Light> scene_lights;
@@ -391,28 +468,25 @@ namespace hawk
 				for (unsigned int i = 0; i < m_max_lights; ++i)
 				{
 					// break if light is out of active lights range
-					if (i + 1 > lights.size()) break;
-
-					// continue if light is disabled
-					if (!lights[i]->enable) continue;
+					if (i + 1 > m_active_lights.size()) break;
 
 					// set shared properties
 					light.id = i;
-					light.type = (int)lights[i]->getLightType();
-					light.cast_shadows = lights[i]->cast_shadows ? 1 : 0;
-					light.shadow_map_id = (lights[i]->cast_shadows && shadow_map_id < m_max_shadows) ? shadow_map_id++ : 0;
-					light.color = lights[i]->color * lights[i]->intensity;
-					light.direction = glm::vec4(lights[i]->entity->transform->getWorldRotation(), 0.0f);
-					light.position = glm::vec4(lights[i]->entity->transform->getWorldPosition(), 0.0f);
-					light.range = lights[i]->range;
-					light.cut_off = lights[i]->cut_off;
-					light.outer_cut_off = lights[i]->outer_cut_off;
-					light.far_plane = lights[i]->far_plane;
-					light.matrix = (lights[i]->getLightType() != Components::Light::Type::Point) ? lights[i]->getProjectionMatrix() * lights[i]->getViewMatrix() : glm::mat4(1.0f);
-				}
+					light.type = (int)m_active_lights[i]->getLightType();
+					light.cast_shadows = m_active_lights[i]->cast_shadows ? 1 : 0;
+					light.shadow_map_id = (m_active_lights[i]->cast_shadows && shadow_map_id < m_max_shadows) ? shadow_map_id++ : 0;
+					light.color = m_active_lights[i]->color * m_active_lights[i]->intensity;
+					light.direction = glm::vec4(m_active_lights[i]->entity->transform->getWorldRotation(), 0.0f);
+					light.position = glm::vec4(m_active_lights[i]->entity->transform->getWorldPosition(), 0.0f);
+					light.range = m_active_lights[i]->range;
+					light.cut_off = m_active_lights[i]->cut_off;
+					light.outer_cut_off = m_active_lights[i]->outer_cut_off;
+					light.far_plane = m_active_lights[i]->far_plane;
+					light.matrix = (m_active_lights[i]->getLightType() != Components::Light::Type::Point) ? m_active_lights[i]->getProjectionMatrix() * m_active_lights[i]->getViewMatrix() : glm::mat4(1.0f);
 
-				// push to the list
-				scene_lights.push_back(light);
+					// push to the list
+					scene_lights.push_back(light);
+				}
 
 				// fill scene lights
 				glBufferData(GL_UNIFORM_BUFFER, scene_lights.size() * sizeof Light, &scene_lights[0], GL_DYNAMIC_DRAW);
@@ -437,21 +511,18 @@ namespace hawk
 		void Video::postProcess()
 		{
 			// disable graphics state
-			glDisable(GL_DEPTH_TEST);
-			glDisable(GL_STENCIL_TEST);
-			glDisable(GL_BLEND);
+			setDepthTest(false);
+			setStencilTest(false);
+			setBlend(false);
 
 			// configure cull face
-			glEnable(GL_CULL_FACE);
-			glCullFace(GL_BACK);
-			glFrontFace(GL_CCW);
+			setFaceCull(true);
+			setFaceSide(GL_BACK);
+			setFaceOrientation(GL_CCW);
 
 			// iterate cameras
-			for (auto camera : cameras)
+			for (auto camera : m_active_cameras)
 			{
-				// continue if camera is disabled
-				if (!camera->enable) continue;
-
 				// render screen quad
 				renderScreen(camera);
 
@@ -470,9 +541,9 @@ namespace hawk
 			}
 
 			// enable graphics state
-			glEnable(GL_DEPTH_TEST);
-			glEnable(GL_STENCIL_TEST);
-			glEnable(GL_BLEND);
+			setDepthTest(true);
+			setStencilTest(true);
+			setBlend(true);
 		}
 
 		void Video::clear(const glm::vec4& color, unsigned int bits)
@@ -484,314 +555,1682 @@ namespace hawk
 			glClear(bits);
 		}
 
-		void Video::draw(const hawk::Assets::Mesh* mesh, int instances)
+		void Video::draw(const hawk::Assets::Mesh* mesh, int instances, unsigned int first_instance)
 		{
 			// bind vertex array
-			glBindVertexArray(mesh->getVao());
+			bindVertexArray(mesh->getVao());
 
 			// if mesh does not have vertex indices
 			if (mesh->indices.size() == 0)
 			{
 				// draw using vertex buffer
 				if (instances == 0)
-					glDrawArrays(mesh->mode, 0, (int)mesh->vertices.size());
+					glDrawArrays(mesh->mode, (int)mesh->getBaseVertex(), (int)mesh->vertices.size());
 				else
-					glDrawArraysInstanced(mesh->mode, 0, (int)mesh->vertices.size(), instances);
+					glDrawArraysInstancedBaseInstance(mesh->mode, (int)mesh->getBaseVertex(), (int)mesh->vertices.size(), instances, first_instance);
 			}
 			else
 			{
+				// first element byte offset
+				const void* offset = reinterpret_cast<const void*>(static_cast<size_t>(mesh->getFirstIndex()) * sizeof(unsigned int));
+
 				// draw using index buffer
 				if (instances == 0)
-					glDrawElements(mesh->mode, (int)mesh->indices.size(), GL_UNSIGNED_INT, 0);
+					glDrawElementsBaseVertex(mesh->mode, (int)mesh->indices.size(), GL_UNSIGNED_INT, offset, (int)mesh->getBaseVertex());
 				else
-					glDrawElementsInstanced(mesh->mode, (int)mesh->indices.size(), GL_UNSIGNED_INT, 0, instances);
+					glDrawElementsInstancedBaseVertexBaseInstance(mesh->mode, (int)mesh->indices.size(), GL_UNSIGNED_INT, offset, instances, (int)mesh->getBaseVertex(), first_instance);
 			}
-
-			// unbind vertex array
-			glBindVertexArray(0);
 		}
 
-		Video::Rendering Video::getRendering() const
+		void Video::drawInstances(const hawk::Assets::Mesh* mesh, unsigned int instance_buffer, const std::vector<glm::uvec2>& runs)
 		{
-			return m_rendering;
-		}
+			// return if there is nothing to draw
+			if (runs.empty()) return;
 
-		Video::Lighting Video::getLighting() const
-		{
-			return m_lighting;
-		}
+			// bind vertex array
+			bindVertexArray(mesh->getVao());
 
-		unsigned int Video::getMaxLights() const
-		{
-			return m_max_lights;
-		}
+			// read model matrix rows per instance from binding 5
+			for (unsigned int i = 0; i < 4; ++i)
+			{
+				glVertexAttribFormat(5 + i, 4, GL_FLOAT, GL_FALSE, i * sizeof glm::vec4);
+				glVertexAttribBinding(5 + i, 5);
+				glEnableVertexAttribArray(5 + i);
+			}
 
-		unsigned int Video::getMaxShadows() const
-		{
-			return m_max_shadows;
-		}
+			glVertexBindingDivisor(5, 1);
+			glBindVertexBuffer(5, instance_buffer, 0, sizeof glm::mat4);
 
-		const GLFWvidmode* Video::getVideoMode()
-		{
-			return m_video_mode;
-		}
+			// if mesh does not have vertex indices
+			if (mesh->indices.size() == 0)
+			{
+				// draw each range, base instance offsets instance attributes
+				for (auto& run : runs)
+					glDrawArraysInstancedBaseInstance(mesh->mode, (int)mesh->getBaseVertex(), (int)mesh->vertices.size(), run.y, run.x);
+			}
+			else
+			{
+				// one command per range
+				m_instance_commands.clear();
 
-		const std::string& Video::getShadersMacros() const
-		{
-			return m_shaders_macros;
-		}
+				for (auto& run : runs)
+					m_instance_commands.push_back({ static_cast<unsigned int>(mesh->indices.size()), run.y, mesh->getFirstIndex(), (int)mesh->getBaseVertex(), run.x });
 
-		hawk::Components::Camera* Video::getRenderCamera() const
-		{
-			return m_render_camera;
-		}
+				// commands count
+				unsigned int count = static_cast<unsigned int>(m_instance_commands.size());
 
-		void Video::setColorMask(bool mask)
-		{
-			// if cached value is old
-			if (m_color_mask != mask)
-			{
-				// set new value
-				m_color_mask = mask;
+				// grow buffer when frame commands do not fit, old buffer is kept alive by driver until its draws are done
+				if (m_instance_commands_offset + count > m_instance_commands_capacity)
+				{
+					unsigned int capacity = std::max(std::max(m_instance_commands_capacity * 2, m_instance_commands_offset + count), 256u);
 
-				// set color mask
-				glColorMask(m_color_mask, m_color_mask, m_color_mask, m_color_mask);
+					releaseInstanceCommands();
+
+					m_instance_commands_capacity = capacity;
+
+					// make immutable buffer mapped for its lifetime
+					glGenBuffers(1, &m_instance_commands_buffer);
+					glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_instance_commands_buffer);
+					glBufferStorage(GL_DRAW_INDIRECT_BUFFER, COMMAND_REGIONS * capacity * sizeof(DrawCommand), nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+
+					m_instance_commands_mapping = static_cast<DrawCommand*>(glMapBufferRange(GL_DRAW_INDIRECT_BUFFER, 0, COMMAND_REGIONS * capacity * sizeof(DrawCommand), 
+						GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
+				}
+				else
+					glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_instance_commands_buffer);
+
+				// write commands after earlier commands of this frame and draw
+				size_t first = static_cast<size_t>(m_instance_commands_region) * m_instance_commands_capacity + m_instance_commands_offset;
+
+				std::memcpy(m_instance_commands_mapping + first, &m_instance_commands[0], count * sizeof(DrawCommand));
+
+				glMultiDrawElementsIndirect(mesh->mode, GL_UNSIGNED_INT, reinterpret_cast<const void*>(first * sizeof(DrawCommand)), (int)count, 0);
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+				m_instance_commands_offset += count;
 			}
+
+			// leave instance attributes disabled for shared vertex array
+			for (unsigned int i = 0; i < 4; ++i)
+				glDisableVertexAttribArray(5 + i);
+
+			glBindVertexBuffer(5, 0, 0, sizeof glm::mat4);
 		}
 
-		void Video::setDepthTest(bool test)
+		void Video::drawRanges(const hawk::Assets::Mesh* mesh, const std::vector<glm::uvec2>& ranges)
 		{
-			// if cached value is old
-			if (m_depth_test != test)
-			{
-				// set new value
-				m_depth_test = test;
+			// return if there is nothing to draw
+			if (ranges.empty()) return;
 
-				// set depth test
-				if (m_depth_test) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
+			// counts, byte offsets and base vertices of ranges
+			m_range_counts.clear();
+			m_range_offsets.clear();
+			m_range_base_vertices.assign(ranges.size(), (int)mesh->getBaseVertex());
+
+			for (auto& range : ranges)
+			{
+				m_range_counts.push_back(static_cast<int>(range.y));
+				m_range_offsets.push_back(reinterpret_cast<const void*>(static_cast<size_t>(mesh->getFirstIndex() + range.x) * sizeof(unsigned int)));
 			}
+
+			// bind vertex array
+			bindVertexArray(mesh->getVao());
+
+			// draw ranges
+			glMultiDrawElementsBaseVertex(mesh->mode, &m_range_counts[0], GL_UNSIGNED_INT, &m_range_offsets[0], (int)m_range_counts.size(), &m_range_base_vertices[0]);
 		}
 
-		void Video::setDepthFunction(unsigned int function)
+		void Video::bindVertexArray(unsigned int vao)
 		{
-			// if cached value is old
-			if (m_depth_func != function)
+			// return if already bound
+			if (m_bound_vao == vao)
 			{
-				// set new value
-				m_depth_func = function;
+				m_skipped_calls.vertex_arrays++;
 
-				// set depth function
-				glDepthFunc(m_depth_func);
+				return;
 			}
+
+			glBindVertexArray(vao);
+
+			m_bound_vao = vao;
 		}
 
-		void Video::setDepthMask(bool mask)
+		void Video::useProgram(unsigned int program)
 		{
-			// if cached value is old
-			if (m_depth_mask != mask)
+			// return if already used
+			if (m_bound_program == program)
 			{
-				// set new value
-				m_depth_mask = mask;
+				m_skipped_calls.programs++;
 
-				// set depth mask
-				glDepthMask(m_depth_mask);
+				return;
 			}
+
+			glUseProgram(program);
+
+			m_bound_program = program;
+
+			// samplers of another program are unknown
+			m_bound_material = nullptr;
 		}
 
-		void Video::setStencilTest(bool test)
+		void Video::bindMaterial(hawk::Assets::Material* material)
 		{
-			// if cached value is old
-			if (m_stencil_test != test)
-			{
-				// set new value
-				m_stencil_test = test;
+			// use shader program
+			useProgram(material->getShader()->getProgram());
 
-				// set stencil test
-				if (m_stencil_test) glEnable(GL_STENCIL_TEST); else glDisable(GL_STENCIL_TEST);
-			}
+			// return if last queued draw bound same textures for same material type
+			if (m_tracking && m_bound_material && (m_bound_material == material ||
+				(m_bound_material->getMaterialType() == material->getMaterialType() && m_bound_material->textures == material->textures))) return;
+
+			// set shader sampler values
+			material->setSamplers();
+
+			if (m_tracking) m_bound_material = material;
 		}
 
-		void Video::setStencilFunction(unsigned int function, int reference, unsigned int mask)
+		void Video::bindTexture(unsigned int unit, unsigned int texture)
 		{
-			// if cached value is old
-			if (m_stencil_func != function || m_stencil_func_ref != reference || m_stencil_func_mask != mask)
+			// return if already bound
+			if (unit < MAX_TEXTURE_UNITS && m_bound_textures[unit] == texture)
 			{
-				// set new value
-				m_stencil_func = function;
-				m_stencil_func_ref = reference;
-				m_stencil_func_mask = mask;
+				m_skipped_calls.textures++;
 
-				// set stencil function
-				glStencilFunc(m_stencil_func, m_stencil_func_ref, m_stencil_func_mask);
+				return;
 			}
+
+			// bind without touching active unit
+			glBindTextureUnit(unit, texture);
+
+			if (unit < MAX_TEXTURE_UNITS) m_bound_textures[unit] = texture;
 		}
 
-		void Video::setStencilOperation(unsigned int fail, unsigned int zfail, unsigned int zpass)
+		void Video::bindTextures(unsigned int first, unsigned int count, const unsigned int* textures)
 		{
-			// if cached value is old
-			if (m_stencil_op_fail != fail || m_stencil_op_zfail != zfail || m_stencil_op_zpass != zpass)
+			// changed units span
+			unsigned int low = count, high = 0;
+
+			for (unsigned int i = 0; i < count; ++i)
 			{
-				// set new value
-				m_stencil_op_fail = fail;
-				m_stencil_op_zfail = zfail;
-				m_stencil_op_zpass = zpass;
+				unsigned int unit = first + i;
 
-				// set stencil operation
-				glStencilOp(m_stencil_op_fail, m_stencil_op_zfail, m_stencil_op_zpass);
+				if (unit < MAX_TEXTURE_UNITS && m_bound_textures[unit] == textures[i]) continue;
+
+				if (low == count) low = i;
+
+				high = i;
+
+				if (unit < MAX_TEXTURE_UNITS) m_bound_textures[unit] = textures[i];
 			}
-		}
 
-		void Video::setStencilMask(unsigned int mask)
-		{
-			// if cached value is old
-			if (m_stencil_mask != mask)
+			// return if all are bound
+			if (low == count)
 			{
-				// set new value
-				m_stencil_mask = mask;
+				m_skipped_calls.textures += count;
 
-				// set stencil mask
-				glStencilMask(m_stencil_mask);
+				return;
 			}
+
+			// one call for changed span
+			glBindTextures(first + low, high - low + 1, textures + low);
+
+			m_skipped_calls.textures += count - (high - low + 1);
 		}
 
-		void Video::setBlend(bool blend)
+		void Video::bindFramebuffer(unsigned int framebuffer, unsigned int target)
 		{
-			// if cached value is old
-			if (m_blend != blend)
+			// bound frame buffers of target
+			bool draw = target != GL_READ_FRAMEBUFFER, read = target != GL_DRAW_FRAMEBUFFER;
+
+			// return if already bound
+			if ((!draw || m_bound_draw_framebuffer == framebuffer) && (!read || m_bound_read_framebuffer == framebuffer))
 			{
-				// set new value
-				m_blend = blend;
+				m_skipped_calls.framebuffers++;
 
-				// set color blend
-				if (m_blend) glEnable(GL_BLEND); else glDisable(GL_BLEND);
+				return;
 			}
+
+			glBindFramebuffer(target, framebuffer);
+
+			if (draw) m_bound_draw_framebuffer = framebuffer;
+			if (read) m_bound_read_framebuffer = framebuffer;
 		}
 
-		void Video::setBlendFunction(unsigned int src, unsigned int dst)
+		void Video::setViewport(int x, int y, int width, int height)
 		{
-			// if cached value is old
-			if (m_blend_src_factor != src || m_blend_dst_factor != dst)
+			glm::ivec4 viewport(x, y, width, height);
+
+			// return if unchanged
+			if (m_viewport == viewport)
 			{
-				// set new value
-				m_blend_src_factor = src;
-				m_blend_dst_factor = dst;
+				m_skipped_calls.viewports++;
 
-				// set blend function
-				glBlendFunc(m_blend_src_factor, m_blend_dst_factor);
+				return;
 			}
+
+			m_viewport = viewport;
+
+			glViewport(x, y, width, height);
 		}
 
-		void Video::setBlendEquation(unsigned int equation)
+		void Video::setPolygonMode(unsigned int mode)
 		{
 			// if cached value is old
-			if (m_blend_equation != equation)
+			if (m_polygon_mode != mode)
 			{
 				// set new value
-				m_blend_equation = equation;
+				m_polygon_mode = mode;
 
-				// set blend equation
-				glBlendEquation(m_blend_equation);
+				// set fill mode
+				glPolygonMode(GL_FRONT_AND_BACK, m_polygon_mode);
 			}
+			else
+				m_skipped_calls.states++;
 		}
 
-		void Video::setBlendColor(const glm::vec4& color)
+		void Video::resetBindings()
 		{
-			// if cached value is old
-			if (m_blend_color != color)
-			{
-				// set new value
-				m_blend_color = color;
+			m_bound_vao = UNKNOWN_BINDING;
+			m_bound_program = UNKNOWN_BINDING;
+			m_bound_material = nullptr;
+			m_bound_draw_framebuffer = UNKNOWN_BINDING;
+			m_bound_read_framebuffer = UNKNOWN_BINDING;
+			m_viewport = glm::ivec4(-1);
+
+			for (unsigned int i = 0; i < MAX_TEXTURE_UNITS; ++i)
+				m_bound_textures[i] = UNKNOWN_BINDING;
+		}
 
-				// set blend constant color
-				glBlendColor(m_blend_color.r, m_blend_color.g, m_blend_color.b, m_blend_color.a);
-			}
+		const Video::SkippedCalls& Video::getSkippedCalls() const
+		{
+			return m_skipped_calls;
 		}
 
-		void Video::setFaceCull(bool cull)
+		void Video::addCamera(hawk::Components::Camera* component)
 		{
-			// if cached value is old
-			if (m_face_cull != cull)
-			{
-				// set new value
-				m_face_cull = cull;
+			// return if already listed
+			if (component->m_video_slot >= 0) return;
 
-				// set face cull
-				if (m_face_cull) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
-			}
+			// add to cameras list
+			component->m_video_slot = static_cast<int>(cameras.size());
+
+			cameras.push_back(component);
 		}
 
-		void Video::setFaceSide(unsigned int side)
+		void Video::removeCamera(hawk::Components::Camera* component)
 		{
-			// if cached value is old
-			if (m_face_side != side)
-			{
-				// set new value
-				m_face_side = side;
+			// reset main camera
+			if (camera == component) camera = nullptr;
 
-				// set face side
-				glCullFace(m_face_side);
+			// reset depth pyramid camera
+			if (m_pyramid_camera == component) m_pyramid_camera = nullptr;
+
+			// return if not listed
+			if (component->m_video_slot < 0) return;
+
+			// drop detail levels kept for camera, shadows take finest level over cameras
+			for (auto renderer : renderers)
+			{
+				if (renderer->getTypeId() == hawk::Components::MeshRenderer::TYPE_ID)
+					static_cast<hawk::Components::MeshRenderer*>(renderer)->removeLod(component);
 			}
+
+			// move last camera to the free slot
+			hawk::Components::Camera* last = cameras.back();
+
+			cameras[component->m_video_slot] = last;
+			last->m_video_slot = component->m_video_slot;
+
+			cameras.pop_back();
+
+			// reset slot
+			component->m_video_slot = -1;
 		}
 
-		void Video::setFaceOrientation(unsigned int orientation)
+		void Video::addLight(hawk::Components::Light* component)
 		{
-			// if cached value is old
-			if (m_face_orientation != orientation)
-			{
-				// set new value
-				m_face_orientation = orientation;
+			// return if already listed
+			if (component->m_video_slot >= 0) return;
 
-				// set face orientation
-				glFrontFace(m_face_orientation);
-			}
+			// add to lights list
+			component->m_video_slot = static_cast<int>(lights.size());
+
+			lights.push_back(component);
 		}
 
-		void Video::renderForward()
+		void Video::removeLight(hawk::Components::Light* component)
 		{
-			// render lights for shadows
-			for (auto light : lights)
-			{
-				// continue if light is disabled or is not casting shadows
-				if (!light->enable || !light->cast_shadows) continue;
+			// return if not listed
+			if (component->m_video_slot < 0) return;
 
-				// bind light shadow map frame buffer
-				light->getShadowMapFramebuffer()->bind();
+			// move last light to the free slot
+			hawk::Components::Light* last = lights.back();
 
-				// clear frame buffer depth
-				light->getShadowMapFramebuffer()->clear(glm::vec4(0.0f), GL_DEPTH_BUFFER_BIT);
+			lights[component->m_video_slot] = last;
+			last->m_video_slot = component->m_video_slot;
 
-				// cull front faces for peter panning
-				setFaceSide(GL_FRONT);
+			lights.pop_back();
 
-				// render objects
-				for (auto i = renderers.begin(); i != renderers.end(); ++i)
-				{
-					// continue if mesh renderer is disabled or does not cast shadows or transparent
-					if (!(*i)->enable || !(*i)->cast_shadows || (*i)->materials[0]->getMaterialType() == hawk::Assets::Material::Type::Transparent) continue;
+			// reset slot
+			component->m_video_slot = -1;
+		}
 
-					// render for light shadow map
-					(*i)->render(light->getLightType() != Components::Light::Type::Point ? m_dsm_material : m_odsm_material, light);
-				}
+		void Video::addRenderer(hawk::Components::Renderer* component)
+		{
+			// return if already listed
+			if (component->m_video_slot >= 0) return;
+
+			// add to renderers list
+			component->m_video_slot = static_cast<int>(renderers.size());
+
+			renderers.push_back(component);
+		}
+
+		void Video::removeRenderer(hawk::Components::Renderer* component)
+		{
+			// return if not listed
+			if (component->m_video_slot < 0) return;
+
+			// move last renderer to the free slot
+			hawk::Components::Renderer* last = renderers.back();
+
+			renderers[component->m_video_slot] = last;
+			last->m_video_slot = component->m_video_slot;
+
+			renderers.pop_back();
+
+			// clear it from spatial index lists of last frame so queries never return it
+			if (component->m_tree_item >= 0)
+			{
+				size_t item = static_cast<size_t>(component->m_tree_item);
+
+				std::vector<hawk::Components::Renderer*>* lists[3] = { &m_static_renderers, &m_dynamic_renderers, &m_unbounded_renderers };
+
+				for (auto list : lists)
+					if (item < list->size() && (*list)[item] == component) (*list)[item] = nullptr;
+
+				component->m_tree_item = -1;
+			}
+
+			// reset slot
+			component->m_video_slot = -1;
+		}
+
+		const std::vector<hawk::Components::Camera*>& Video::getActiveCameras() const
+		{
+			return m_active_cameras;
+		}
+
+		const std::vector<hawk::Components::Light*>& Video::getActiveLights() const
+		{
+			return m_active_lights;
+		}
+
+		const std::vector<hawk::Components::Renderer*>& Video::getActiveRenderers() const
+		{
+			return m_active_renderers;
+		}
+
+		unsigned int Video::getCulledRenderers() const
+		{
+			return m_culled_renderers;
+		}
+
+		unsigned int Video::getDrawnRenderers() const
+		{
+			return m_drawn_renderers;
+		}
+
+		unsigned int Video::getOccludedRenderers() const
+		{
+			return m_occluded_renderers;
+		}
+
+		const hawk::Objects::OcclusionBuffer& Video::getOcclusionBuffer() const
+		{
+			return m_occlusion_buffer;
+		}
+
+		const hawk::Objects::GpuCuller& Video::getGpuCuller() const
+		{
+			return m_gpu_culler;
+		}
+
+		hawk::Objects::GeometryArena& Video::getGeometryArena()
+		{
+			return m_geometry_arena;
+		}
+
+		unsigned int Video::getCulledCasters() const
+		{
+			return m_culled_casters;
+		}
+
+		unsigned int Video::getDrawnCasters() const
+		{
+			return m_drawn_casters;
+		}
+
+		double Video::getCullingTime() const
+		{
+			return m_culling_time;
+		}
+
+		void Video::queryRenderers(const hawk::Helpers::Bounds::Frustum& frustum, std::vector<hawk::Components::Renderer*>& result)
+		{
+			// query trees
+			m_static_query.clear();
+			m_dynamic_query.clear();
+
+			m_static_tree.query(frustum, m_static_query);
+			m_dynamic_tree.query(frustum, m_dynamic_query);
+
+			gatherQuery(result);
+		}
+
+		void Video::queryRenderers(const hawk::Helpers::Bounds::Box& box, std::vector<hawk::Components::Renderer*>& result)
+		{
+			// query trees
+			m_static_query.clear();
+			m_dynamic_query.clear();
+
+			m_static_tree.query(box, m_static_query);
+			m_dynamic_tree.query(box, m_dynamic_query);
+
+			gatherQuery(result);
+		}
+
+		void Video::queryRenderers(const hawk::Helpers::Bounds::Sphere& sphere, std::vector<hawk::Components::Renderer*>& result)
+		{
+			// query trees
+			m_static_query.clear();
+			m_dynamic_query.clear();
+
+			m_static_tree.query(sphere, m_static_query);
+			m_dynamic_tree.query(sphere, m_dynamic_query);
+
+			gatherQuery(result);
+		}
+
+		const hawk::Objects::Bvh& Video::getStaticTree() const
+		{
+			return m_static_tree;
+		}
+
+		const std::vector<hawk::Components::Renderer*>& Video::getStaticRenderers() const
+		{
+			return m_static_renderers;
+		}
+
+		const hawk::Objects::Bvh& Video::getDynamicTree() const
+		{
+			return m_dynamic_tree;
+		}
+
+		const std::vector<hawk::Components::Renderer*>& Video::getDynamicRenderers() const
+		{
+			return m_dynamic_renderers;
+		}
+
+		Video::Rendering Video::getRendering() const
+		{
+			return m_rendering;
+		}
+
+		Video::Lighting Video::getLighting() const
+		{
+			return m_lighting;
+		}
+
+		unsigned int Video::getMaxLights() const
+		{
+			return m_max_lights;
+		}
+
+		unsigned int Video::getMaxShadows() const
+		{
+			return m_max_shadows;
+		}
+
+		const GLFWvidmode* Video::getVideoMode()
+		{
+			return m_video_mode;
+		}
+
+		const std::string& Video::getShadersMacros() const
+		{
+			return m_shaders_macros;
+		}
+
+		hawk::Components::Camera* Video::getRenderCamera() const
+		{
+			return m_render_camera;
+		}
+
+		void Video::setColorMask(bool mask)
+		{
+			// if cached value is old
+			if (m_color_mask != mask)
+			{
+				// set new value
+				m_color_mask = mask;
+
+				// set color mask
+				glColorMask(m_color_mask, m_color_mask, m_color_mask, m_color_mask);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setDepthTest(bool test)
+		{
+			// if cached value is old
+			if (m_depth_test != test)
+			{
+				// set new value
+				m_depth_test = test;
+
+				// set depth test
+				if (m_depth_test) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setDepthFunction(unsigned int function)
+		{
+			// if cached value is old
+			if (m_depth_func != function)
+			{
+				// set new value
+				m_depth_func = function;
+
+				// set depth function
+				glDepthFunc(m_depth_func);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setDepthMask(bool mask)
+		{
+			// if cached value is old
+			if (m_depth_mask != mask)
+			{
+				// set new value
+				m_depth_mask = mask;
+
+				// set depth mask
+				glDepthMask(m_depth_mask);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setStencilTest(bool test)
+		{
+			// if cached value is old
+			if (m_stencil_test != test)
+			{
+				// set new value
+				m_stencil_test = test;
+
+				// set stencil test
+				if (m_stencil_test) glEnable(GL_STENCIL_TEST); else glDisable(GL_STENCIL_TEST);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setStencilFunction(unsigned int function, int reference, unsigned int mask)
+		{
+			// if cached value is old
+			if (m_stencil_func != function || m_stencil_func_ref != reference || m_stencil_func_mask != mask)
+			{
+				// set new value
+				m_stencil_func = function;
+				m_stencil_func_ref = reference;
+				m_stencil_func_mask = mask;
+
+				// set stencil function
+				glStencilFunc(m_stencil_func, m_stencil_func_ref, m_stencil_func_mask);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setStencilOperation(unsigned int fail, unsigned int zfail, unsigned int zpass)
+		{
+			// if cached value is old
+			if (m_stencil_op_fail != fail || m_stencil_op_zfail != zfail || m_stencil_op_zpass != zpass)
+			{
+				// set new value
+				m_stencil_op_fail = fail;
+				m_stencil_op_zfail = zfail;
+				m_stencil_op_zpass = zpass;
+
+				// set stencil operation
+				glStencilOp(m_stencil_op_fail, m_stencil_op_zfail, m_stencil_op_zpass);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setStencilMask(unsigned int mask)
+		{
+			// if cached value is old
+			if (m_stencil_mask != mask)
+			{
+				// set new value
+				m_stencil_mask = mask;
+
+				// set stencil mask
+				glStencilMask(m_stencil_mask);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setBlend(bool blend)
+		{
+			// if cached value is old
+			if (m_blend != blend)
+			{
+				// set new value
+				m_blend = blend;
+
+				// set color blend
+				if (m_blend) glEnable(GL_BLEND); else glDisable(GL_BLEND);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setBlendFunction(unsigned int src, unsigned int dst)
+		{
+			// if cached value is old
+			if (m_blend_src_factor != src || m_blend_dst_factor != dst)
+			{
+				// set new value
+				m_blend_src_factor = src;
+				m_blend_dst_factor = dst;
+
+				// set blend function
+				glBlendFunc(m_blend_src_factor, m_blend_dst_factor);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setBlendEquation(unsigned int equation)
+		{
+			// if cached value is old
+			if (m_blend_equation != equation)
+			{
+				// set new value
+				m_blend_equation = equation;
+
+				// set blend equation
+				glBlendEquation(m_blend_equation);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setBlendColor(const glm::vec4& color)
+		{
+			// if cached value is old
+			if (m_blend_color != color)
+			{
+				// set new value
+				m_blend_color = color;
+
+				// set blend constant color
+				glBlendColor(m_blend_color.r, m_blend_color.g, m_blend_color.b, m_blend_color.a);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setFaceCull(bool cull)
+		{
+			// if cached value is old
+			if (m_face_cull != cull)
+			{
+				// set new value
+				m_face_cull = cull;
+
+				// set face cull
+				if (m_face_cull) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setFaceSide(unsigned int side)
+		{
+			// if cached value is old
+			if (m_face_side != side)
+			{
+				// set new value
+				m_face_side = side;
+
+				// set face side
+				glCullFace(m_face_side);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::setFaceOrientation(unsigned int orientation)
+		{
+			// if cached value is old
+			if (m_face_orientation != orientation)
+			{
+				// set new value
+				m_face_orientation = orientation;
+
+				// set face orientation
+				glFrontFace(m_face_orientation);
+			}
+			else
+				m_skipped_calls.states++;
+		}
+
+		void Video::gatherActive()
+		{
+			// clear last frame lists
+			m_active_cameras.clear();
+			m_active_lights.clear();
+			m_active_renderers.clear();
+
+			// enabled cameras
+			for (auto item : cameras)
+				if (item->enable && (!item->entity || item->entity->isActive())) m_active_cameras.push_back(item);
+
+			// enabled lights
+			for (auto item : lights)
+				if (item->enable && (!item->entity || item->entity->isActive())) m_active_lights.push_back(item);
+
+			// enabled renderers, static batches draw merged ones
+			for (auto item : renderers)
+			{
+				// merged renderer disabled while its batch still draws, batch is merged again without it
+				if (item->m_batch && (!item->enable || !item->entity->isActive()) && item->m_batch->entity->isActive())
+					item->removeFromStaticBatch();
+
+				if (item->enable && !item->m_batch && (!item->entity || item->entity->isActive())) m_active_renderers.push_back(item);
+			}
+
+			// update bounds and spatial index
+			updateSpatialIndex();
+
+			// split renderers drawn by indirect commands, upload moved draws
+			if (gpu_culling && m_rendering == Rendering::Deferred && m_gpu_culler.isReady())
+				m_gpu_culler.update(m_active_renderers, m_direct_renderers);
+			else
+				m_pyramid_camera = nullptr;
+
+			// camera frustums for shadow receivers
+			m_camera_frustums.clear();
+
+			for (auto item : m_active_cameras)
+				m_camera_frustums.push_back(hawk::Helpers::Bounds::frustum(item->getProjectionMatrix() * item->getViewMatrix()));
+
+			// reset skipped calls
+			hawk::Helpers::Memory::zeroize(&m_skipped_calls, sizeof m_skipped_calls);
+
+			// reset culling counts
+			m_culled_renderers = 0;
+			m_drawn_renderers = 0;
+			m_occluded_renderers = 0;
+			m_culled_casters = 0;
+			m_drawn_casters = 0;
+			m_culling_time = 0.0;
+		}
+
+		void Video::updateSpatialIndex()
+		{
+			// moved renderers
+			bool static_moved = false;
+			bool dynamic_moved = false;
+
+			// split active renderers by movement
+			m_static_scratch.clear();
+			m_dynamic_scratch.clear();
+			m_unbounded_renderers.clear();
+
+			m_casters_count = 0;
+
+			for (auto item : m_active_renderers)
+			{
+				// update world bounds of moved renderers
+				bool moved = item->calculateBounds();
+
+				// count shadow casters
+				if (isCaster(item)) m_casters_count++;
+
+				// list index stays valid when a list is kept as it is
+				if (!item->hasBounds())
+				{
+					item->m_tree_item = static_cast<int>(m_unbounded_renderers.size());
+
+					m_unbounded_renderers.push_back(item);
+				}
+				else if (item->entity && item->entity->isStatic())
+				{
+					item->m_tree_item = static_cast<int>(m_static_scratch.size());
+
+					m_static_scratch.push_back(item);
+
+					static_moved |= moved;
+				}
+				else
+				{
+					item->m_tree_item = static_cast<int>(m_dynamic_scratch.size());
+
+					m_dynamic_scratch.push_back(item);
+
+					dynamic_moved |= moved;
+				}
+			}
+
+			// rebuild static tree only when its renderers change
+			if (static_moved || m_static_scratch != m_static_renderers)
+			{
+				m_static_renderers.swap(m_static_scratch);
+				m_static_bounds.clear();
+
+				for (auto item : m_static_renderers)
+					m_static_bounds.push_back(item->getWorldBounds());
+
+				m_static_tree.build(m_static_bounds);
+
+				m_pvs_mapped = nullptr;
+			}
+
+			// map visible sets to static items when either changes
+			if (pvs != m_pvs_mapped) mapVisibleSet();
+
+			// rebuild dynamic tree when its renderers change, otherwise refit moved boxes
+			if (m_dynamic_scratch != m_dynamic_renderers)
+			{
+				m_dynamic_renderers.swap(m_dynamic_scratch);
+				m_dynamic_bounds.clear();
+
+				for (auto item : m_dynamic_renderers)
+					m_dynamic_bounds.push_back(item->getWorldBounds());
+
+				m_dynamic_tree.build(m_dynamic_bounds);
+			}
+			else if (dynamic_moved)
+			{
+				for (size_t i = 0; i < m_dynamic_renderers.size(); ++i)
+					m_dynamic_bounds[i] = m_dynamic_renderers[i]->getWorldBounds();
+
+				m_dynamic_tree.refit(m_dynamic_bounds);
+
+				// rebuild if refits made tree too loose
+				if (m_dynamic_tree.needsRebuild()) m_dynamic_tree.build(m_dynamic_bounds);
+			}
+		}
+
+		void Video::cullRenderers(const glm::mat4& view_projection)
+		{
+			// start time
+			auto start = std::chrono::high_resolution_clock::now();
+
+			// camera frustum
+			hawk::Helpers::Bounds::Frustum frustum = hawk::Helpers::Bounds::frustum(view_projection);
+
+			// camera cell of visible sets
+			int cell = (culling && pvs) ? pvs->getCell(m_render_camera->entity->transform->getWorldPosition()) : -1;
+
+			if (!culling)
+			{
+				// draw all
+				m_visible_renderers = m_active_renderers;
+			}
+			else if (cell >= 0)
+			{
+				// baked visible set
+				cullVisibleSet(cell, frustum);
+
+				gatherQuery(m_visible_renderers);
+			}
+			else if (spatial_index)
+			{
+				// hierarchical query
+				queryRenderers(frustum, m_visible_renderers);
+			}
+			else
+			{
+				// linear scan
+				m_visible_renderers.clear();
+
+				for (auto item : m_active_renderers)
+					if (isVisible(item, frustum)) m_visible_renderers.push_back(item);
+			}
+
+			// count frustum results
+			m_culled_renderers += static_cast<unsigned int>(m_active_renderers.size() - m_visible_renderers.size());
+
+			// reject renderers behind occluders
+			if (culling && occlusion) cullOccluded(view_projection);
+
+			// count drawn renderers
+			m_drawn_renderers += static_cast<unsigned int>(m_visible_renderers.size());
+
+			// add elapsed time
+			m_culling_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+
+		void Video::cullVisibleSet(int cell, const hawk::Helpers::Bounds::Frustum& frustum)
+		{
+			m_static_query.clear();
+			m_dynamic_query.clear();
+
+			// static renderers of cell set inside frustum
+			const unsigned long long* bits = pvs->getBits(cell);
+
+			for (unsigned int i = 0; i < pvs->getWordsCount(); ++i)
+			{
+				unsigned long long word = bits[i];
+
+				for (unsigned int j = 0; word; ++j, word >>= 1)
+				{
+					// continue if item is hidden
+					if (!(word & 1ull)) continue;
+
+					unsigned int item = i * 64 + j;
+
+					if (item < m_pvs_statics.size() && m_pvs_statics[item] != UINT_MAX && m_static_renderers[m_pvs_statics[item]] && isVisible(m_static_renderers[m_pvs_statics[item]], frustum))
+						m_static_query.push_back(m_pvs_statics[item]);
+				}
+			}
+
+			// static renderers added after bake
+			for (auto item : m_pvs_unbaked)
+				if (m_static_renderers[item] && isVisible(m_static_renderers[item], frustum)) m_static_query.push_back(item);
+
+			// moving renderers
+			m_dynamic_tree.query(frustum, m_dynamic_query);
+		}
+
+		void Video::mapVisibleSet()
+		{
+			m_pvs_mapped = pvs;
+
+			m_pvs_statics.clear();
+			m_pvs_unbaked.clear();
+
+			// return if there are no sets
+			if (!pvs) return;
+
+			m_pvs_statics.assign(pvs->getItemsCount(), UINT_MAX);
+
+			for (unsigned int i = 0; i < m_static_renderers.size(); ++i)
+			{
+				// continue if renderer was removed
+				if (!m_static_renderers[i]) continue;
+
+				int item = pvs->getItem(m_static_renderers[i]);
+
+				if (item >= 0)
+					m_pvs_statics[item] = i;
+				else
+					m_pvs_unbaked.push_back(i);
+			}
+		}
+
+		void Video::cullOccluded(const glm::mat4& view_projection)
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// camera position
+			glm::vec3 position = m_render_camera->entity->transform->getWorldPosition();
+
+			// score occluder candidates
+			m_occluders.clear();
+
+			for (size_t i = 0; i < m_visible_renderers.size(); ++i)
+			{
+				hawk::Components::Renderer* item = m_visible_renderers[i];
+
+				// continue if there is no single mesh to rasterize
+				if (!item->mesh || !item->hasBounds() || !item->entity || !item->entity->transform) continue;
+
+				if (item->getTypeId() == Components::MeshRenderer::TYPE_ID && !static_cast<Components::MeshRenderer*>(item)->instances.empty()) continue;
+
+				// continue if renderer can be seen through
+				if (item->materials.empty() || item->materials[0]->getMaterialType() == hawk::Assets::Material::Type::Transparent) continue;
+
+				// marked occluders first
+				if (item->occluder)
+				{
+					m_occluders.push_back(std::make_pair(std::numeric_limits<float>::max(), i));
+
+					continue;
+				}
+
+				// static renderers large on screen
+				if (!item->entity->isStatic()) continue;
+
+				const hawk::Helpers::Bounds::Sphere& sphere = item->getWorldSphere();
+
+				float score = sphere.radius / std::fmax(glm::length(sphere.center - position), m_render_camera->near_plane);
+
+				if (score > 0.1f) m_occluders.push_back(std::make_pair(score, i));
+			}
+
+			// return if nothing occludes
+			if (m_occluders.empty()) return;
+
+			// keep largest occluders
+			size_t count = std::min(m_occluders.size(), static_cast<size_t>(max_occluders));
+
+			std::partial_sort(m_occluders.begin(), m_occluders.begin() + count, m_occluders.end(),
+				[](const std::pair<float, size_t>& a, const std::pair<float, size_t>& b) { return a.first > b.first; });
+
+			// rasterize occluders
+			size_t size = m_visible_renderers.size();
+
+			m_occlusion_buffer.begin(view_projection);
+			m_occlusion_results.assign(size, 1);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				hawk::Components::Renderer* item = m_visible_renderers[m_occluders[i].second];
+
+				m_occlusion_buffer.addOccluder(item->mesh, item->entity->transform->getModelMatrix());
+
+				// occluders are kept, their own depth would hide them
+				m_occlusion_results[m_occluders[i].second] = 2;
+			}
+
+			m_occlusion_buffer.rasterize();
+
+			// test visible renderers on workers
+
+			for (size_t first = 0; first < size; first += 64)
+			{
+				size_t last = std::min(first + 64, size);
+
+				app.workers.push([this, first, last]()
+				{
+					for (size_t i = first; i < last; ++i)
+					{
+						if (m_occlusion_results[i] == 1 && m_visible_renderers[i]->hasBounds())
+							m_occlusion_results[i] = m_occlusion_buffer.isVisible(m_visible_renderers[i]->getWorldBounds()) ? 1 : 0;
+					}
+				});
+			}
+
+			app.workers.wait();
+
+			// remove occluded renderers
+			size_t visible = 0;
+
+			for (size_t i = 0; i < size; ++i)
+				if (m_occlusion_results[i]) m_visible_renderers[visible++] = m_visible_renderers[i];
+
+			m_occluded_renderers += static_cast<unsigned int>(size - visible);
+
+			m_visible_renderers.resize(visible);
+		}
+
+		void Video::cullIndirect(const glm::mat4& view_projection)
+		{
+			// start time
+			auto start = std::chrono::high_resolution_clock::now();
+
+			// camera frustum
+			hawk::Helpers::Bounds::Frustum frustum = hawk::Helpers::Bounds::frustum(view_projection);
+
+			// write visible draw commands, depth pyramid is only valid for the camera it was built from
+			m_gpu_culler.cull(view_projection, culling && m_render_camera == m_pyramid_camera);
+
+			// cull renderers not drawn by indirect commands
+			m_visible_renderers.clear();
+
+			for (auto item : m_direct_renderers)
+				if (!culling || isVisible(item, frustum)) m_visible_renderers.push_back(item);
+
+			// count direct renderers, indirect results stay on graphics device
+			m_culled_renderers += static_cast<unsigned int>(m_direct_renderers.size() - m_visible_renderers.size());
+			m_drawn_renderers += static_cast<unsigned int>(m_visible_renderers.size());
+
+			// add elapsed time
+			m_culling_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+
+		void Video::cullCasters(const hawk::Components::Light* light)
+		{
+			// start time
+			auto start = std::chrono::high_resolution_clock::now();
+
+			// light matrices
+			glm::mat4 view = light->getViewMatrix();
+			glm::mat4 projection = light->getProjectionMatrix();
+
+			// light position and direction
+			glm::vec3 position = light->entity->transform->getWorldPosition();
+			glm::vec3 direction = -glm::vec3(view[0][2], view[1][2], view[2][2]);
+
+			// point lights render a cube around them, other lights render their projection volume
+			bool point = light->getLightType() == hawk::Components::Light::Type::Point;
+
+			hawk::Helpers::Bounds::Sphere sphere = { position, light->far_plane };
+			hawk::Helpers::Bounds::Frustum frustum = hawk::Helpers::Bounds::frustum(projection * view);
+
+			// renderers inside light volume
+			if (!culling)
+				m_shadow_casters = m_active_renderers;
+			else if (spatial_index)
+			{
+				if (point)
+					queryRenderers(sphere, m_shadow_casters);
+				else
+					queryRenderers(frustum, m_shadow_casters);
+			}
+			else
+			{
+				m_shadow_casters.clear();
+
+				for (auto item : m_active_renderers)
+				{
+					if (!item->hasBounds() || (point ? hawk::Helpers::Bounds::intersects(sphere, item->getWorldBounds()) : hawk::Helpers::Bounds::intersects(frustum, item->getWorldBounds())))
+						m_shadow_casters.push_back(item);
+				}
+			}
+
+			// keep casters whose shadow can land inside a camera frustum
+			size_t count = 0;
+
+			for (auto item : m_shadow_casters)
+			{
+				// continue if renderer does not cast shadows or transparent
+				if (!isCaster(item)) continue;
+
+				// test shadow volume against cameras
+				if (culling && item->hasBounds())
+				{
+					// caster box
+					const hawk::Helpers::Bounds::Box& box = item->getWorldBounds();
+
+					// box swept along shadow
+					hawk::Helpers::Bounds::Box swept = box;
+
+					// continue if no camera sees the shadow
+					bool seen = false;
+
+					if (light->getLightType() == hawk::Components::Light::Type::Directional)
+					{
+						// parallel rays sweep whole box along light direction
+						float shadow_length = light->far_plane - light->near_plane;
+
+						hawk::Helpers::Bounds::expand(swept, { box.min + direction * shadow_length, box.max + direction * shadow_length });
+					}
+					else
+					{
+						// axis from light to box center
+						glm::vec3 axis = (box.min + box.max) * 0.5f - position;
+						float axis_length = glm::length(axis);
+
+						// light inside box casts everywhere
+						seen = axis_length <= 0.0f || (glm::clamp(position, box.min, box.max) == position);
+
+						if (!seen) axis /= axis_length;
+
+						// corners sweep along their own rays up to far plane across axis, which encloses light range inside shadow cone
+						for (int i = 0; i < 8 && !seen; ++i)
+						{
+							glm::vec3 corner((i & 1) ? box.max.x : box.min.x, (i & 2) ? box.max.y : box.min.y, (i & 4) ? box.max.z : box.min.z);
+							glm::vec3 ray = corner - position;
+
+							float depth = glm::dot(ray, axis);
+
+							// light near box puts corners beside or behind it, shadow spreads too wide to bound
+							if (depth <= light->near_plane)
+								seen = true;
+							else if (depth < light->far_plane)
+								hawk::Helpers::Bounds::expand(swept, position + ray * (light->far_plane / depth));
+						}
+					}
+
+					for (size_t i = 0; i < m_camera_frustums.size() && !seen; ++i)
+					{
+						if (hawk::Helpers::Bounds::intersects(m_camera_frustums[i], swept)) seen = true;
+					}
+
+					if (!seen) continue;
+				}
+
+				m_shadow_casters[count++] = item;
+			}
+
+			m_shadow_casters.resize(count);
+
+			// count results
+			m_drawn_casters += static_cast<unsigned int>(count);
+			m_culled_casters += m_casters_count - static_cast<unsigned int>(count);
+
+			// add elapsed time
+			m_culling_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+
+		bool Video::isCaster(const hawk::Components::Renderer* renderer) const
+		{
+			return renderer->cast_shadows && !renderer->materials.empty() && renderer->materials[0]->getMaterialType() != hawk::Assets::Material::Type::Transparent;
+		}
+
+		bool Video::isVisible(const hawk::Components::Renderer* renderer, const hawk::Helpers::Bounds::Frustum& frustum) const
+		{
+			// visible if bounds are unknown
+			return !renderer->hasBounds() ||
+				(hawk::Helpers::Bounds::intersects(frustum, renderer->getWorldSphere()) && hawk::Helpers::Bounds::intersects(frustum, renderer->getWorldBounds()));
+		}
+
+		void Video::gatherQuery(std::vector<hawk::Components::Renderer*>& result) const
+		{
+			// map tree items to renderers, skip renderers removed since last spatial index update
+			result.clear();
+
+			for (auto item : m_static_query)
+				if (m_static_renderers[item]) result.push_back(m_static_renderers[item]);
+
+			for (auto item : m_dynamic_query)
+				if (m_dynamic_renderers[item]) result.push_back(m_dynamic_renderers[item]);
+
+			// renderers without bounds are always included
+			for (auto item : m_unbounded_renderers)
+				if (item) result.push_back(item);
+		}
+
+		void Video::fillQueue()
+		{
+			m_render_queue.clear();
+
+			// camera position and depth scale
+			glm::vec3 position = m_render_camera->entity->transform->getWorldPosition();
+
+			float far_inverse = m_render_camera->far_plane > 0.0f ? 1.0f / m_render_camera->far_plane : 0.0f;
+
+			for (auto renderer : m_visible_renderers)
+			{
+				// continue if mesh renderer only draws shadows
+				if (renderer->shadows == Components::Renderer::Shadows::OnlyShadows) continue;
+
+				// first material decides pass and binds
+				const hawk::Assets::Material* material = renderer->materials[0];
+
+				hawk::Assets::Material::Type type = material->getMaterialType();
+
+				// distance to camera, renderers without bounds sort nearest
+				float depth = renderer->hasBounds() ? glm::length(renderer->getWorldSphere().center - position) * far_inverse : 0.0f;
+
+				// transparent renderers blend back-to-front, others are grouped by state then drawn front-to-back
+				bool blended = type == hawk::Assets::Material::Type::Transparent;
+
+				unsigned long long key = hawk::Objects::RenderQueue::makeKey(static_cast<unsigned int>(type), material->getShader()->getProgram(),
+					getTexturesId(material), getMeshId(renderer->mesh), depth, blended, blended);
+
+				m_render_queue.push(key, renderer);
+			}
+
+			m_render_queue.sort();
+		}
+
+		void Video::batchQueue()
+		{
+			const std::vector<hawk::Objects::RenderQueue::Item>& items = m_render_queue.getItems();
+
+			m_batches.clear();
+			m_batch_transforms.clear();
+			m_batch_commands.clear();
+			m_item_batches.assign(items.size(), -1);
+
+			// return if batching is disabled
+			if (!instancing) return;
+
+			for (size_t i = 0; i < items.size();)
+			{
+				// run of compatible neighbours
+				size_t end = i + 1;
+
+				if (isBatchable(items[i].renderer))
+				{
+					while (end < items.size() && isBatchable(items[end].renderer) && isBatchable(items[i].renderer, items[end].renderer))
+						++end;
+				}
+
+				// single renderers draw as before
+				if (end - i < 2)
+				{
+					i = end;
+
+					continue;
+				}
+
+				Batch batch = { static_cast<unsigned int>(i), static_cast<unsigned int>(end - i), static_cast<unsigned int>(m_batch_transforms.size()), 
+					static_cast<unsigned int>(m_batch_commands.size()), 0 };
+
+				for (size_t j = i; j < end; ++j)
+				{
+					const hawk::Components::Renderer* renderer = items[j].renderer;
+
+					// matrices cached with world bounds
+					if (renderer->hasBounds())
+						m_batch_transforms.push_back({ renderer->getWorldMatrix(), renderer->getNormalMatrix() });
+					else
+					{
+						glm::mat4 model = renderer->entity->transform->getModelMatrix();
+
+						m_batch_transforms.push_back({ model, glm::transpose(glm::inverse(model)) });
+					}
+
+					m_item_batches[j] = static_cast<int>(m_batches.size());
+				}
+
+				// one command per run of same mesh if batch holds more than one mesh
+				bool single = true;
+
+				for (size_t j = i + 1; j < end && single; ++j)
+					single = items[j].renderer->mesh == items[i].renderer->mesh;
+
+				if (!single)
+				{
+					for (size_t j = i; j < end; ++j)
+					{
+						const hawk::Assets::Mesh* mesh = items[j].renderer->mesh;
+
+						if (j > i && mesh == items[j - 1].renderer->mesh)
+						{
+							m_batch_commands.back().instance_count++;
+
+							continue;
+						}
+
+						m_batch_commands.push_back({ static_cast<unsigned int>(mesh->indices.size()), 1, mesh->getFirstIndex(), (int)mesh->getBaseVertex(), 
+							batch.base + static_cast<unsigned int>(j - i) });
+					}
+
+					batch.commands_count = static_cast<unsigned int>(m_batch_commands.size()) - batch.command;
+				}
+
+				m_batches.push_back(batch);
+
+				i = end;
+			}
+
+			// return if there is nothing to upload
+			if (m_batch_transforms.empty()) return;
+
+			// make buffer on first use
+			if (!m_batch_buffer) glGenBuffers(1, &m_batch_buffer);
+
+			// refill buffer, orphans storage of earlier camera
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_batch_buffer);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, m_batch_transforms.size() * sizeof(BatchTransform), &m_batch_transforms[0], GL_STREAM_DRAW);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+			// return if every batch draws one mesh
+			if (m_batch_commands.empty()) return;
+
+			// make commands buffer on first use
+			if (!m_batch_commands_buffer) glGenBuffers(1, &m_batch_commands_buffer);
+
+			// refill commands
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_batch_commands_buffer);
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, m_batch_commands.size() * sizeof(DrawCommand), &m_batch_commands[0], GL_STREAM_DRAW);
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		}
+
+		void Video::advanceInstanceCommands()
+		{
+			// return if commands buffer is not made
+			if (!m_instance_commands_buffer) return;
+
+			// fence draws of current region
+			if (m_instance_commands_fences[m_instance_commands_region]) glDeleteSync(m_instance_commands_fences[m_instance_commands_region]);
+
+			m_instance_commands_fences[m_instance_commands_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+			// move to next region and wait until its draws are done
+			m_instance_commands_region = (m_instance_commands_region + 1) % COMMAND_REGIONS;
+			m_instance_commands_offset = 0;
+
+			if (m_instance_commands_fences[m_instance_commands_region])
+			{
+				while (glClientWaitSync(m_instance_commands_fences[m_instance_commands_region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+
+				glDeleteSync(m_instance_commands_fences[m_instance_commands_region]);
+
+				m_instance_commands_fences[m_instance_commands_region] = nullptr;
+			}
+		}
+
+		void Video::releaseInstanceCommands()
+		{
+			// free fences
+			for (unsigned int i = 0; i < COMMAND_REGIONS; ++i)
+			{
+				if (m_instance_commands_fences[i])
+				{
+					glDeleteSync(m_instance_commands_fences[i]);
+
+					m_instance_commands_fences[i] = nullptr;
+				}
+			}
+
+			// free buffer, deleting unmaps it
+			if (m_instance_commands_buffer)
+			{
+				glDeleteBuffers(1, &m_instance_commands_buffer);
+
+				m_instance_commands_buffer = 0;
+			}
+
+			m_instance_commands_mapping = nullptr;
+			m_instance_commands_capacity = 0;
+			m_instance_commands_offset = 0;
+		}
+
+		void Video::renderQueue(size_t first, size_t last)
+		{
+			const std::vector<hawk::Objects::RenderQueue::Item>& items = m_render_queue.getItems();
+
+			// render objects
+			trackBindings(true);
+
+			for (size_t i = first; i < last;)
+			{
+				int batch = m_item_batches[i];
+
+				if (batch < 0)
+				{
+					items[i].renderer->render();
+
+					++i;
+				}
+				else
+				{
+					renderBatch(static_cast<unsigned int>(batch));
+
+					i += m_batches[batch].count;
+				}
+			}
+
+			trackBindings(false);
+		}
+
+		void Video::renderBatch(unsigned int batch)
+		{
+			const Batch& item = m_batches[batch];
+
+			// batch renderers share these
+			const hawk::Components::Renderer* renderer = m_render_queue.getItems()[item.first].renderer;
+
+			hawk::Assets::Material* material = renderer->materials[0];
+
+			// set renderer properties
+			material->setInt("renderer.shadows", (int)renderer->shadows);
+
+			// use material and its samplers unless last queued draw bound them
+			bindMaterial(material);
+
+			// set material render states
+			material->setStates();
+
+			// set shader uniform values
+			material->setUniforms();
+
+			// read transforms from draws buffer
+			material->getShader()->setBool("indirect", 1);
+
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_batch_buffer);
+
+			// set fill mode
+			setPolygonMode(renderer->mode);
+
+			// draw all instances, meshes of arena with one call
+			if (item.commands_count)
+			{
+				bindVertexArray(renderer->mesh->getVao());
+
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_batch_commands_buffer);
+				glMultiDrawElementsIndirect(renderer->mesh->mode, GL_UNSIGNED_INT, (void*)(item.command * sizeof(DrawCommand)), (int)item.commands_count, 0);
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+			}
+			else
+			{
+				draw(renderer->mesh, static_cast<int>(item.count), item.base);
+			}
+
+			// read transforms from uniforms again
+			material->getShader()->setBool("indirect", 0);
+		}
+
+		bool Video::isBatchable(const hawk::Components::Renderer* renderer)
+		{
+			// return if renderer is not a mesh renderer
+			if (renderer->getTypeId() != Components::MeshRenderer::TYPE_ID) return false;
+
+			const Components::MeshRenderer* mesh_renderer = static_cast<const Components::MeshRenderer*>(renderer);
+
+			// instanced renderers, render callbacks, detail levels and meshlets need their own draws
+			if (!mesh_renderer->instances.empty() || mesh_renderer->onRender) return false;
+
+			if (!renderer->entity || !renderer->mesh || !renderer->mesh->lods.empty() || !renderer->mesh->meshlets.empty()) return false;
+
+			// one material reading draws buffer
+			return renderer->materials.size() == 1 && renderer->materials[0]->getShader()->isIndirect();
+		}
+
+		bool Video::isBatchable(const hawk::Components::Renderer* a, const hawk::Components::Renderer* b)
+		{
+			// states
+			if (a->materials[0] != b->materials[0] || a->shadows != b->shadows || a->mode != b->mode) return false;
+
+			// same mesh, or indexed meshes of geometry arena drawn by one multi draw
+			return a->mesh == b->mesh || (a->mesh->isInArena() && b->mesh->isInArena() && a->mesh->mode == b->mesh->mode && !a->mesh->indices.empty() && !b->mesh->indices.empty());
+		}
+
+		void Video::sortCasters()
+		{
+			m_caster_queue.clear();
+
+			// casters share light material, so only meshes change
+			for (auto renderer : m_shadow_casters)
+				m_caster_queue.push(hawk::Objects::RenderQueue::makeKey(0, 0, 0, getMeshId(renderer->mesh), 0.0f), renderer);
+
+			m_caster_queue.sort();
+
+			for (size_t i = 0; i < m_shadow_casters.size(); ++i)
+				m_shadow_casters[i] = m_caster_queue.getItems()[i].renderer;
+		}
+
+		void Video::trackBindings(bool track)
+		{
+			m_tracking = track;
+
+			// samplers may be bound by other passes in between
+			m_bound_material = nullptr;
+
+			// restore default states once per queue instead of after every draw
+			if (!track) reset();
+		}
+
+		unsigned int Video::getTexturesId(const hawk::Assets::Material* material)
+		{
+			// hash of texture names
+			unsigned int id = 2166136261u;
+
+			for (auto texture : material->textures)
+				id = (id ^ texture->getTexture()) * 16777619u;
+
+			return id ^ (id >> hawk::Objects::RenderQueue::TEXTURES_BITS);
+		}
+
+		unsigned int Video::getMeshId(const hawk::Assets::Mesh* mesh)
+		{
+			// allocations are aligned, low address bits carry nothing
+			return static_cast<unsigned int>(reinterpret_cast<size_t>(mesh) >> 4);
+		}
+
+		void Video::renderForward()
+		{
+			// render lights for shadows
+			for (auto light : m_active_lights)
+			{
+				// continue if light is not casting shadows
+				if (!light->cast_shadows) continue;
+
+				// bind light shadow map frame buffer
+				light->getShadowMapFramebuffer()->bind();
+
+				// clear frame buffer depth
+				light->getShadowMapFramebuffer()->clear(glm::vec4(0.0f), GL_DEPTH_BUFFER_BIT);
+
+				// cull front faces for peter panning
+				setFaceSide(GL_FRONT);
+
+				// cull casters against light volume and camera frustums
+				cullCasters(light);
+
+				// group casters by mesh
+				sortCasters();
+
+				// render objects
+				trackBindings(true);
+
+				for (auto i = m_shadow_casters.begin(); i != m_shadow_casters.end(); ++i)
+				{
+					// render for light shadow map
+					(*i)->render(light->getLightType() != Components::Light::Type::Point ? m_dsm_material : m_odsm_material, light);
+				}
+
+				trackBindings(false);
 
 				// reset face culling
 				setFaceSide(GL_BACK);
 
 				// unbind light shadow map frame buffer
-				glBindFramebuffer(GL_FRAMEBUFFER, 0);
+				bindFramebuffer(0);
 			}
 
 			// render scene per camera
-			for (auto camera : cameras)
+			for (auto camera : m_active_cameras)
 			{
-				// continue if camera is disabled
-				if (!camera->enable) continue;
-
 				// set render camera
 				m_render_camera = camera;
 
 				// fill camera ubo
 				m_render_camera->fillCameraBuffer(m_camera_ubo);
 
+				// cull renderers against camera frustum and occluders
+				cullRenderers(m_render_camera->getProjectionMatrix() * m_render_camera->getViewMatrix());
+
 				// pre-render scene
 				m_render_camera->preRender();
 
@@ -818,30 +2257,14 @@ namespace hawk
 					setFaceSide(GL_BACK);
 				}
 
-				// transparent objects
-				std::vector<Components::Renderer*> transparent_objects;
+				// sort renderers by state, transparent objects come last back-to-front
+				fillQueue();
 
-				// render objects
-				for (auto i = renderers.begin(); i != renderers.end(); ++i)
-				{
-					// continue if mesh renderer is disabled or only draws shadows
-					if (!(*i)->enable || (*i)->shadows == Components::Renderer::Shadows::OnlyShadows) continue;
-
-					// render if material is not transparent
-					if ((*i)->materials[0]->getMaterialType() != hawk::Assets::Material::Type::Transparent)
-					{
-						(*i)->render();
-					}
-					else
-					{
-						// add to transparent objects list
-						transparent_objects.push_back((*i));
-					}
-				}
+				// group renderers sharing mesh and material
+				batchQueue();
 
-				// render transparent objects back-to-front
-				for (auto i = transparent_objects.rbegin(); i != transparent_objects.rend(); ++i)
-					(*i)->render();
+				// render objects
+				renderQueue(0, m_render_queue.getItems().size());
 
 				// post-render scene
 				m_render_camera->postRender();
@@ -854,10 +2277,10 @@ namespace hawk
 			System::Core& app = System::Core::getInstance();
 
 			// render lights for shadows
-			for (auto light : lights)
+			for (auto light : m_active_lights)
 			{
-				// continue if light is disabled or is not casting shadows
-				if (!light->enable || !light->cast_shadows) continue;
+				// continue if light is not casting shadows
+				if (!light->cast_shadows) continue;
 
 				// bind light shadow map frame buffer
 				light->getShadowMapFramebuffer()->bind();
@@ -868,72 +2291,88 @@ namespace hawk
 				// cull front faces
 				setFaceSide(GL_FRONT);
 
+				// cull casters against light volume and camera frustums
+				cullCasters(light);
+
+				// group casters by mesh
+				sortCasters();
+
 				// render objects
-				for (auto i = renderers.begin(); i != renderers.end(); ++i)
-				{
-					// continue if mesh renderer is disabled or does not cast shadows or transparent
-					if (!(*i)->enable || !(*i)->cast_shadows || (*i)->materials[0]->getMaterialType() == hawk::Assets::Material::Type::Transparent) continue;
+				trackBindings(true);
 
+				for (auto i = m_shadow_casters.begin(); i != m_shadow_casters.end(); ++i)
+				{
 					// render for light shadow map
 					(*i)->render(light->getLightType() != Components::Light::Type::Point ? m_dsm_material : m_odsm_material, light);
 				}
 
+				trackBindings(false);
+
 				// reset face culling
 				setFaceSide(GL_BACK);
 
 				// unbind light shadow map frame buffer
-				glBindFramebuffer(GL_FRAMEBUFFER, 0);
+				bindFramebuffer(0);
 			}
 
 			// render scene per camera
-			for (auto camera : cameras)
+			for (auto camera : m_active_cameras)
 			{
-				// continue if camera is disabled
-				if (!camera->enable) continue;
-
 				// set render camera
 				m_render_camera = camera;
 
 				// fill camera ubo
 				m_render_camera->fillCameraBuffer(m_camera_ubo);
 
+				// camera view projection matrix
+				glm::mat4 view_projection = m_render_camera->getProjectionMatrix() * m_render_camera->getViewMatrix();
+
+				// draw lit renderers by indirect commands
+				bool indirect = gpu_culling && m_gpu_culler.isReady();
+
+				// cull renderers against camera frustum and occluders
+				if (indirect)
+					cullIndirect(view_projection);
+				else
+					cullRenderers(view_projection);
+
 				// disable color blend to prevent g-buffer alteration
 				setBlend(false);
 
 				// pre-render scene
 				m_render_camera->preRender();
 
-				// unlit objects
-				std::vector<Components::Renderer*> unlit_objects;
+				// render culled indirect draws
+				if (indirect) m_gpu_culler.draw();
 
-				// transparent objects
-				std::vector<Components::Renderer*> transparent_objects;
-				
-				// render objects
-				for (auto i = renderers.begin(); i != renderers.end(); ++i)
+				// sort renderers by state, lit objects come first then unlit and transparent ones
+				fillQueue();
+
+				// group renderers sharing mesh and material
+				batchQueue();
+
+				const std::vector<hawk::Objects::RenderQueue::Item>& items = m_render_queue.getItems();
+
+				// first lit item and first forward rendered item, renderers without material type are skipped
+				size_t lit = 0, forward = 0;
+
+				while (lit < items.size() && items[lit].renderer->materials[0]->getMaterialType() == hawk::Assets::Material::Type::None)
+					++lit;
+
+				forward = lit;
+
+				while (forward < items.size() && items[forward].renderer->materials[0]->getMaterialType() == hawk::Assets::Material::Type::Lit)
+					++forward;
+
+				// render lit objects, other material types are post-poned for forward rendering
+				renderQueue(lit, forward);
+
+				// build depth pyramid of first camera for next frame culling
+				if (indirect && m_render_camera == m_active_cameras.front())
 				{
-					// continue if mesh renderer is disabled or only draws shadows
-					if (!(*i)->enable || (*i)->shadows == Components::Renderer::Shadows::OnlyShadows) continue;
+					m_gpu_culler.buildPyramid(m_render_camera->getDeferredFramebuffer(), view_projection);
 
-					// render if material is lit
-					if ((*i)->materials[0]->getMaterialType() == hawk::Assets::Material::Type::Lit)
-					{
-						(*i)->render();
-					}
-					else
-					{
-						// post-pone other material types for forward rendering
-						if ((*i)->materials[0]->getMaterialType() == hawk::Assets::Material::Type::Unlit)
-						{
-							// add to unlit objects list
-							unlit_objects.push_back((*i));
-						}
-						else if ((*i)->materials[0]->getMaterialType() == hawk::Assets::Material::Type::Transparent)
-						{
-							// add to transparent objects list
-							transparent_objects.push_back((*i));
-						}
-					}
+					m_pyramid_camera = m_render_camera;
 				}
 
 				// disable graphics state
@@ -989,7 +2428,7 @@ namespace hawk
 				}
 
 				// bind lights shadow maps
-				if (!lights.empty())
+				if (!m_active_lights.empty())
 				{
 					// shadow map id holder
 					unsigned int shadow_map_id = 0;
@@ -1007,13 +2446,10 @@ namespace hawk
 					for (unsigned int i = 0; i < m_max_lights; ++i)
 					{
 						// continue if light is out of active lights range
-						if (i + 1 > lights.size()) break;
-
-						// continue if light is disabled
-						if (!lights[i]->enable) continue;
+						if (i + 1 > m_active_lights.size()) break;
 
 						// if light has shadows
-						if (lights[i]->cast_shadows && shadow_map_id < m_max_shadows)
+						if (m_active_lights[i]->cast_shadows && shadow_map_id < m_max_shadows)
 						{
 							// directional shadow map sample index
 							dsm_sampler_index = shadow_map_counter++;
@@ -1025,16 +2461,16 @@ namespace hawk
 							shadow_map_id++;
 
 							// bind shadow map texture
-							switch (lights[i]->getLightType())
+							switch (m_active_lights[i]->getLightType())
 							{
 							case Components::Light::Type::Directional:
-								lights[i]->getShadowMapFramebuffer()->bindDepthStencilTexture(dsm_sampler_index);
+								m_active_lights[i]->getShadowMapFramebuffer()->bindDepthStencilTexture(dsm_sampler_index);
 								break;
 							case Components::Light::Type::Point:
-								lights[i]->getShadowMapFramebuffer()->bindDepthStencilTexture(odsm_sampler_index);
+								m_active_lights[i]->getShadowMapFramebuffer()->bindDepthStencilTexture(odsm_sampler_index);
 								break;
 							case Components::Light::Type::Spot:
-								lights[i]->getShadowMapFramebuffer()->bindDepthStencilTexture(dsm_sampler_index);
+								m_active_lights[i]->getShadowMapFramebuffer()->bindDepthStencilTexture(dsm_sampler_index);
 								break;
 							}
 						}
@@ -1090,13 +2526,8 @@ namespace hawk
 				// set rendering to forward
 				m_rendering = Rendering::Forward;
 
-				// forward render unlit objects
-				for (auto i = unlit_objects.begin(); i != unlit_objects.end(); ++i)
-					(*i)->render();
-
-				// forward render transparent objects back-to-front
-				for (auto i = transparent_objects.rbegin(); i != transparent_objects.rend(); ++i)
-					(*i)->render();
+				// forward render unlit objects then transparent objects back-to-front
+				renderQueue(forward, items.size());
 
 				// set rendering back to deferred
 				m_rendering = Rendering::Deferred;
@@ -1158,7 +2589,7 @@ namespace hawk
 			}
 
 			// unbind texture
-			glBindTexture(GL_TEXTURE_2D, 0);
+			bindTexture(0, 0);
 		}
 
 		void Video::renderBackbuffer(const Components::Camera* camera)
@@ -1167,10 +2598,10 @@ namespace hawk
 			System::Core& app = System::Core::getInstance();
 
 			// bind back buffer
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			bindFramebuffer(0);
 
 			// set viewport
-			glViewport(0, 0, app.width, app.height);
+			setViewport(0, 0, app.width, app.height);
 
 			// clear back buffer
 			clear();
@@ -1185,7 +2616,7 @@ namespace hawk
 			draw(m_screen_mesh);
 
 			// unbind texture
-			glBindTexture(GL_TEXTURE_2D, 0);
+			bindTexture(0, 0);
 		}
 
 		void Video::applySSAO(const Components::Camera* camera)
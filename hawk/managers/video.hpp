@@ -15,9 +15,15 @@
 #include "../assets/material.hpp"
 #include "../assets/mesh.hpp"
 #include "../assets/framebuffer.hpp"
+#include "../assets/pvs.hpp"
 #include "../components/camera.hpp"
 #include "../components/light.hpp"
 #include "../components/renderer.hpp"
+#include "../objects/bvh.hpp"
+#include "../objects/geometry_arena.hpp"
+#include "../objects/gpu_culler.hpp"
+#include "../objects/occlusion_buffer.hpp"
+#include "../objects/render_queue.hpp"
 
 namespace hawk
 {
@@ -66,6 +72,47 @@ namespace hawk
 				glm::mat4 matrix;
 			};
 
+			/**
+			 * Redundant graphics calls skipped by state and binding caches.
+			 */
+			struct SkippedCalls
+			{
+				/**
+				 * Render state changes.
+				 */
+				unsigned int states;
+
+				/**
+				 * Shader program binds.
+				 */
+				unsigned int programs;
+
+				/**
+				 * Vertex array binds.
+				 */
+				unsigned int vertex_arrays;
+
+				/**
+				 * Texture unit binds.
+				 */
+				unsigned int textures;
+
+				/**
+				 * Frame buffer binds.
+				 */
+				unsigned int framebuffers;
+
+				/**
+				 * Viewport changes.
+				 */
+				unsigned int viewports;
+			};
+
+			/**
+			 * Texture units with cached bindings, higher units are bound uncached.
+			 */
+			static constexpr unsigned int MAX_TEXTURE_UNITS = 32;
+
 			/**
 			 * Constructor.
 			 */
@@ -111,7 +158,7 @@ namespace hawk
 			void release();
 
 			/**
-			 * Reset graphics states.
+			 * Reset graphics states, called at pass ends instead of after every draw.
 			 */
 			void reset();
 
@@ -141,8 +188,221 @@ namespace hawk
 			 * Draw a mesh.
 			 * @param mesh Mesh to draw.
 			 * @param instances Count of instances to draw.
+			 * @param first_instance First instance of instanced draws.
+			 */
+			void draw(const hawk::Assets::Mesh* mesh, int instances = 0, unsigned int first_instance = 0);
+
+			/**
+			 * Draw ranges of instances from an instance matrices buffer with one multi draw call.
+			 * @param mesh Mesh to draw.
+			 * @param instance_buffer Instance model matrices buffer, read by attributes 5 to 8.
+			 * @param runs Instance ranges, first instance and count.
+			 */
+			void drawInstances(const hawk::Assets::Mesh* mesh, unsigned int instance_buffer, const std::vector<glm::uvec2>& runs);
+
+			/**
+			 * Draw ranges of mesh elements with one multi draw call.
+			 * @param mesh Indexed mesh to draw.
+			 * @param ranges Element ranges, first element and count.
+			 */
+			void drawRanges(const hawk::Assets::Mesh* mesh, const std::vector<glm::uvec2>& ranges);
+
+			/**
+			 * Bind a vertex array, skipped if already bound.
+			 * @param vao Vertex array object.
+			 */
+			void bindVertexArray(unsigned int vao);
+
+			/**
+			 * Use a shader program, skipped if already used.
+			 * @param program Shader program.
+			 */
+			void useProgram(unsigned int program);
+
+			/**
+			 * Use program and samplers of a material, samplers are skipped if last queued draw bound the same ones.
+			 * @param material Material to bind.
+			 */
+			void bindMaterial(hawk::Assets::Material* material);
+
+			/**
+			 * Bind a texture to a unit, skipped if already bound.
+			 * @param unit Texture unit.
+			 * @param texture Texture object, zero unbinds.
+			 */
+			void bindTexture(unsigned int unit, unsigned int texture);
+
+			/**
+			 * Bind textures to consecutive units with one multi bind of changed units.
+			 * @param first First texture unit.
+			 * @param count Textures count.
+			 * @param textures Texture objects.
+			 */
+			void bindTextures(unsigned int first, unsigned int count, const unsigned int* textures);
+
+			/**
+			 * Bind a frame buffer, skipped if already bound.
+			 * @param framebuffer Frame buffer object, zero binds back buffer.
+			 * @param target Frame buffer target.
+			 */
+			void bindFramebuffer(unsigned int framebuffer, unsigned int target = GL_FRAMEBUFFER);
+
+			/**
+			 * Set viewport, skipped if unchanged.
+			 */
+			void setViewport(int x, int y, int width, int height);
+
+			/**
+			 * Set polygon fill mode of both faces.
+			 */
+			void setPolygonMode(unsigned int mode);
+
+			/**
+			 * Forget cached bindings, called after binding or deleting objects directly.
+			 */
+			void resetBindings();
+
+			/**
+			 * Redundant graphics calls skipped in last frame.
+			 */
+			const SkippedCalls& getSkippedCalls() const;
+
+			/**
+			 * Add a camera to cameras list.
+			 * @param component Camera component.
+			 */
+			void addCamera(hawk::Components::Camera* component);
+
+			/**
+			 * Remove a camera from cameras list.
+			 * @param component Camera component.
+			 */
+			void removeCamera(hawk::Components::Camera* component);
+
+			/**
+			 * Add a light to lights list.
+			 * @param component Light component.
 			 */
-			void draw(const hawk::Assets::Mesh* mesh, int instances = 0);
+			void addLight(hawk::Components::Light* component);
+
+			/**
+			 * Remove a light from lights list.
+			 * @param component Light component.
+			 */
+			void removeLight(hawk::Components::Light* component);
+
+			/**
+			 * Add a renderer to renderers list.
+			 * @param component Renderer component.
+			 */
+			void addRenderer(hawk::Components::Renderer* component);
+
+			/**
+			 * Remove a renderer from renderers list.
+			 * @param component Renderer component.
+			 */
+			void removeRenderer(hawk::Components::Renderer* component);
+
+			/**
+			 * Enabled cameras of current frame.
+			 */
+			const std::vector<hawk::Components::Camera*>& getActiveCameras() const;
+
+			/**
+			 * Enabled lights of current frame.
+			 */
+			const std::vector<hawk::Components::Light*>& getActiveLights() const;
+
+			/**
+			 * Enabled renderers of current frame.
+			 */
+			const std::vector<hawk::Components::Renderer*>& getActiveRenderers() const;
+
+			/**
+			 * Renderers culled by camera frustums in last frame, counted once per camera.
+			 */
+			unsigned int getCulledRenderers() const;
+
+			/**
+			 * Renderers drawn by cameras in last frame, counted once per camera.
+			 */
+			unsigned int getDrawnRenderers() const;
+
+			/**
+			 * Renderers rejected by occlusion culling in last frame, counted once per camera.
+			 */
+			unsigned int getOccludedRenderers() const;
+
+			/**
+			 * Software occlusion depth buffer of last render camera.
+			 */
+			const hawk::Objects::OcclusionBuffer& getOcclusionBuffer() const;
+
+			/**
+			 * Graphics device culling draws and depth pyramid.
+			 */
+			const hawk::Objects::GpuCuller& getGpuCuller() const;
+
+			/**
+			 * Shared vertex and index buffers of meshes.
+			 */
+			hawk::Objects::GeometryArena& getGeometryArena();
+
+			/**
+			 * Shadow casters culled by light volumes or camera frustums in last frame, counted once per light.
+			 */
+			unsigned int getCulledCasters() const;
+
+			/**
+			 * Shadow casters drawn to shadow maps in last frame, counted once per light.
+			 */
+			unsigned int getDrawnCasters() const;
+
+			/**
+			 * Seconds spent culling renderers and shadow casters in last frame.
+			 */
+			double getCullingTime() const;
+
+			/**
+			 * Active renderers inside or intersecting a frustum, renderers without bounds are always included.
+			 * @param frustum Query frustum.
+			 * @param result List of renderers in tree order.
+			 */
+			void queryRenderers(const hawk::Helpers::Bounds::Frustum& frustum, std::vector<hawk::Components::Renderer*>& result);
+
+			/**
+			 * Active renderers intersecting a box, renderers without bounds are always included.
+			 * @param box Query box.
+			 * @param result List of renderers in tree order.
+			 */
+			void queryRenderers(const hawk::Helpers::Bounds::Box& box, std::vector<hawk::Components::Renderer*>& result);
+
+			/**
+			 * Active renderers intersecting a sphere, renderers without bounds are always included.
+			 * @param sphere Query sphere.
+			 * @param result List of renderers in tree order.
+			 */
+			void queryRenderers(const hawk::Helpers::Bounds::Sphere& sphere, std::vector<hawk::Components::Renderer*>& result);
+
+			/**
+			 * Tree of static renderers of last frame, item index is index in static renderers.
+			 */
+			const hawk::Objects::Bvh& getStaticTree() const;
+
+			/**
+			 * Static renderers by static tree item, removed renderers are nullptr until next frame.
+			 */
+			const std::vector<hawk::Components::Renderer*>& getStaticRenderers() const;
+
+			/**
+			 * Tree of moving renderers of last frame, item index is index in dynamic renderers.
+			 */
+			const hawk::Objects::Bvh& getDynamicTree() const;
+
+			/**
+			 * Moving renderers by dynamic tree item, removed renderers are nullptr until next frame.
+			 */
+			const std::vector<hawk::Components::Renderer*>& getDynamicRenderers() const;
 
 			/**
 			 * Rendering path.
@@ -280,21 +540,204 @@ namespace hawk
 			bool bloom;
 
 			/**
-			 * Scene cameras.
+			 * Cull renderers outside of camera frustum.
+			 */
+			bool culling;
+
+			/**
+			 * Cull through bounding volume hierarchies of static and moving renderers instead of testing each renderer.
+			 */
+			bool spatial_index;
+
+			/**
+			 * Reject renderers hidden behind occluders using a software depth buffer.
+			 */
+			bool occlusion;
+
+			/**
+			 * Most occluders per camera, renderers marked as occluder come first and then largest static renderers on screen.
+			 */
+			unsigned int max_occluders;
+
+			/**
+			 * Cull lit renderers of deferred rendering on graphics device against camera frustum and last frame depth pyramid,
+			 * and draw them with multi draw indirect commands. Other renderers are culled and drawn as before.
+			 */
+			bool gpu_culling;
+
+			/**
+			 * Scale of projected renderer sizes for level of detail selection, larger values keep more detail.
+			 */
+			float lod_bias;
+
+			/**
+			 * Detail levels coarser than camera level used in shadow maps.
+			 */
+			unsigned int shadow_lod_bias;
+
+			/**
+			 * Visible sets of static renderers, camera cell set replaces tree query of static renderers inside baked space.
+			 */
+			hawk::Assets::Pvs* pvs;
+
+			/**
+			 * Draw neighbouring queued renderers sharing material with one instanced draw, or one multi draw indirect call if their meshes are in geometry arena.
+			 */
+			bool instancing;
+
+			/**
+			 * Scene cameras, unordered.
 			 */
 			std::vector<hawk::Components::Camera*> cameras;
 
 			/**
-			 * Light casters.
+			 * Light casters, unordered.
 			 */
 			std::vector<hawk::Components::Light*> lights;
 
 			/**
-			 * Object renderers.
+			 * Object renderers, unordered.
 			 */
 			std::vector<hawk::Components::Renderer*> renderers;
 
 		private:
+			/**
+			 * Collect enabled cameras, lights and renderers for current frame.
+			 */
+			void gatherActive();
+
+			/**
+			 * Update renderer bounds, rebuild static tree if static renderers changed and refit or rebuild dynamic tree.
+			 */
+			void updateSpatialIndex();
+
+			/**
+			 * Fill visible renderers of a camera and count culled and drawn renderers.
+			 * @param view_projection Camera view projection matrix.
+			 */
+			void cullRenderers(const glm::mat4& view_projection);
+
+			/**
+			 * Fill tree query items from a visible set cell, static renderers of cell set and moving renderers in frustum.
+			 * @param cell Camera cell.
+			 * @param frustum Camera frustum.
+			 */
+			void cullVisibleSet(int cell, const hawk::Helpers::Bounds::Frustum& frustum);
+
+			/**
+			 * Map visible set items to static tree items.
+			 */
+			void mapVisibleSet();
+
+			/**
+			 * Rasterize occluders of render camera and remove visible renderers hidden behind them.
+			 * @param view_projection Camera view projection matrix.
+			 */
+			void cullOccluded(const glm::mat4& view_projection);
+
+			/**
+			 * Cull lit draws of render camera on graphics device and fill visible renderers with the rest.
+			 * @param view_projection Camera view projection matrix.
+			 */
+			void cullIndirect(const glm::mat4& view_projection);
+
+			/**
+			 * Fill shadow casters of a light, casters must be inside light volume and cast shadows which may reach a camera frustum.
+			 * @param light Shadow casting light.
+			 */
+			void cullCasters(const hawk::Components::Light* light);
+
+			/**
+			 * Does renderer draw into shadow maps?
+			 * @param renderer Renderer component.
+			 * @return True or False.
+			 */
+			bool isCaster(const hawk::Components::Renderer* renderer) const;
+
+			/**
+			 * Is renderer bound inside frustum?
+			 * @param renderer Renderer component.
+			 * @param frustum Camera frustum.
+			 * @return True or False.
+			 */
+			bool isVisible(const hawk::Components::Renderer* renderer, const hawk::Helpers::Bounds::Frustum& frustum) const;
+
+			/**
+			 * Map last tree query items to renderers.
+			 * @param result List of renderers in tree order.
+			 */
+			void gatherQuery(std::vector<hawk::Components::Renderer*>& result) const;
+
+			/**
+			 * Fill render queue with visible renderers of render camera and sort it.
+			 */
+			void fillQueue();
+
+			/**
+			 * Group neighbouring queued renderers into instanced batches and upload their transforms.
+			 */
+			void batchQueue();
+
+			/**
+			 * Fence instance commands of last frame and move to a region graphics device is done with.
+			 */
+			void advanceInstanceCommands();
+
+			/**
+			 * Release instance commands buffer and fences.
+			 */
+			void releaseInstanceCommands();
+
+			/**
+			 * Draw a range of render queue, batches as single instanced draws.
+			 * @param first First item.
+			 * @param last Item after last one.
+			 */
+			void renderQueue(size_t first, size_t last);
+
+			/**
+			 * Draw an instanced batch.
+			 * @param batch Batch index.
+			 */
+			void renderBatch(unsigned int batch);
+
+			/**
+			 * Can renderer be drawn as an instance of a batch?
+			 * @param renderer Renderer component.
+			 * @return True or False.
+			 */
+			static bool isBatchable(const hawk::Components::Renderer* renderer);
+
+			/**
+			 * Can two batchable renderers share a batch?
+			 * @param a First renderer.
+			 * @param b Second renderer.
+			 * @return True or False.
+			 */
+			static bool isBatchable(const hawk::Components::Renderer* a, const hawk::Components::Renderer* b);
+			/**
+			 * Order shadow casters by mesh.
+			 */
+			void sortCasters();
+
+			/**
+			 * Start or stop drawing a queue, material samplers are forgotten either way and render states are reset on stop.
+			 * @param track Track bindings.
+			 */
+			void trackBindings(bool track);
+
+			/**
+			 * Texture set id of a material.
+			 * @param material Material.
+			 */
+			static unsigned int getTexturesId(const hawk::Assets::Material* material);
+
+			/**
+			 * Mesh id of sort keys, meshes in geometry arena share a vertex array so their address tells them apart.
+			 * @param mesh Mesh, may be nullptr.
+			 */
+			static unsigned int getMeshId(const hawk::Assets::Mesh* mesh);
+
 			/**
 			 * Forward render.
 			 */
@@ -476,6 +919,16 @@ namespace hawk
 			 */
 			unsigned int m_face_orientation;
 
+			/**
+			 * Polygon fill mode cache.
+			 */
+			unsigned int m_polygon_mode;
+
+			/**
+			 * Viewport cache.
+			 */
+			glm::ivec4 m_viewport;
+
 			/**
 			 * Video uniform buffer object.
 			 */
@@ -575,6 +1028,368 @@ namespace hawk
 			 * Gamma correction and hdr material.
 			 */
 			hawk::Assets::Material* m_final_material;
+
+			/**
+			 * Enabled cameras of current frame.
+			 */
+			std::vector<hawk::Components::Camera*> m_active_cameras;
+
+			/**
+			 * Enabled lights of current frame.
+			 */
+			std::vector<hawk::Components::Light*> m_active_lights;
+
+			/**
+			 * Enabled renderers of current frame.
+			 */
+			std::vector<hawk::Components::Renderer*> m_active_renderers;
+
+			/**
+			 * Culled renderers count of current frame.
+			 */
+			unsigned int m_culled_renderers;
+
+			/**
+			 * Drawn renderers count of current frame.
+			 */
+			unsigned int m_drawn_renderers;
+
+			/**
+			 * Occluded renderers count of current frame.
+			 */
+			unsigned int m_occluded_renderers;
+
+			/**
+			 * Culled shadow casters count of current frame.
+			 */
+			unsigned int m_culled_casters;
+
+			/**
+			 * Drawn shadow casters count of current frame.
+			 */
+			unsigned int m_drawn_casters;
+
+			/**
+			 * Active shadow casters count of current frame.
+			 */
+			unsigned int m_casters_count;
+
+			/**
+			 * Culling seconds of current frame.
+			 */
+			double m_culling_time;
+
+			/**
+			 * Tree of renderers on static entities.
+			 */
+			hawk::Objects::Bvh m_static_tree;
+
+			/**
+			 * Tree of moving renderers.
+			 */
+			hawk::Objects::Bvh m_dynamic_tree;
+
+			/**
+			 * Static tree renderers by item index.
+			 */
+			std::vector<hawk::Components::Renderer*> m_static_renderers;
+
+			/**
+			 * Dynamic tree renderers by item index.
+			 */
+			std::vector<hawk::Components::Renderer*> m_dynamic_renderers;
+
+			/**
+			 * Active renderers without bounds.
+			 */
+			std::vector<hawk::Components::Renderer*> m_unbounded_renderers;
+
+			/**
+			 * Static renderers of current frame before comparing with static tree.
+			 */
+			std::vector<hawk::Components::Renderer*> m_static_scratch;
+
+			/**
+			 * Moving renderers of current frame before comparing with dynamic tree.
+			 */
+			std::vector<hawk::Components::Renderer*> m_dynamic_scratch;
+
+			/**
+			 * Static tree item boxes.
+			 */
+			std::vector<hawk::Helpers::Bounds::Box> m_static_bounds;
+
+			/**
+			 * Dynamic tree item boxes.
+			 */
+			std::vector<hawk::Helpers::Bounds::Box> m_dynamic_bounds;
+
+			/**
+			 * Visible sets static tree items are mapped for.
+			 */
+			const hawk::Assets::Pvs* m_pvs_mapped;
+
+			/**
+			 * Static tree item by visible set item, invalid if renderer is not static.
+			 */
+			std::vector<unsigned int> m_pvs_statics;
+
+			/**
+			 * Static tree items missing from visible sets.
+			 */
+			std::vector<unsigned int> m_pvs_unbaked;
+
+			/**
+			 * Static tree query items.
+			 */
+			std::vector<unsigned int> m_static_query;
+
+			/**
+			 * Dynamic tree query items.
+			 */
+			std::vector<unsigned int> m_dynamic_query;
+
+			/**
+			 * Renderers visible to render camera.
+			 */
+			std::vector<hawk::Components::Renderer*> m_visible_renderers;
+
+			/**
+			 * Shadow casters of current light.
+			 */
+			std::vector<hawk::Components::Renderer*> m_shadow_casters;
+
+			/**
+			 * Frustums of active cameras.
+			 */
+			std::vector<hawk::Helpers::Bounds::Frustum> m_camera_frustums;
+
+			/**
+			 * Software occlusion depth buffer.
+			 */
+			hawk::Objects::OcclusionBuffer m_occlusion_buffer;
+
+			/**
+			 * Occluder candidates with their screen size score and visible renderer index.
+			 */
+			std::vector<std::pair<float, size_t>> m_occluders;
+
+			/**
+			 * Occlusion test results of visible renderers, occluders are marked to skip the test.
+			 */
+			std::vector<unsigned char> m_occlusion_results;
+
+			/**
+			 * Draw elements indirect command.
+			 */
+			struct DrawCommand
+			{
+				unsigned int count;
+				unsigned int instance_count;
+				unsigned int first_index;
+				int base_vertex;
+				unsigned int base_instance;
+			};
+
+			/**
+			 * Instance commands buffer regions, one is written per frame while others may still be read by graphics device.
+			 */
+			static constexpr unsigned int COMMAND_REGIONS = 3;
+
+			/**
+			 * Instance ranges draw commands.
+			 */
+			std::vector<DrawCommand> m_instance_commands;
+
+			/**
+			 * Instance ranges draw commands buffer, persistently mapped.
+			 */
+			unsigned int m_instance_commands_buffer;
+
+			/**
+			 * Mapped instance commands buffer.
+			 */
+			DrawCommand* m_instance_commands_mapping;
+
+			/**
+			 * Instance commands capacity of a region.
+			 */
+			unsigned int m_instance_commands_capacity;
+
+			/**
+			 * Instance commands region of current frame.
+			 */
+			unsigned int m_instance_commands_region;
+
+			/**
+			 * Instance commands written in current region.
+			 */
+			unsigned int m_instance_commands_offset;
+
+			/**
+			 * Fences of draws reading each instance commands region.
+			 */
+			GLsync m_instance_commands_fences[COMMAND_REGIONS];
+
+			/**
+			 * Element ranges counts.
+			 */
+			std::vector<int> m_range_counts;
+
+			/**
+			 * Element ranges byte offsets.
+			 */
+			std::vector<const void*> m_range_offsets;
+
+			/**
+			 * Graphics device culling of lit renderers.
+			 */
+			hawk::Objects::GpuCuller m_gpu_culler;
+
+			/**
+			 * Active renderers not drawn by indirect commands.
+			 */
+			std::vector<hawk::Components::Renderer*> m_direct_renderers;
+
+			/**
+			 * Camera of depth pyramid.
+			 */
+			hawk::Components::Camera* m_pyramid_camera;
+
+			/**
+			 * Sorted draws of render camera.
+			 */
+			hawk::Objects::RenderQueue m_render_queue;
+
+			/**
+			 * Sorted draws of current light.
+			 */
+			hawk::Objects::RenderQueue m_caster_queue;
+
+			/**
+			 * Instanced or multi draw of neighbouring queue items.
+			 */
+			struct Batch
+			{
+				/**
+				 * First queue item.
+				 */
+				unsigned int first;
+
+				/**
+				 * Items count.
+				 */
+				unsigned int count;
+
+				/**
+				 * First transform in batch transforms buffer.
+				 */
+				unsigned int base;
+
+				/**
+				 * First command in batch commands buffer.
+				 */
+				unsigned int command;
+
+				/**
+				 * Commands count, zero for one instanced draw.
+				 */
+				unsigned int commands_count;
+			};
+
+			/**
+			 * Batch transform, layout matches draws buffer of vertex shaders.
+			 */
+			struct BatchTransform
+			{
+				glm::mat4 model;
+				glm::mat4 normal;
+			};
+
+			/**
+			 * Instanced batches of render queue.
+			 */
+			std::vector<Batch> m_batches;
+
+			/**
+			 * Batch index of each render queue item, -1 for single draws.
+			 */
+			std::vector<int> m_item_batches;
+
+			/**
+			 * Transforms of batched renderers.
+			 */
+			std::vector<BatchTransform> m_batch_transforms;
+
+			/**
+			 * Batch transforms buffer, refilled per camera.
+			 */
+			unsigned int m_batch_buffer;
+
+			/**
+			 * Draw commands of batches, one per run of same mesh.
+			 */
+			std::vector<DrawCommand> m_batch_commands;
+
+			/**
+			 * Batch commands buffer, refilled per camera.
+			 */
+			unsigned int m_batch_commands_buffer;
+
+			/**
+			 * Element ranges base vertices.
+			 */
+			std::vector<int> m_range_base_vertices;
+
+			/**
+			 * Shared vertex and index buffers of meshes.
+			 */
+			hawk::Objects::GeometryArena m_geometry_arena;
+
+			/**
+			 * Cached binding which is not known.
+			 */
+			static constexpr unsigned int UNKNOWN_BINDING = 0xFFFFFFFF;
+
+			/**
+			 * Is a queue being drawn?
+			 */
+			bool m_tracking;
+
+			/**
+			 * Bound vertex array cache.
+			 */
+			unsigned int m_bound_vao;
+
+			/**
+			 * Used program cache.
+			 */
+			unsigned int m_bound_program;
+
+			/**
+			 * Material of last queued draw samplers, nullptr if unknown.
+			 */
+			const hawk::Assets::Material* m_bound_material;
+
+			/**
+			 * Bound texture of each unit cache.
+			 */
+			unsigned int m_bound_textures[MAX_TEXTURE_UNITS];
+
+			/**
+			 * Bound draw frame buffer cache.
+			 */
+			unsigned int m_bound_draw_framebuffer;
+
+			/**
+			 * Bound read frame buffer cache.
+			 */
+			unsigned int m_bound_read_framebuffer;
+
+			/**
+			 * Skipped calls since frame start.
+			 */
+			SkippedCalls m_skipped_calls;
 		};
 	}
 }
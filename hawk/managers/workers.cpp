@@ -0,0 +1,249 @@
+#include "../system/core.hpp"
+#include "workers.hpp"
+
+namespace hawk
+{
+	namespace Managers
+	{
+		/**
+		 * Depth of pushed jobs running on this thread.
+		 */
+		static thread_local unsigned int job_depth = 0;
+
+		Workers::Workers() : m_queues(nullptr), m_queues_count(0), m_next_queue(0), m_pending(0), m_queued(0), m_running(false)
+		{
+			// set manager name
+			m_name = "Workers";
+		}
+
+		Workers::~Workers() {}
+
+		bool Workers::initialize(unsigned int count)
+		{
+			// set main thread
+			m_main_thread = std::this_thread::get_id();
+
+			// one worker per core beside main thread
+			if (count == 0)
+			{
+				unsigned int cores = std::thread::hardware_concurrency();
+
+				count = cores > 1 ? cores - 1 : 0;
+			}
+
+			// make queues
+			m_queues_count = count + 1;
+			m_queues = new Queue[m_queues_count];
+
+			// set running flag
+			m_running = true;
+
+			// start threads
+			for (unsigned int i = 0; i < count; ++i)
+				m_threads.push_back(std::thread(&Workers::work, this, i));
+
+			return true;
+		}
+
+		void Workers::deinitialize()
+		{
+			// return if not initialized
+			if (!m_queues) return;
+
+			// stop threads
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+
+				m_running = false;
+			}
+
+			m_condition.notify_all();
+
+			for (auto& thread : m_threads)
+				thread.join();
+
+			m_threads.clear();
+
+			// free queues
+			delete[] m_queues;
+
+			m_queues = nullptr;
+			m_queues_count = 0;
+		}
+
+		void Workers::push(const Job& job)
+		{
+			// run on caller if not initialized
+			if (!m_queues)
+			{
+				job();
+
+				return;
+			}
+
+			// count job before it can be taken
+			m_pending++;
+
+			// push to queues in turn
+			Queue& queue = m_queues[m_next_queue];
+
+			m_next_queue = (m_next_queue + 1) % m_queues_count;
+
+			{
+				std::lock_guard<std::mutex> lock(queue.mutex);
+
+				queue.jobs.push_back(job);
+			}
+
+			// wake a worker
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+
+				m_queued++;
+			}
+
+			m_condition.notify_one();
+		}
+
+		void Workers::wait()
+		{
+			// return if not initialized
+			if (!m_queues) return;
+
+			// help workers until all jobs are done
+			while (m_pending > 0)
+			{
+				Job job;
+
+				if (pop(m_queues_count - 1, job))
+					run(job);
+				else
+					std::this_thread::yield();
+			}
+		}
+
+		void Workers::defer(const Job& job)
+		{
+			// run right away on main thread
+			if (isMainThread())
+			{
+				job();
+
+				return;
+			}
+
+			// push to deferred list
+			std::lock_guard<std::mutex> lock(m_deferred_mutex);
+
+			m_deferred.push_back(job);
+		}
+
+		void Workers::flush()
+		{
+			// take deferred jobs
+			std::vector<Job> jobs;
+
+			{
+				std::lock_guard<std::mutex> lock(m_deferred_mutex);
+
+				jobs.swap(m_deferred);
+			}
+
+			// run in order
+			for (auto& job : jobs)
+				job();
+		}
+
+		bool Workers::isMainThread() const
+		{
+			return std::this_thread::get_id() == m_main_thread;
+		}
+
+		bool Workers::isInJob() const
+		{
+			return job_depth > 0;
+		}
+
+		unsigned int Workers::getCount() const
+		{
+			return static_cast<unsigned int>(m_threads.size());
+		}
+
+		void Workers::work(unsigned int index)
+		{
+			while (true)
+			{
+				Job job;
+
+				// run a job if there is any
+				if (pop(index, job))
+				{
+					run(job);
+
+					continue;
+				}
+
+				// sleep until jobs are pushed
+				std::unique_lock<std::mutex> lock(m_mutex);
+
+				m_condition.wait(lock, [this]() { return m_queued > 0 || !m_running; });
+
+				// return if stopped
+				if (!m_running) return;
+			}
+		}
+
+		bool Workers::pop(unsigned int index, Job& job)
+		{
+			// take newest job of own queue
+			{
+				Queue& queue = m_queues[index];
+
+				std::lock_guard<std::mutex> lock(queue.mutex);
+
+				if (!queue.jobs.empty())
+				{
+					job = std::move(queue.jobs.back());
+
+					queue.jobs.pop_back();
+
+					m_queued--;
+
+					return true;
+				}
+			}
+
+			// steal oldest job of other queues
+			for (unsigned int i = 1; i < m_queues_count; ++i)
+			{
+				Queue& queue = m_queues[(index + i) % m_queues_count];
+
+				std::lock_guard<std::mutex> lock(queue.mutex);
+
+				if (!queue.jobs.empty())
+				{
+					job = std::move(queue.jobs.front());
+
+					queue.jobs.pop_front();
+
+					m_queued--;
+
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void Workers::run(Job& job)
+		{
+			job_depth++;
+
+			job();
+
+			job_depth--;
+
+			m_pending--;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#ifndef HAWK_MANAGERS_WORKERS_H
+#define HAWK_MANAGERS_WORKERS_H
+
+// stl
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// local
+#include "manager.hpp"
+
+namespace hawk
+{
+	namespace Managers
+	{
+		/**
+		 * Worker threads manager. Runs jobs on a fixed size thread pool, idle workers steal jobs from other queues.
+		 */
+		class Workers : public Manager
+		{
+		public:
+			/**
+			 * Job type.
+			 */
+			typedef std::function<void()> Job;
+
+			/**
+			 * Constructor.
+			 */
+			Workers();
+
+			/**
+			 * Constructor.
+			 * @param other Other object.
+			 */
+			Workers(const Workers& other) = delete;
+
+			/**
+			 * Destructor.
+			 */
+			~Workers();
+
+			/**
+			 * Assignment operator.
+			 * @param other Other object.
+			 */
+			void operator=(const Workers& other) = delete;
+
+			/**
+			 * Initializer.
+			 * @param count Worker threads count, zero uses one thread per core beside main thread.
+			 * @return True or False.
+			 */
+			bool initialize(unsigned int count = 0);
+
+			/**
+			 * Deinitializer.
+			 */
+			void deinitialize();
+
+			/**
+			 * Push a job to worker queues.
+			 * @param job Job function.
+			 */
+			void push(const Job& job);
+
+			/**
+			 * Run jobs on main thread as well until all pushed jobs are done.
+			 */
+			void wait();
+
+			/**
+			 * Defer a job to main thread, used for work which must not leave main thread like graphics calls.
+			 * @param job Job function.
+			 */
+			void defer(const Job& job);
+
+			/**
+			 * Run deferred jobs on main thread.
+			 */
+			void flush();
+
+			/**
+			 * Is caller main thread?
+			 */
+			bool isMainThread() const;
+
+			/**
+			 * Is caller running a pushed job? Nested waits from inside a job never finish, jobs must run their work inline.
+			 */
+			bool isInJob() const;
+
+			/**
+			 * Worker threads count.
+			 */
+			unsigned int getCount() const;
+
+		private:
+			/**
+			 * Job queue of a thread.
+			 */
+			struct Queue
+			{
+				/**
+				 * Queue lock.
+				 */
+				std::mutex mutex;
+
+				/**
+				 * Queued jobs.
+				 */
+				std::deque<Job> jobs;
+			};
+
+			/**
+			 * Worker thread loop.
+			 * @param index Worker queue index.
+			 */
+			void work(unsigned int index);
+
+			/**
+			 * Pop a job from own queue or steal one from other queues.
+			 * @param index Own queue index.
+			 * @param job Popped job.
+			 * @return True if a job is found.
+			 */
+			bool pop(unsigned int index, Job& job);
+
+			/**
+			 * Run a popped job and count it done.
+			 * @param job Popped job.
+			 */
+			void run(Job& job);
+
+			/**
+			 * Worker threads.
+			 */
+			std::vector<std::thread> m_threads;
+
+			/**
+			 * Job queues, one per worker and last one for main thread.
+			 */
+			Queue* m_queues;
+
+			/**
+			 * Job queues count.
+			 */
+			unsigned int m_queues_count;
+
+			/**
+			 * Next queue to push to.
+			 */
+			unsigned int m_next_queue;
+
+			/**
+			 * Count of pushed jobs not finished yet.
+			 */
+			std::atomic<int> m_pending;
+
+			/**
+			 * Count of jobs waiting in queues.
+			 */
+			std::atomic<int> m_queued;
+
+			/**
+			 * Are workers running?
+			 */
+			std::atomic<bool> m_running;
+
+			/**
+			 * Sleep lock.
+			 */
+			std::mutex m_mutex;
+
+			/**
+			 * Sleep condition.
+			 */
+			std::condition_variable m_condition;
+
+			/**
+			 * Deferred jobs lock.
+			 */
+			std::mutex m_deferred_mutex;
+
+			/**
+			 * Deferred jobs.
+			 */
+			std::vector<Job> m_deferred;
+
+			/**
+			 * Main thread id.
+			 */
+			std::thread::id m_main_thread;
+		};
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,451 @@
+#include "bvh.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace hawk
+{
+	namespace Objects
+	{
+		/**
+		 * Box surface area.
+		 */
+		static float area(const Helpers::Bounds::Box& box)
+		{
+			glm::vec3 size = box.max - box.min;
+
+			return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+
+		/**
+		 * Frustum test result, 0 outside, 1 intersecting and 2 fully inside.
+		 */
+		static int classify(const Helpers::Bounds::Frustum& frustum, const Helpers::Bounds::Box& box)
+		{
+			// fully inside until a plane cuts the box
+			int result = 2;
+
+			for (int i = 0; i < 6; ++i)
+			{
+				const glm::vec4& plane = frustum.planes[i];
+
+				// corners furthest and nearest along plane normal
+				glm::vec3 far_corner = glm::vec3(plane.x >= 0.0f ? box.max.x : box.min.x, plane.y >= 0.0f ? box.max.y : box.min.y, plane.z >= 0.0f ? box.max.z : box.min.z);
+				glm::vec3 near_corner = glm::vec3(plane.x >= 0.0f ? box.min.x : box.max.x, plane.y >= 0.0f ? box.min.y : box.max.y, plane.z >= 0.0f ? box.min.z : box.max.z);
+
+				// return if whole box is behind plane
+				if (glm::dot(glm::vec3(plane), far_corner) + plane.w < 0.0f) return 0;
+
+				// plane cuts the box
+				if (glm::dot(glm::vec3(plane), near_corner) + plane.w < 0.0f) result = 1;
+			}
+
+			return result;
+		}
+
+		/**
+		 * Squared distance from a point to a box, zero inside.
+		 */
+		static float distanceSquared(const Helpers::Bounds::Box& box, const glm::vec3& point)
+		{
+			glm::vec3 delta = glm::clamp(point, box.min, box.max) - point;
+
+			return glm::dot(delta, delta);
+		}
+
+		Bvh::Bvh() : m_build_area(0.0f) {}
+
+		Bvh::~Bvh() {}
+
+		void Bvh::build(const std::vector<Helpers::Bounds::Box>& bounds)
+		{
+			// reset tree
+			clear();
+
+			// return if there is nothing to build
+			if (bounds.empty()) return;
+
+			// keep item boxes for leaf tests
+			m_bounds = bounds;
+
+			// item indices and box centers
+			std::vector<glm::vec3> centers(bounds.size());
+
+			m_items.resize(bounds.size());
+
+			for (unsigned int i = 0; i < bounds.size(); ++i)
+			{
+				m_items[i] = i;
+				centers[i] = (bounds[i].min + bounds[i].max) * 0.5f;
+			}
+
+			// root holds all items
+			m_nodes.reserve(bounds.size() * 2);
+			m_nodes.push_back({ Helpers::Bounds::empty(), 0, static_cast<unsigned int>(bounds.size()), 0 });
+
+			// split from root
+			subdivide(0, 0, centers);
+
+			// keep build cost to measure refits against
+			m_build_area = getArea();
+		}
+
+		void Bvh::refit(const std::vector<Helpers::Bounds::Box>& bounds)
+		{
+			// keep item boxes for leaf tests
+			m_bounds = bounds;
+
+			// children are stored after parents so walking backwards visits them first
+			for (size_t i = m_nodes.size(); i-- > 0;)
+			{
+				Node& node = m_nodes[i];
+
+				node.bounds = Helpers::Bounds::empty();
+
+				if (node.left)
+				{
+					Helpers::Bounds::expand(node.bounds, m_nodes[node.left].bounds);
+					Helpers::Bounds::expand(node.bounds, m_nodes[node.left + 1].bounds);
+				}
+				else
+				{
+					for (unsigned int j = node.first; j < node.first + node.count; ++j)
+						Helpers::Bounds::expand(node.bounds, m_bounds[m_items[j]]);
+				}
+			}
+		}
+
+		void Bvh::clear()
+		{
+			m_nodes.clear();
+			m_items.clear();
+			m_bounds.clear();
+
+			m_build_area = 0.0f;
+		}
+
+		bool Bvh::needsRebuild() const
+		{
+			return getArea() > m_build_area * 2.0f;
+		}
+
+		void Bvh::query(const Helpers::Bounds::Frustum& frustum, std::vector<unsigned int>& result) const
+		{
+			// return if tree is empty
+			if (m_nodes.empty()) return;
+
+			// nodes to visit
+			unsigned int stack[MAX_DEPTH + 2];
+			int top = 0;
+
+			stack[top++] = 0;
+
+			while (top > 0)
+			{
+				const Node& node = m_nodes[stack[--top]];
+
+				// test node box
+				int test = classify(frustum, node.bounds);
+
+				// skip subtree if outside
+				if (test == 0) continue;
+
+				// take whole subtree without more tests if inside
+				if (test == 2)
+				{
+					collect(node, result);
+
+					continue;
+				}
+
+				// visit children or test leaf items
+				if (node.left)
+				{
+					stack[top++] = node.left;
+					stack[top++] = node.left + 1;
+				}
+				else
+				{
+					for (unsigned int i = node.first; i < node.first + node.count; ++i)
+						if (classify(frustum, m_bounds[m_items[i]])) result.push_back(m_items[i]);
+				}
+			}
+		}
+
+		void Bvh::query(const Helpers::Bounds::Box& box, std::vector<unsigned int>& result) const
+		{
+			// return if tree is empty
+			if (m_nodes.empty()) return;
+
+			// nodes to visit
+			unsigned int stack[MAX_DEPTH + 2];
+			int top = 0;
+
+			stack[top++] = 0;
+
+			while (top > 0)
+			{
+				const Node& node = m_nodes[stack[--top]];
+
+				// skip subtree if apart
+				if (!Helpers::Bounds::intersects(box, node.bounds)) continue;
+
+				// visit children or test leaf items
+				if (node.left)
+				{
+					stack[top++] = node.left;
+					stack[top++] = node.left + 1;
+				}
+				else
+				{
+					for (unsigned int i = node.first; i < node.first + node.count; ++i)
+						if (Helpers::Bounds::intersects(box, m_bounds[m_items[i]])) result.push_back(m_items[i]);
+				}
+			}
+		}
+
+		void Bvh::query(const Helpers::Bounds::Sphere& sphere, std::vector<unsigned int>& result) const
+		{
+			// return if tree is empty
+			if (m_nodes.empty()) return;
+
+			// nodes to visit
+			unsigned int stack[MAX_DEPTH + 2];
+			int top = 0;
+
+			stack[top++] = 0;
+
+			while (top > 0)
+			{
+				const Node& node = m_nodes[stack[--top]];
+
+				// skip subtree if apart
+				if (!Helpers::Bounds::intersects(sphere, node.bounds)) continue;
+
+				// visit children or test leaf items
+				if (node.left)
+				{
+					stack[top++] = node.left;
+					stack[top++] = node.left + 1;
+				}
+				else
+				{
+					for (unsigned int i = node.first; i < node.first + node.count; ++i)
+						if (Helpers::Bounds::intersects(sphere, m_bounds[m_items[i]])) result.push_back(m_items[i]);
+				}
+			}
+		}
+
+		void Bvh::nearest(const glm::vec3& point, unsigned int count, float length, std::vector<std::pair<float, unsigned int>>& result) const
+		{
+			// return if tree is empty
+			if (m_nodes.empty() || count == 0) return;
+
+			// farthest kept items on top, squared distances
+			std::vector<std::pair<float, unsigned int>> heap;
+
+			heap.reserve(count + 1);
+
+			float limit = length * length;
+
+			// nodes to visit
+			unsigned int stack[MAX_DEPTH + 2];
+			int top = 0;
+
+			stack[top++] = 0;
+
+			while (top > 0)
+			{
+				const Node& node = m_nodes[stack[--top]];
+
+				// skip subtree if farther than farthest kept item
+				if (distanceSquared(node.bounds, point) > limit) continue;
+
+				if (node.left)
+				{
+					// visit nearer child first
+					bool left_first = distanceSquared(m_nodes[node.left].bounds, point) <= distanceSquared(m_nodes[node.left + 1].bounds, point);
+
+					stack[top++] = left_first ? node.left + 1 : node.left;
+					stack[top++] = left_first ? node.left : node.left + 1;
+				}
+				else
+				{
+					for (unsigned int i = node.first; i < node.first + node.count; ++i)
+					{
+						float distance = distanceSquared(m_bounds[m_items[i]], point);
+
+						if (distance > limit) continue;
+
+						// keep item and drop farthest if full
+						heap.push_back(std::make_pair(distance, m_items[i]));
+
+						std::push_heap(heap.begin(), heap.end());
+
+						if (heap.size() > count)
+						{
+							std::pop_heap(heap.begin(), heap.end());
+
+							heap.pop_back();
+						}
+
+						if (heap.size() == count) limit = heap.front().first;
+					}
+				}
+			}
+
+			// nearest first
+			std::sort_heap(heap.begin(), heap.end());
+
+			for (auto& item : heap)
+				result.push_back(std::make_pair(std::sqrt(item.first), item.second));
+		}
+
+		unsigned int Bvh::getCount() const
+		{
+			return static_cast<unsigned int>(m_items.size());
+		}
+
+		unsigned int Bvh::getNodesCount() const
+		{
+			return static_cast<unsigned int>(m_nodes.size());
+		}
+
+		void Bvh::subdivide(unsigned int index, unsigned int depth, const std::vector<glm::vec3>& centers)
+		{
+			// node range
+			unsigned int first = m_nodes[index].first;
+			unsigned int count = m_nodes[index].count;
+
+			// node box and centers box
+			Helpers::Bounds::Box box = Helpers::Bounds::empty();
+			Helpers::Bounds::Box center_box = Helpers::Bounds::empty();
+
+			for (unsigned int i = first; i < first + count; ++i)
+			{
+				Helpers::Bounds::expand(box, m_bounds[m_items[i]]);
+				Helpers::Bounds::expand(center_box, centers[m_items[i]]);
+			}
+
+			m_nodes[index].bounds = box;
+
+			// return if leaf is small enough or tree is too deep for query stacks
+			if (count <= LEAF_SIZE || depth >= MAX_DEPTH) return;
+
+			// best split
+			float best_cost = static_cast<float>(count) * area(box);
+			int best_axis = -1;
+			unsigned int best_bin = 0;
+
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				// centers extent on axis
+				float min = center_box.min[axis];
+				float extent = center_box.max[axis] - min;
+
+				// continue if all centers are on one spot
+				if (extent <= 0.0f) continue;
+
+				// fill bins
+				Helpers::Bounds::Box bin_boxes[BINS];
+				unsigned int bin_counts[BINS] = {};
+
+				for (unsigned int b = 0; b < BINS; ++b)
+					bin_boxes[b] = Helpers::Bounds::empty();
+
+				for (unsigned int i = first; i < first + count; ++i)
+				{
+					unsigned int bin = std::min(BINS - 1, static_cast<unsigned int>((centers[m_items[i]][axis] - min) / extent * BINS));
+
+					Helpers::Bounds::expand(bin_boxes[bin], m_bounds[m_items[i]]);
+
+					bin_counts[bin]++;
+				}
+
+				// sweep from right to gather right side costs
+				float right_areas[BINS];
+				unsigned int right_counts[BINS];
+
+				Helpers::Bounds::Box right = Helpers::Bounds::empty();
+				unsigned int right_count = 0;
+
+				for (unsigned int b = BINS - 1; b > 0; --b)
+				{
+					Helpers::Bounds::expand(right, bin_boxes[b]);
+
+					right_count += bin_counts[b];
+
+					right_areas[b] = right_count ? area(right) : 0.0f;
+					right_counts[b] = right_count;
+				}
+
+				// sweep from left and evaluate each split plane
+				Helpers::Bounds::Box left = Helpers::Bounds::empty();
+				unsigned int left_count = 0;
+
+				for (unsigned int b = 0; b < BINS - 1; ++b)
+				{
+					Helpers::Bounds::expand(left, bin_boxes[b]);
+
+					left_count += bin_counts[b];
+
+					// continue if a side is empty
+					if (!left_count || !right_counts[b + 1]) continue;
+
+					float cost = static_cast<float>(left_count) * area(left) + static_cast<float>(right_counts[b + 1]) * right_areas[b + 1];
+
+					if (cost < best_cost)
+					{
+						best_cost = cost;
+						best_axis = axis;
+						best_bin = b;
+					}
+				}
+			}
+
+			// return if no split beats a leaf
+			if (best_axis < 0) return;
+
+			// partition items by split plane
+			float min = center_box.min[best_axis];
+			float extent = center_box.max[best_axis] - min;
+
+			unsigned int* middle = std::partition(&m_items[first], &m_items[first] + count, [&](unsigned int item)
+			{
+				return std::min(BINS - 1, static_cast<unsigned int>((centers[item][best_axis] - min) / extent * BINS)) <= best_bin;
+			});
+
+			unsigned int left_count = static_cast<unsigned int>(middle - &m_items[first]);
+
+			// return if split failed
+			if (left_count == 0 || left_count == count) return;
+
+			// make children
+			unsigned int left = static_cast<unsigned int>(m_nodes.size());
+
+			m_nodes.push_back({ Helpers::Bounds::empty(), first, left_count, 0 });
+			m_nodes.push_back({ Helpers::Bounds::empty(), first + left_count, count - left_count, 0 });
+
+			m_nodes[index].left = left;
+
+			// split children
+			subdivide(left, depth + 1, centers);
+			subdivide(left + 1, depth + 1, centers);
+		}
+
+		float Bvh::getArea() const
+		{
+			// sum of inner nodes
+			float result = 0.0f;
+
+			for (auto& node : m_nodes)
+				if (node.left) result += area(node.bounds);
+
+			return result;
+		}
+
+		void Bvh::collect(const Node& node, std::vector<unsigned int>& result) const
+		{
+			result.insert(result.end(), m_items.begin() + node.first, m_items.begin() + node.first + node.count);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+#ifndef HAWK_OBJECTS_BVH_H
+#define HAWK_OBJECTS_BVH_H
+
+// stl
+#include <vector>
+#include <utility>
+
+// local
+#include "../helpers/bounds.hpp"
+
+namespace hawk
+{
+	namespace Objects
+	{
+		/**
+		 * Bounding volume hierarchy over item boxes. Built top down with binned surface area heuristic,
+		 * moving items are handled by refitting node boxes until tree quality drops enough to rebuild.
+		 */
+		class Bvh
+		{
+		public:
+			/**
+			 * Most items in a leaf.
+			 */
+			static constexpr unsigned int LEAF_SIZE = 4;
+
+			/**
+			 * Surface area heuristic bins per axis.
+			 */
+			static constexpr unsigned int BINS = 8;
+
+			/**
+			 * Deepest node level, keeps query stacks fixed size.
+			 */
+			static constexpr unsigned int MAX_DEPTH = 48;
+
+			/**
+			 * Constructor.
+			 */
+			Bvh();
+
+			/**
+			 * Destructor.
+			 */
+			~Bvh();
+
+			/**
+			 * Build tree, item index is its index in bounds list.
+			 * @param bounds Item boxes.
+			 */
+			void build(const std::vector<Helpers::Bounds::Box>& bounds);
+
+			/**
+			 * Update node boxes for moved items, tree layout is kept.
+			 * @param bounds Item boxes, same count and order as build.
+			 */
+			void refit(const std::vector<Helpers::Bounds::Box>& bounds);
+
+			/**
+			 * Remove all nodes and items.
+			 */
+			void clear();
+
+			/**
+			 * Has tree grown loose enough after refits that a rebuild pays off?
+			 */
+			bool needsRebuild() const;
+
+			/**
+			 * Items inside or intersecting a frustum.
+			 * @param frustum Query frustum.
+			 * @param result List to append item indices to.
+			 */
+			void query(const Helpers::Bounds::Frustum& frustum, std::vector<unsigned int>& result) const;
+
+			/**
+			 * Items intersecting a box.
+			 * @param box Query box.
+			 * @param result List to append item indices to.
+			 */
+			void query(const Helpers::Bounds::Box& box, std::vector<unsigned int>& result) const;
+
+			/**
+			 * Items intersecting a sphere.
+			 * @param sphere Query sphere.
+			 * @param result List to append item indices to.
+			 */
+			void query(const Helpers::Bounds::Sphere& sphere, std::vector<unsigned int>& result) const;
+
+			/**
+			 * Items nearest to a point by distance to their boxes.
+			 * @param point Query point.
+			 * @param count Most items.
+			 * @param length Farthest distance.
+			 * @param result List to append distance and item index pairs to, nearest first.
+			 */
+			void nearest(const glm::vec3& point, unsigned int count, float length, std::vector<std::pair<float, unsigned int>>& result) const;
+
+			/**
+			 * Nearest item a ray hits, nodes farther than nearest hit so far are skipped.
+			 * @param ray Query ray.
+			 * @param length Ray length, set to hit distance.
+			 * @param test Exact item test called with item index and ray length, returns hit distance or negative if missed.
+			 * @return Item index or -1 if nothing is hit.
+			 */
+			template<typename T>
+			int raycast(const Helpers::Bounds::Ray& ray, float& length, const T& test) const;
+
+			/**
+			 * Items count.
+			 */
+			unsigned int getCount() const;
+
+			/**
+			 * Nodes count.
+			 */
+			unsigned int getNodesCount() const;
+
+		private:
+			/**
+			 * Tree node, children of a node are stored next to each other.
+			 */
+			struct Node
+			{
+				/**
+				 * Box around node items.
+				 */
+				Helpers::Bounds::Box bounds;
+
+				/**
+				 * First item of node in items list, subtree items are contiguous.
+				 */
+				unsigned int first;
+
+				/**
+				 * Subtree items count.
+				 */
+				unsigned int count;
+
+				/**
+				 * Left child index, right child follows it, zero for leaves.
+				 */
+				unsigned int left;
+			};
+
+			/**
+			 * Split a node until leaves are small or splitting costs more than it saves.
+			 * @param index Node index.
+			 * @param depth Node level.
+			 * @param centers Item box centers.
+			 */
+			void subdivide(unsigned int index, unsigned int depth, const std::vector<glm::vec3>& centers);
+
+			/**
+			 * Sum of inner node surface areas, tree cost measure.
+			 */
+			float getArea() const;
+
+			/**
+			 * Append all items of a subtree.
+			 * @param node Subtree root.
+			 * @param result List to append item indices to.
+			 */
+			void collect(const Node& node, std::vector<unsigned int>& result) const;
+
+			/**
+			 * Tree nodes, root first.
+			 */
+			std::vector<Node> m_nodes;
+
+			/**
+			 * Item indices ordered by leaves.
+			 */
+			std::vector<unsigned int> m_items;
+
+			/**
+			 * Item boxes of last build or refit.
+			 */
+			std::vector<Helpers::Bounds::Box> m_bounds;
+
+			/**
+			 * Tree cost right after build.
+			 */
+			float m_build_area;
+		};
+
+		template<typename T>
+		int Bvh::raycast(const Helpers::Bounds::Ray& ray, float& length, const T& test) const
+		{
+			// nearest item
+			int result = -1;
+
+			// return if tree is empty
+			if (m_nodes.empty()) return result;
+
+			// nodes to visit
+			unsigned int stack[MAX_DEPTH + 2];
+			int top = 0;
+
+			stack[top++] = 0;
+
+			while (top > 0)
+			{
+				const Node& node = m_nodes[stack[--top]];
+
+				// skip subtree if ray misses it before nearest hit
+				if (Helpers::Bounds::intersects(ray, node.bounds, length) < 0.0f) continue;
+
+				if (node.left)
+				{
+					// visit nearer child first
+					float left = Helpers::Bounds::intersects(ray, m_nodes[node.left].bounds, length);
+					float right = Helpers::Bounds::intersects(ray, m_nodes[node.left + 1].bounds, length);
+
+					if (left >= 0.0f && right >= 0.0f)
+					{
+						stack[top++] = (left <= right) ? node.left + 1 : node.left;
+						stack[top++] = (left <= right) ? node.left : node.left + 1;
+					}
+					else if (left >= 0.0f)
+						stack[top++] = node.left;
+					else if (right >= 0.0f)
+						stack[top++] = node.left + 1;
+				}
+				else
+				{
+					for (unsigned int i = node.first; i < node.first + node.count; ++i)
+					{
+						// test item box first
+						if (Helpers::Bounds::intersects(ray, m_bounds[m_items[i]], length) < 0.0f) continue;
+
+						float distance = test(m_items[i], length);
+
+						if (distance >= 0.0f && distance <= length)
+						{
+							length = distance;
+							result = static_cast<int>(m_items[i]);
+						}
+					}
+				}
+			}
+
+			return result;
+		}
+	}
+}
+#endif
\ No newline at end of file
@@ -6,18 +6,24 @@ namespace hawk
 {
 	namespace Objects
 	{
-		Entity::Entity() : onStart(nullptr), onFixedUpdate(nullptr), onUpdate(nullptr), onLateUpdate(nullptr), 
-			enable(true), transform(nullptr), parent(nullptr), m_id(0), m_components_id(0), m_entities_id(0), m_is_world(false), m_is_static(false) {}
+		Entity::Entity() : onStart(nullptr), onFixedUpdate(nullptr), onUpdate(nullptr), onLateUpdate(nullptr), onDestroy(nullptr),
+			enable(true), transform(nullptr), parent(nullptr), m_id(0), m_handle(System::Core::getInstance().scene.pool.getHandle(this)), m_components_id(0), m_entities_id(0), 
+			m_is_world(false), m_is_static(false), m_scene_slot(-1), m_active(true), m_active_stamp(0), m_component_slots() {}
 
 		Entity::Entity(const Entity& other) : onStart(other.onStart), onFixedUpdate(other.onFixedUpdate), onUpdate(other.onUpdate),
-			onLateUpdate(other.onLateUpdate), enable(other.enable), transform(other.transform), parent(other.parent), entities(other.entities),
-			m_id(other.m_id), m_name(other.m_name), m_components_id(other.m_components_id), m_entities_id(other.m_entities_id),
-			m_is_world(other.m_is_world), m_is_static(other.m_is_world) {}
+			onLateUpdate(other.onLateUpdate), onDestroy(other.onDestroy), enable(other.enable), transform(other.transform), parent(other.parent), entities(other.entities),
+			m_id(other.m_id), m_handle(System::Core::getInstance().scene.pool.getHandle(this)), m_name(other.m_name), m_components_id(other.m_components_id), m_entities_id(other.m_entities_id),
+			m_is_world(other.m_is_world), m_is_static(other.m_is_world), m_scene_slot(-1), m_active(true), m_active_stamp(0), m_component_slots() {}
 
-		Entity::Entity(bool is_world) : onStart(nullptr), onFixedUpdate(nullptr), onUpdate(nullptr), onLateUpdate(nullptr), 
-			enable(true), transform(nullptr), parent(nullptr), m_id(0), m_components_id(0), m_entities_id(0), m_is_world(is_world), m_is_static(false) {}
+		Entity::Entity(bool is_world) : onStart(nullptr), onFixedUpdate(nullptr), onUpdate(nullptr), onLateUpdate(nullptr), onDestroy(nullptr),
+			enable(true), transform(nullptr), parent(nullptr), m_id(0), m_handle(System::Core::getInstance().scene.pool.getHandle(this)), m_components_id(0), m_entities_id(0), 
+			m_is_world(is_world), m_is_static(false), m_scene_slot(-1), m_active(true), m_active_stamp(0), m_component_slots() {}
 
-		Entity::~Entity() {}
+		Entity::~Entity()
+		{
+			// remove from scene registries
+			if (m_scene_slot >= 0) System::Core::getInstance().scene.removeEntity(this);
+		}
 
 		void Entity::operator=(const Entity& other)
 		{
@@ -25,6 +31,7 @@ namespace hawk
 			onFixedUpdate = other.onFixedUpdate;
 			onUpdate = other.onUpdate;
 			onLateUpdate = other.onLateUpdate;
+			onDestroy = other.onDestroy;
 			enable = other.enable;
 			transform = other.transform;
 			parent = other.parent;
@@ -37,6 +44,37 @@ namespace hawk
 			m_is_static = other.m_is_static;
 		}
 
+		void* Entity::operator new(size_t size)
+		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			// derived types do not fit pool slots
+			if (size != sizeof(Entity)) return ::operator new(size);
+
+			// pool is not shared with workers of parallel update
+			if (app.scene.isUpdatingParallel()) return EntityPool::allocateDetached();
+
+			return app.scene.pool.allocate();
+		}
+
+		void Entity::operator delete(void* pointer, size_t size)
+		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			// derived types were allocated from global heap
+			if (size != sizeof(Entity))
+			{
+				::operator delete(pointer);
+
+				return;
+			}
+
+			// free after parallel update, pool is not shared with workers
+			app.scene.defer([&app, pointer]() { app.scene.pool.deallocate(pointer); });
+		}
+
 		Entity* Entity::copy()
 		{
 			return new Entity(*this);
@@ -54,6 +92,17 @@ namespace hawk
 
 		void Entity::release()
 		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			// registries and pool are not shared with workers
+			if (app.scene.isUpdatingParallel())
+			{
+				app.scene.defer([this]() { release(); });
+
+				return;
+			}
+
 			// release components
 			for (auto component : components)
 				delete component.second;
@@ -68,12 +117,36 @@ namespace hawk
 
 		void Entity::start()
 		{
-			// return if not enable
-			if (!enable) return;
+			// get core
+			System::Core& app = System::Core::getInstance();
 
-			// send message to components
+			// start after parallel update, registries are not shared with workers
+			if (app.scene.isUpdatingParallel())
+			{
+				app.scene.defer([this]() { start(); });
+
+				return;
+			}
+
+			// register disabled entities without starting them
+			if (!enable)
+			{
+				attach();
+
+				return;
+			}
+
+			// register to scene
+			System::Core::getInstance().scene.addEntity(this);
+
+			// start components and register them for their phases
 			for (auto component : components)
-				component.second->sendMessage("Start");
+			{
+				if (component.second->enable && component.second->hasPhase(Components::Component::Phase::Start))
+					component.second->start();
+
+				registerComponent(component.second);
+			}
 
 			// raise start event
 			if (onStart) (*onStart)(this);
@@ -88,9 +161,9 @@ namespace hawk
 			// return if not enable
 			if (!enable) return;
 
-			// send message to components
+			// call components event
 			for (auto component : components)
-				component.second->sendMessage("FixedUpdate");
+				if (component.second->enable && component.second->hasPhase(Components::Component::Phase::FixedUpdate)) component.second->fixedUpdate();
 
 			// raise fixed update event
 			if (onFixedUpdate) (*onFixedUpdate)(this);
@@ -105,9 +178,9 @@ namespace hawk
 			// return if not enable
 			if (!enable) return;
 
-			// send message to components
+			// call components event
 			for (auto component : components)
-				component.second->sendMessage("Update");
+				if (component.second->enable && component.second->hasPhase(Components::Component::Phase::Update)) component.second->update();
 
 			// raise update event
 			if (onUpdate) (*onUpdate)(this);
@@ -122,9 +195,9 @@ namespace hawk
 			// return if not enable
 			if (!enable) return;
 
-			// send message to components
+			// call components event
 			for (auto component : components)
-				component.second->sendMessage("LateUpdate");
+				if (component.second->enable && component.second->hasPhase(Components::Component::Phase::LateUpdate)) component.second->lateUpdate();
 
 			// raise late update event
 			if (onLateUpdate) (*onLateUpdate)(this);
@@ -139,9 +212,9 @@ namespace hawk
 			// return if not enable
 			if (!enable) return;
 
-			// send message to components
+			// call components event
 			for (auto component : components)
-				component.second->sendMessage("Destroy");
+				if (component.second->enable && component.second->hasPhase(Components::Component::Phase::Destroy)) component.second->destroy();
 
 			// raise destroy event
 			if (onDestroy) (*onDestroy)(this);
@@ -158,28 +231,52 @@ namespace hawk
 				return (std::strcmp(item.second->getName().c_str(), name) == 0);
 			});
 
-			// if component is found
-			if (it != components.end())
-			{
-				// reset component entity
-				it->second->entity = nullptr;
-
-				// remove from list
-				components.erase(it);
-			}
+			// remove if found
+			if (it != components.end()) eraseComponent(it->second);
 		}
 
 		void Entity::clearComponents()
 		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			// change registered entities after parallel update
+			if (m_scene_slot >= 0 && app.scene.isUpdatingParallel())
+			{
+				app.scene.defer([this]() { clearComponents(); });
+
+				return;
+			}
+
+			// remove from scene registries
+			for (auto component : components)
+				System::Core::getInstance().scene.removeComponent(component.second);
+
 			// clear list
 			components.clear();
 
+			// clear type slots
+			std::fill(std::begin(m_component_slots), std::end(m_component_slots), nullptr);
+
 			// reset id
 			m_components_id = 0;
 		}
 
 		Entity* Entity::addEntity(const char* name, Entity* entity)
 		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			// change registered entities after parallel update
+			if (m_scene_slot >= 0 && app.scene.isUpdatingParallel())
+			{
+				std::string label(name);
+
+				app.scene.defer([this, label, entity]() { addEntity(label.c_str(), entity); });
+
+				return entity;
+			}
+
 			// set entity properties
 			entity->parent = this;
 			entity->m_id = m_entities_id++;
@@ -188,11 +285,27 @@ namespace hawk
 			// add to entities
 			entities.insert(entities.end(), std::make_pair(entity->m_id, entity));
 
+			// link pool slots
+			if (m_handle.isValid() && entity->m_handle.isValid()) System::Core::getInstance().scene.pool.link(entity->m_handle.index, m_handle.index);
+
+			// recalculate transform against new parent
+			if (entity->transform) entity->transform->reparent();
+
+			// activity follows new parent
+			System::Core::getInstance().scene.invalidateActive();
+
+			// register to scene if this entity is already registered
+			if (m_scene_slot >= 0) entity->attach();
+
 			return entity;
 		}
 
 		Entity* Entity::addEntity(const char* name, Assets::Model* model)
 		{
+			// change registered entities after parallel update
+			if (m_scene_slot >= 0 && System::Core::getInstance().scene.isUpdatingParallel())
+				return addEntity(name, instantiateSilent(model->getEntity()));
+
 			// new entity
 			Entity* entity = instantiateSilent(model->getEntity());
 
@@ -204,11 +317,36 @@ namespace hawk
 			// add to entities
 			entities.insert(entities.end(), std::make_pair(entity->m_id, entity));
 
+			// link pool slots
+			if (m_handle.isValid() && entity->m_handle.isValid()) System::Core::getInstance().scene.pool.link(entity->m_handle.index, m_handle.index);
+
+			// recalculate transform against new parent
+			if (entity->transform) entity->transform->reparent();
+
+			// activity follows new parent
+			System::Core::getInstance().scene.invalidateActive();
+
+			// register to scene if this entity is already registered
+			if (m_scene_slot >= 0) entity->attach();
+
 			return entity;
 		}
 
 		void Entity::removeEntity(const char* name)
 		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			// change registered entities after parallel update
+			if (m_scene_slot >= 0 && app.scene.isUpdatingParallel())
+			{
+				std::string label(name);
+
+				app.scene.defer([this, label]() { removeEntity(label.c_str()); });
+
+				return;
+			}
+
 			// entity iterator
 			auto it = std::find_if(entities.begin(), entities.end(), [&name](std::pair<unsigned int, Entity*> item) {
 				return (std::strcmp(item.second->getName().c_str(), name) == 0);
@@ -220,6 +358,18 @@ namespace hawk
 				// reset entity parent
 				it->second->parent = nullptr;
 
+				// unlink pool slot
+				if (it->second->m_handle.isValid()) System::Core::getInstance().scene.pool.unlink(it->second->m_handle.index);
+
+				// recalculate transform without parent
+				if (it->second->transform) it->second->transform->reparent();
+
+				// activity no longer follows parent
+				System::Core::getInstance().scene.invalidateActive();
+
+				// remove from scene registries
+				it->second->detach();
+
 				// remove from list
 				entities.erase(it);
 			}
@@ -227,6 +377,21 @@ namespace hawk
 
 		void Entity::clearEntities()
 		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			// change registered entities after parallel update
+			if (m_scene_slot >= 0 && app.scene.isUpdatingParallel())
+			{
+				app.scene.defer([this]() { clearEntities(); });
+
+				return;
+			}
+
+			// unlink pool slots, copies share child lists with their original until reset
+			for (auto entity : entities)
+				if (entity.second->parent == this && entity.second->m_handle.isValid()) System::Core::getInstance().scene.pool.unlink(entity.second->m_handle.index);
+
 			// clear list
 			entities.clear();
 
@@ -247,41 +412,83 @@ namespace hawk
 
 		Entity* Entity::instantiate(Entity* original)
 		{
-			// root entity
-			Entity* root = original->copy();
+			// copy entity tree
+			Entity* root = clone(original);
 
-			// reset entity
-			root->reset();
+			// call start event
+			root->start();
 
-			// copy components
-			for (auto component : original->components)
-				root->addComponent(component.second->getName().c_str(), component.second->copy());
+			return root;
+		}
 
-			// copy entities
-			for (auto entity : original->entities)
+		std::vector<Entity*> Entity::instantiate(Entity* original, unsigned int count)
+		{
+			// flatten prefab breadth first so parents come before children
+			std::vector<Entity*> nodes(1, original);
+			std::vector<int> parents(1, -1);
+
+			for (size_t i = 0; i < nodes.size(); ++i)
+			{
+				for (auto entity : nodes[i]->entities)
+				{
+					nodes.push_back(entity.second);
+					parents.push_back(static_cast<int>(i));
+				}
+			}
+
+			// reserve pool slots for all copies, copies made during parallel update are detached
+			if (!System::Core::getInstance().scene.isUpdatingParallel())
+				System::Core::getInstance().scene.pool.reserve(static_cast<unsigned int>(nodes.size()) * count);
+
+			// list of copies
+			std::vector<Entity*> roots;
+
+			roots.reserve(count);
+
+			// copies of current prefab
+			std::vector<Entity*> copies(nodes.size());
+
+			for (unsigned int c = 0; c < count; ++c)
 			{
-				// child entity
-				Entity* child = entity.second->copy();
+				for (size_t i = 0; i < nodes.size(); ++i)
+				{
+					const Entity* node = nodes[i];
+
+					// new entity, properties are set directly instead of copying child and component lists to clear them
+					Entity* entity = new Entity();
 
-				// reset child
-				child->reset();
+					entity->onStart = node->onStart;
+					entity->onFixedUpdate = node->onFixedUpdate;
+					entity->onUpdate = node->onUpdate;
+					entity->onLateUpdate = node->onLateUpdate;
+					entity->onDestroy = node->onDestroy;
+					entity->enable = node->enable;
+					entity->m_id = node->m_id;
+					entity->m_name = node->m_name;
 
-				// copy components
-				for (auto component : entity.second->components)
-					child->addComponent(component.second->getName().c_str(), component.second->copy());
+					// copy components, mesh and material assets are shared
+					for (auto component : node->components)
+						entity->addComponent(component.second->getName().c_str(), component.second->copy());
 
-				// add to child entities
-				root->addEntity(child->getName().c_str(), child);
+					// add to parent copy
+					if (parents[i] >= 0) copies[parents[i]]->addEntity(node->m_name.c_str(), entity);
 
-				// recurse copy entities
-				for (auto child_child : entity.second->entities)
-					child->addEntity(child_child.second->getName().c_str(), instantiate(child_child.second));
+					copies[i] = entity;
+				}
+
+				roots.push_back(copies[0]);
 			}
 
-			// call start event
-			root->start();
+			// call start event once per copy
+			for (auto root : roots)
+				root->start();
 
-			return root;
+			return roots;
+		}
+
+		Entity* Entity::resolve(const EntityHandle& handle)
+		{
+			return System::Core::getInstance().scene.pool.resolve(handle);
 		}
 
 		void Entity::destroy(Entity* entity)
@@ -292,9 +499,23 @@ namespace hawk
 
 		void Entity::destroyImmediate(Entity* entity)
 		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			// destroy after parallel update, registries are not shared with workers
+			if (app.scene.isUpdatingParallel())
+			{
+				app.scene.defer([entity]() { destroyImmediate(entity); });
+
+				return;
+			}
+
 			// entity parent
 			Entity* parent = entity->parent;
 
+			// entity id, entity memory is freed on release
+			unsigned int id = entity->getId();
+
 			// destroy entity
 			entity->destroy();
 
@@ -305,19 +526,29 @@ namespace hawk
 			if (parent)
 			{
 				// remove from parent entities
-				if (parent->entities.count(entity->getId()))
-					parent->entities.erase(entity->getId());
+				if (parent->entities.count(id))
+					parent->entities.erase(id);
 			}
 		}
 
 		void Entity::setStatic(bool state, bool recursive)
 		{
-			// set self dynamic
-			m_is_static = state;
+			// get core
+			System::Core& app = System::Core::getInstance();
 
-			// set childeren dynamic
-			for (auto entity : entities)
-				entity.second->setStatic(state, recursive);
+			// subtree may span other workers
+			if (app.scene.isUpdatingParallel())
+			{
+				app.scene.defer([this, state, recursive]() { setStatic(state, recursive); });
+
+				return;
+			}
+
+			// set subtree state
+			applyStatic(state, recursive);
+
+			// merge or split static geometry of subtree, batches drawing a single entity made dynamic are split as well
+			if (recursive || (!state && StaticBatcher::isMerged(this))) app.scene.addToStaticBatches(this, state);
 		}
 
 		unsigned int Entity::getId() const
@@ -325,6 +556,11 @@ namespace hawk
 			return m_id;
 		}
 
+		const EntityHandle& Entity::getHandle() const
+		{
+			return m_handle;
+		}
+
 		const std::string& Entity::getName() const
 		{
 			return m_name;
@@ -340,7 +576,113 @@ namespace hawk
 			return m_is_static;
 		}
 
+		bool Entity::isActive() const
+		{
+			// current scene activity stamp
+			unsigned int stamp = System::Core::getInstance().scene.getActiveStamp();
+
+			// refresh cache from parent, parents cache theirs on the way up
+			if (m_active_stamp != stamp)
+			{
+				// caches are shared by workers of parallel update, walk without writing them
+				if (System::Core::getInstance().scene.isUpdatingParallel()) return enable && (!parent || parent->isActive());
+
+				m_active = enable && (!parent || parent->isActive());
+				m_active_stamp = stamp;
+			}
+
+			return m_active;
+		}
+
+		void Entity::setActive(bool state)
+		{
+			enable = state;
+
+			// drop cached activity of subtree
+			System::Core::getInstance().scene.invalidateActive();
+		}
+
+		void Entity::registerComponent(Components::Component* component)
+		{
+			// register only if entity is already in scene
+			if (m_scene_slot >= 0) System::Core::getInstance().scene.addComponent(component);
+		}
+
+		void Entity::attach()
+		{
+			// register to scene
+			System::Core::getInstance().scene.addEntity(this);
+
+			// register components
+			for (auto component : components)
+				registerComponent(component.second);
+
+			// attach child entities
+			for (auto entity : entities)
+				entity.second->attach();
+		}
+
+		Components::Component* Entity::findComponent(unsigned int type_id) const
+		{
+			// first component with type id
+			for (auto component : components)
+				if (component.second->m_type_id == type_id) return component.second;
+
+			return nullptr;
+		}
+
+		void Entity::eraseComponent(Components::Component* component)
+		{
+			// remove from scene registries
+			System::Core::getInstance().scene.removeComponent(component);
+
+			// remove from list
+			components.erase(component->m_id);
+
+			// refill type slot with next component of same type
+			if (component->m_type_id < COMPONENT_SLOTS && m_component_slots[component->m_type_id] == component)
+				m_component_slots[component->m_type_id] = findComponent(component->m_type_id);
+
+			// reset transform
+			if (transform == component) transform = nullptr;
+
+			// reset component entity
+			component->entity = nullptr;
+		}
+
+		void Entity::applyStatic(bool state, bool recursive)
+		{
+			// set self dynamic
+			m_is_static = state;
+
+			// set childeren dynamic, pool links skip derived, detached and stack entities
+			for (auto entity : entities)
+				entity.second->applyStatic(state, recursive);
+		}
+
+		void Entity::detach()
+		{
+			// get core
+			System::Core& app = System::Core::getInstance();
+
+			// remove from scene
+			app.scene.removeEntity(this);
+
+			// remove components
+			for (auto component : components)
+				app.scene.removeComponent(component.second);
+
+			// detach child entities
+			for (auto entity : entities)
+				entity.second->detach();
+		}
+
 		Entity* Entity::instantiateSilent(Entity* original)
+		{
+			return clone(original);
+		}
+
+		Entity* Entity::clone(Entity* original)
 		{
 			// root entity
 			Entity* root = original->copy();
@@ -354,24 +696,7 @@ namespace hawk
 
 			// copy entities
 			for (auto entity : original->entities)
-			{
-				// child entity
-				Entity* child = entity.second->copy();
-
-				// reset child
-				child->reset();
-
-				// copy components
-				for (auto component : entity.second->components)
-					child->addComponent(component.second->getName().c_str(), component.second->copy());
-
-				// add to child entities
-				root->addEntity(child->getName().c_str(), child);
-
-				// recurse copy entities
-				for (auto child_child : entity.second->entities)
-					child->addEntity(child_child.second->getName().c_str(), instantiate(child_child.second));
-			}
+				root->addEntity(entity.second->getName().c_str(), clone(entity.second));
 
 			return root;
 		}
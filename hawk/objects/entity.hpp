@@ -3,10 +3,13 @@
 
 // stl
 #include <map>
+#include <type_traits>
+#include <vector>
 
 // local
 #include "../components/component.hpp"
 #include "../components/transform.hpp"
+#include "entity_pool.hpp"
 
 namespace hawk
 {
@@ -25,7 +28,17 @@ namespace hawk
 		 */
 		class Entity
 		{
+			/**
+			 * Scene friend class.
+			 */
+			friend class hawk::Managers::Scene;
+
 		public:
+			/**
+			 * Count of component type ids which have a direct lookup slot.
+			 */
+			static constexpr unsigned int COMPONENT_SLOTS = 32;
+
 			/**
 			 * Constructor.
 			 */
@@ -54,6 +67,19 @@ namespace hawk
 			 */
 			virtual void operator=(const Entity& other);
 
+			/**
+			 * Allocate entity memory from scene entity pool.
+			 * @param size Object size.
+			 */
+			static void* operator new(size_t size);
+
+			/**
+			 * Free entity memory back to scene entity pool.
+			 * @param pointer Object memory.
+			 * @param size Object size.
+			 */
+			static void operator delete(void* pointer, size_t size);
+
 			/**
 			 * Make a copy from this object.
 			 */
@@ -110,6 +136,25 @@ namespace hawk
 			 */
 			void removeComponent(const char* name);
 
+			/**
+			 * Remove first component of a type from entity's components.
+			 */
+			template<typename T>
+			void removeComponent();
+
+			/**
+			 * Get first component of a type, components of derived classes have their own type and are not returned.
+			 * @return A pointer to component or nullptr.
+			 */
+			template<typename T>
+			T* getComponent() const;
+
+			/**
+			 * Does entity have a component of a type?
+			 */
+			template<typename T>
+			bool hasComponent() const;
+
 			/**
 			 * Clear components.
 			 */
@@ -154,6 +199,14 @@ namespace hawk
 			 */
 			static Entity* instantiate(Entity* original);
 
+			/**
+			 * Instantiate many copies of an entity, prefab is flattened once and start is called once per copy.
+			 * @param original Original entity to be copied from.
+			 * @param count Copies count.
+			 * @return List of newly made entities.
+			 */
+			static std::vector<Entity*> instantiate(Entity* original, unsigned int count);
+
 			/**
 			 * Destroy an entity on end of frame.
 			 * @param entity Entity to be destroyed.
@@ -167,7 +220,15 @@ namespace hawk
 			static void destroyImmediate(Entity* entity);
 
 			/**
-			 * Set entity and its childeren movement dynamic.
+			 * Resolve an entity handle.
+			 * @param handle Entity handle.
+			 * @return A pointer to entity or nullptr if entity is destroyed.
+			 */
+			static Entity* resolve(const EntityHandle& handle);
+
+			/**
+			 * Set entity and its childeren movement dynamic, recursive calls merge or split static geometry of subtree at end of frame.
+			 * Making a merged entity dynamic splits batches drawing it at end of frame.
 			 * @param state True or False.
 			 * @param recursive Set child entities dynamic as well.
 			 */
@@ -178,6 +239,11 @@ namespace hawk
 			 */
 			unsigned int getId() const;
 
+			/**
+			 * Entity handle, stays unique over the lifetime of the scene.
+			 */
+			const EntityHandle& getHandle() const;
+
 			/**
 			 * Entity name.
 			 */
@@ -193,6 +259,17 @@ namespace hawk
 			 */
 			bool isStatic() const;
 
+			/**
+			 * Are entity and all of its parents enable? Result is cached until scene activity changes.
+			 */
+			bool isActive() const;
+
+			/**
+			 * Enable or disable entity, cached activity of all entities is refreshed.
+			 * @param state True or False.
+			 */
+			void setActive(bool state);
+
 			/**
 			 * Start callback type.
 			 */
@@ -276,11 +353,59 @@ namespace hawk
 			 */
 			Entity* instantiateSilent(Entity* original);
 
+			/**
+			 * Copy an entity tree without calling initial events like start.
+			 * @param original Original entity to be copied from.
+			 * @return A pointer to newly made entity.
+			 */
+			static Entity* clone(Entity* original);
+
+			/**
+			 * Register a component to scene registries if entity is started.
+			 * @param component Component object.
+			 */
+			void registerComponent(Components::Component* component);
+
+			/**
+			 * Register entity tree to scene without raising start events.
+			 */
+			void attach();
+
+			/**
+			 * Remove entity tree from scene registries.
+			 */
+			void detach();
+
+			/**
+			 * Find first component of a type id.
+			 * @param type_id Component type id.
+			 * @return A pointer to component or nullptr.
+			 */
+			Components::Component* findComponent(unsigned int type_id) const;
+
+			/**
+			 * Remove a component from entity's components.
+			 * @param component Component object.
+			 */
+			void eraseComponent(Components::Component* component);
+
+			/**
+			 * Set movement state of entity and its childeren.
+			 * @param state True or False.
+			 * @param recursive Set child entities dynamic as well.
+			 */
+			void applyStatic(bool state, bool recursive);
+
 			/**
 			 * Entity id.
 			 */
 			unsigned int m_id;
 
+			/**
+			 * Entity handle.
+			 */
+			EntityHandle m_handle;
+
 			/**
 			 * Entity name.
 			 */
@@ -305,12 +430,33 @@ namespace hawk
 			 * Does entity move?
 			 */
 			bool m_is_static;
+
+			/**
+			 * Slot index in scene entities, -1 if not registered.
+			 */
+			int m_scene_slot;
+
+			/**
+			 * Cached activity.
+			 */
+			mutable bool m_active;
+
+			/**
+			 * Scene activity stamp of cached activity.
+			 */
+			mutable unsigned int m_active_stamp;
+
+			/**
+			 * First component of each type id.
+			 */
+			Components::Component* m_component_slots[COMPONENT_SLOTS];
 		};
 
 		template<typename T>
 		T* Entity::addComponent(const char* name, T* component)
 		{
-			// set component properties
+			// set component properties, type id of exact class so typed lookups never see another class
+			component->m_type_id = Components::Component::typeId(typeid(*component));
 			component->entity = this;
 			component->m_id = m_components_id++;
 			component->m_name = name;
@@ -318,12 +464,50 @@ namespace hawk
 			// add to components
 			components.insert(components.end(), std::make_pair(component->m_id, component));
 
+			// fill type slot
+			if (component->m_type_id < COMPONENT_SLOTS && !m_component_slots[component->m_type_id])
+				m_component_slots[component->m_type_id] = component;
+
 			// set transform component
-			if (std::strcmp(component->getType(), "Transform") == 0)
-				transform = dynamic_cast<Components::Transform*>(component);
+			if (component->m_type_id == Components::Transform::TYPE_ID)
+				transform = static_cast<Components::Transform*>(static_cast<Components::Component*>(component));
+
+			// register to scene if entity is already started
+			registerComponent(component);
 
 			return component;
 		}
+
+		template<typename T>
+		void Entity::removeComponent()
+		{
+			// component of type
+			T* component = getComponent<T>();
+
+			// remove if found
+			if (component) eraseComponent(component);
+		}
+
+		template<typename T>
+		T* Entity::getComponent() const
+		{
+			static_assert(std::is_base_of<Components::Component, T>::value, "Type must be a component.");
+
+			// components are added with type id of their exact class
+			unsigned int type_id = Components::Component::typeId<T>();
+
+			// direct slot lookup
+			if (type_id < COMPONENT_SLOTS)
+				return static_cast<T*>(m_component_slots[type_id]);
+
+			return static_cast<T*>(findComponent(type_id));
+		}
+
+		template<typename T>
+		bool Entity::hasComponent() const
+		{
+			return getComponent<T>() != nullptr;
+		}
 	}
 }
 #endif
\ No newline at end of file
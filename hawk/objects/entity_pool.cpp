@@ -0,0 +1,248 @@
+#include "entity_pool.hpp"
+#include "entity.hpp"
+#include <new>
+
+namespace hawk
+{
+	namespace Objects
+	{
+		/**
+		 * Slot header size, keeps entities aligned.
+		 */
+		static constexpr size_t header_size = alignof(Entity) > sizeof(unsigned int) ? alignof(Entity) : sizeof(unsigned int);
+
+		/**
+		 * Slot size with header.
+		 */
+		static constexpr size_t slot_size = header_size + sizeof(Entity);
+
+		/**
+		 * Slot memory returned by last allocate call of this thread, not constructed yet.
+		 */
+		static thread_local const void* allocated = nullptr;
+
+		EntityPool::EntityPool() : m_count(0) {}
+
+		EntityPool::~EntityPool()
+		{
+			// free chunks
+			for (auto chunk : m_chunks)
+				::operator delete(chunk);
+		}
+
+		void* EntityPool::allocate()
+		{
+			// grow if there is no free slot
+			if (m_free.empty()) grow();
+
+			// take a free slot
+			unsigned int index = m_free.back();
+
+			m_free.pop_back();
+
+			// set alive
+			m_alive[index] = 1;
+
+			m_count++;
+
+			// entity constructor asks for its handle next
+			allocated = get(index);
+
+			return get(index);
+		}
+
+		void* EntityPool::allocateDetached()
+		{
+			// same header as slots, holding no index
+			unsigned char* memory = static_cast<unsigned char*>(::operator new(slot_size));
+
+			new (memory) unsigned int(EntityHandle::invalid);
+
+			return memory + header_size;
+		}
+
+		void EntityPool::reserve(unsigned int count)
+		{
+			// grow until enough slots are free
+			while (m_free.size() < count)
+				grow();
+		}
+
+		bool EntityPool::deallocate(void* pointer)
+		{
+			// free detached memory
+			if (*reinterpret_cast<const unsigned int*>(static_cast<const unsigned char*>(pointer) - header_size) == EntityHandle::invalid)
+			{
+				::operator delete(static_cast<unsigned char*>(pointer) - header_size);
+
+				return true;
+			}
+
+			// slot index
+			unsigned int index = indexOf(pointer);
+
+			// return if memory does not belong to an alive slot
+			if (index == EntityHandle::invalid || !m_alive[index]) return false;
+
+			// detach from hierarchy links
+			unlink(index);
+
+			// children become roots
+			for (unsigned int child = m_first_children[index]; child != EntityHandle::invalid;)
+			{
+				unsigned int next = m_next_siblings[child];
+
+				m_parents[child] = EntityHandle::invalid;
+				m_next_siblings[child] = EntityHandle::invalid;
+				m_previous_siblings[child] = EntityHandle::invalid;
+
+				child = next;
+			}
+
+			m_first_children[index] = EntityHandle::invalid;
+
+			// invalidate handles
+			m_generations[index]++;
+			m_alive[index] = 0;
+
+			// reuse slot
+			m_free.push_back(index);
+
+			m_count--;
+
+			return true;
+		}
+
+		EntityHandle EntityPool::getHandle(const Entity* entity) const
+		{
+			// not pooled, like entities of derived types, detached or on stack
+			if (!entity || entity != allocated) return { EntityHandle::invalid, 0 };
+
+			allocated = nullptr;
+
+			// slot index
+			unsigned int index = indexOf(entity);
+
+			return { index, m_generations[index] };
+		}
+
+		Entity* EntityPool::resolve(const EntityHandle& handle) const
+		{
+			// return if slot is out of range, free or reused
+			if (handle.index >= m_generations.size() || !m_alive[handle.index] || m_generations[handle.index] != handle.generation) return nullptr;
+
+			return get(handle.index);
+		}
+
+		void EntityPool::link(unsigned int index, unsigned int parent)
+		{
+			// remove from current parent
+			unlink(index);
+
+			// push to front of parent children
+			unsigned int first = m_first_children[parent];
+
+			m_parents[index] = parent;
+			m_next_siblings[index] = first;
+			m_previous_siblings[index] = EntityHandle::invalid;
+
+			if (first != EntityHandle::invalid) m_previous_siblings[first] = index;
+
+			m_first_children[parent] = index;
+		}
+
+		void EntityPool::unlink(unsigned int index)
+		{
+			// parent slot
+			unsigned int parent = m_parents[index];
+
+			// return if root
+			if (parent == EntityHandle::invalid) return;
+
+			// sibling slots
+			unsigned int previous = m_previous_siblings[index];
+			unsigned int next = m_next_siblings[index];
+
+			// bridge siblings
+			if (previous != EntityHandle::invalid)
+				m_next_siblings[previous] = next;
+			else
+				m_first_children[parent] = next;
+
+			if (next != EntityHandle::invalid) m_previous_siblings[next] = previous;
+
+			// reset links
+			m_parents[index] = EntityHandle::invalid;
+			m_next_siblings[index] = EntityHandle::invalid;
+			m_previous_siblings[index] = EntityHandle::invalid;
+		}
+
+		unsigned int EntityPool::getParent(unsigned int index) const
+		{
+			return m_parents[index];
+		}
+
+		unsigned int EntityPool::getFirstChild(unsigned int index) const
+		{
+			return m_first_children[index];
+		}
+
+		unsigned int EntityPool::getNextSibling(unsigned int index) const
+		{
+			return m_next_siblings[index];
+		}
+
+		Entity* EntityPool::get(unsigned int index) const
+		{
+			return reinterpret_cast<Entity*>(m_chunks[index / CHUNK_SIZE] + (index % CHUNK_SIZE) * slot_size + header_size);
+		}
+
+		unsigned int EntityPool::getCount() const
+		{
+			return m_count;
+		}
+
+		unsigned int EntityPool::getCapacity() const
+		{
+			return static_cast<unsigned int>(m_generations.size());
+		}
+
+		void EntityPool::grow()
+		{
+			// first index of new chunk
+			unsigned int first = static_cast<unsigned int>(m_chunks.size()) * CHUNK_SIZE;
+
+			// allocate chunk
+			m_chunks.push_back(static_cast<unsigned char*>(::operator new(CHUNK_SIZE * slot_size)));
+
+			// write slot headers
+			for (unsigned int i = 0; i < CHUNK_SIZE; ++i)
+				new (m_chunks.back() + i * slot_size) unsigned int(first + i);
+
+			// grow slot lists
+			m_generations.resize(first + CHUNK_SIZE, 0);
+			m_alive.resize(first + CHUNK_SIZE, 0);
+			m_parents.resize(first + CHUNK_SIZE, EntityHandle::invalid);
+			m_first_children.resize(first + CHUNK_SIZE, EntityHandle::invalid);
+			m_next_siblings.resize(first + CHUNK_SIZE, EntityHandle::invalid);
+			m_previous_siblings.resize(first + CHUNK_SIZE, EntityHandle::invalid);
+
+			// push new slots in reverse so lower slots are taken first
+			m_free.reserve(m_free.size() + CHUNK_SIZE);
+
+			for (unsigned int i = 0; i < CHUNK_SIZE; ++i)
+				m_free.push_back(first + CHUNK_SIZE - 1 - i);
+		}
+
+		unsigned int EntityPool::indexOf(const void* pointer) const
+		{
+			// index in slot header
+			unsigned int index = *reinterpret_cast<const unsigned int*>(static_cast<const unsigned char*>(pointer) - header_size);
+
+			// return if header does not point back to pointer
+			if (index >= m_generations.size() || get(index) != pointer) return EntityHandle::invalid;
+
+			return index;
+		}
+	}
+}
\ No newline at end of file
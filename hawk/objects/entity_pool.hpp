@@ -0,0 +1,246 @@
+#ifndef HAWK_OBJECTS_ENTITY_POOL_H
+#define HAWK_OBJECTS_ENTITY_POOL_H
+
+// stl
+#include <vector>
+#include <cstddef>
+
+namespace hawk
+{
+	namespace Objects
+	{
+		/**
+		 * Entity forward declaration.
+		 */
+		class Entity;
+
+		/**
+		 * Generational entity handle.
+		 */
+		struct EntityHandle
+		{
+			/**
+			 * Slot index in entity pool.
+			 */
+			unsigned int index;
+
+			/**
+			 * Slot generation, handle is stale once slot generation moves on.
+			 */
+			unsigned int generation;
+
+			/**
+			 * Is handle pointing to a pool slot?
+			 */
+			bool isValid() const
+			{
+				return index != invalid;
+			}
+
+			/**
+			 * Invalid slot index.
+			 */
+			static constexpr unsigned int invalid = 0xFFFFFFFF;
+		};
+
+		/**
+		 * Equality operator.
+		 * @param a First handle.
+		 * @param b Second handle.
+		 */
+		inline bool operator==(const EntityHandle& a, const EntityHandle& b)
+		{
+			return a.index == b.index && a.generation == b.generation;
+		}
+
+		/**
+		 * Inequality operator.
+		 * @param a First handle.
+		 * @param b Second handle.
+		 */
+		inline bool operator!=(const EntityHandle& a, const EntityHandle& b)
+		{
+			return !(a == b);
+		}
+
+		/**
+		 * Contiguous entity storage. Entities are allocated in fixed size chunks, freed slots are reused and resolved through generational handles.
+		 * Each slot starts with a header holding its index, so pooled pointers map to slots without searching chunks.
+		 */
+		class EntityPool
+		{
+		public:
+			/**
+			 * Entities per chunk.
+			 */
+			static constexpr unsigned int CHUNK_SIZE = 256;
+
+			/**
+			 * Constructor.
+			 */
+			EntityPool();
+
+			/**
+			 * Constructor.
+			 * @param other Other object.
+			 */
+			EntityPool(const EntityPool& other) = delete;
+
+			/**
+			 * Destructor.
+			 */
+			~EntityPool();
+
+			/**
+			 * Assignment operator.
+			 * @param other Other object.
+			 */
+			void operator=(const EntityPool& other) = delete;
+
+			/**
+			 * Allocate memory for an entity.
+			 * @return Slot memory.
+			 */
+			void* allocate();
+
+			/**
+			 * Allocate entity memory outside of chunks, used while slots can't be taken like on worker threads. Entity gets no handle.
+			 * @return Entity memory, freed by deallocate.
+			 */
+			static void* allocateDetached();
+
+			/**
+			 * Make sure a count of entities can be allocated without growing.
+			 * @param count Entities count.
+			 */
+			void reserve(unsigned int count);
+
+			/**
+			 * Free entity memory and invalidate its handles.
+			 * @param pointer Memory returned by allocate or allocateDetached.
+			 * @return False if memory does not belong to an alive slot.
+			 */
+			bool deallocate(void* pointer);
+
+			/**
+			 * Handle of an entity being constructed, entities are pooled only if they are made in memory of last allocate call on this thread.
+			 * @param entity Entity object.
+			 * @return Entity handle, invalid if entity is not pooled.
+			 */
+			EntityHandle getHandle(const Entity* entity) const;
+
+			/**
+			 * Resolve a handle.
+			 * @param handle Entity handle.
+			 * @return A pointer to entity or nullptr if handle is stale.
+			 */
+			Entity* resolve(const EntityHandle& handle) const;
+
+			/**
+			 * Link a slot under a parent slot. Links mirror entity child lists for pooled entities only, entities are traversed through their child lists.
+			 * @param index Child slot index.
+			 * @param parent Parent slot index.
+			 */
+			void link(unsigned int index, unsigned int parent);
+
+			/**
+			 * Unlink a slot from its parent slot.
+			 * @param index Slot index.
+			 */
+			void unlink(unsigned int index);
+
+			/**
+			 * Parent slot index or EntityHandle::invalid.
+			 * @param index Slot index.
+			 */
+			unsigned int getParent(unsigned int index) const;
+
+			/**
+			 * First child slot index or EntityHandle::invalid.
+			 * @param index Slot index.
+			 */
+			unsigned int getFirstChild(unsigned int index) const;
+
+			/**
+			 * Next sibling slot index or EntityHandle::invalid.
+			 * @param index Slot index.
+			 */
+			unsigned int getNextSibling(unsigned int index) const;
+
+			/**
+			 * Entity in a slot.
+			 * @param index Slot index.
+			 */
+			Entity* get(unsigned int index) const;
+
+			/**
+			 * Count of alive entities.
+			 */
+			unsigned int getCount() const;
+
+			/**
+			 * Count of slots.
+			 */
+			unsigned int getCapacity() const;
+
+		private:
+			/**
+			 * Allocate one more chunk of slots.
+			 */
+			void grow();
+
+			/**
+			 * Slot index of a pooled pointer, read from slot header.
+			 * @param pointer Slot memory.
+			 * @return Slot index or EntityHandle::invalid.
+			 */
+			unsigned int indexOf(const void* pointer) const;
+
+			/**
+			 * Memory chunks.
+			 */
+			std::vector<unsigned char*> m_chunks;
+
+			/**
+			 * Slot generations.
+			 */
+			std::vector<unsigned int> m_generations;
+
+			/**
+			 * Slot alive flags.
+			 */
+			std::vector<unsigned char> m_alive;
+
+			/**
+			 * Parent slot indices.
+			 */
+			std::vector<unsigned int> m_parents;
+
+			/**
+			 * First child slot indices.
+			 */
+			std::vector<unsigned int> m_first_children;
+
+			/**
+			 * Next sibling slot indices.
+			 */
+			std::vector<unsigned int> m_next_siblings;
+
+			/**
+			 * Previous sibling slot indices.
+			 */
+			std::vector<unsigned int> m_previous_siblings;
+
+			/**
+			 * Free slot indices.
+			 */
+			std::vector<unsigned int> m_free;
+
+			/**
+			 * Count of alive entities.
+			 */
+			unsigned int m_count;
+		};
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include "geometry_arena.hpp"
+#include "../assets/mesh.hpp"
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace hawk
+{
+	namespace Objects
+	{
+		GeometryArena::GeometryArena() : m_vao(0), m_vertices({ 0, sizeof(Assets::Mesh::Vertex), 0, 0 }), m_indices({ 0, sizeof(unsigned int), 0, 0 }) {}
+
+		GeometryArena::~GeometryArena() {}
+
+		bool GeometryArena::initialize(unsigned int vertices, unsigned int indices)
+		{
+			// return if capacities are empty
+			if (vertices == 0 || indices == 0) return false;
+
+			// make vertex array of mesh vertex layout, vertices are read through binding 0
+			glCreateVertexArrays(1, &m_vao);
+
+			// set vertex position
+			glEnableVertexArrayAttrib(m_vao, 0);
+			glVertexArrayAttribFormat(m_vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(Assets::Mesh::Vertex, position));
+			glVertexArrayAttribBinding(m_vao, 0, 0);
+
+			// set vertex texture
+			glEnableVertexArrayAttrib(m_vao, 1);
+			glVertexArrayAttribFormat(m_vao, 1, 2, GL_FLOAT, GL_FALSE, offsetof(Assets::Mesh::Vertex, uv));
+			glVertexArrayAttribBinding(m_vao, 1, 0);
+
+			// set vertex normal
+			glEnableVertexArrayAttrib(m_vao, 2);
+			glVertexArrayAttribFormat(m_vao, 2, 3, GL_FLOAT, GL_FALSE, offsetof(Assets::Mesh::Vertex, normal));
+			glVertexArrayAttribBinding(m_vao, 2, 0);
+
+			// set vertex normal tangent
+			glEnableVertexArrayAttrib(m_vao, 3);
+			glVertexArrayAttribFormat(m_vao, 3, 3, GL_FLOAT, GL_FALSE, offsetof(Assets::Mesh::Vertex, tangent));
+			glVertexArrayAttribBinding(m_vao, 3, 0);
+
+			// set vertex normal bitangent
+			glEnableVertexArrayAttrib(m_vao, 4);
+			glVertexArrayAttribFormat(m_vao, 4, 3, GL_FLOAT, GL_FALSE, offsetof(Assets::Mesh::Vertex, bitangent));
+			glVertexArrayAttribBinding(m_vao, 4, 0);
+
+			// make buffers, growing empty pools only makes them
+			if (!grow(m_vertices, vertices) || !grow(m_indices, indices))
+			{
+				deinitialize();
+
+				return false;
+			}
+
+			return true;
+		}
+
+		void GeometryArena::deinitialize()
+		{
+			// free vertex array
+			if (m_vao)
+			{
+				glDeleteVertexArrays(1, &m_vao);
+
+				m_vao = 0;
+			}
+
+			// free buffers
+			for (Pool* pool : { &m_vertices, &m_indices })
+			{
+				if (pool->buffer) glDeleteBuffers(1, &pool->buffer);
+
+				pool->buffer = 0;
+				pool->capacity = 0;
+				pool->used = 0;
+				pool->free.clear();
+			}
+
+			m_allocations.clear();
+		}
+
+		bool GeometryArena::allocate(const void* vertices, unsigned int vertices_count, const unsigned int* indices, unsigned int indices_count, unsigned int& base_vertex, unsigned int& first_index)
+		{
+			// return if arena is not made or there is nothing to upload
+			if (!m_vao || vertices_count == 0) return false;
+
+			base_vertex = 0;
+			first_index = 0;
+
+			// take vertices range
+			if (!take(m_vertices, vertices_count, base_vertex)) return false;
+
+			// take indices range
+			if (indices_count && !take(m_indices, indices_count, first_index))
+			{
+				give(m_vertices, base_vertex, vertices_count);
+
+				return false;
+			}
+
+			// upload
+			glNamedBufferSubData(m_vertices.buffer, static_cast<GLintptr>(base_vertex) * m_vertices.stride, static_cast<GLsizeiptr>(vertices_count) * m_vertices.stride, vertices);
+
+			if (indices_count) glNamedBufferSubData(m_indices.buffer, static_cast<GLintptr>(first_index) * m_indices.stride, static_cast<GLsizeiptr>(indices_count) * m_indices.stride, indices);
+
+			// first owner
+			m_allocations[base_vertex] = { 1, vertices_count, first_index, indices_count };
+
+			return true;
+		}
+
+		void GeometryArena::retain(unsigned int base_vertex)
+		{
+			auto allocation = m_allocations.find(base_vertex);
+
+			if (allocation != m_allocations.end()) allocation->second.references++;
+		}
+
+		void GeometryArena::free(unsigned int base_vertex)
+		{
+			// return if arena is already freed or ranges are not allocated
+			auto allocation = m_allocations.find(base_vertex);
+
+			if (!m_vao || allocation == m_allocations.end()) return;
+
+			// return if other meshes still draw ranges
+			if (--allocation->second.references > 0) return;
+
+			// give ranges back
+			give(m_vertices, base_vertex, allocation->second.vertices_count);
+
+			if (allocation->second.indices_count) give(m_indices, allocation->second.first_index, allocation->second.indices_count);
+
+			m_allocations.erase(allocation);
+		}
+
+		bool GeometryArena::isReady() const
+		{
+			return m_vao != 0;
+		}
+
+		unsigned int GeometryArena::getVao() const
+		{
+			return m_vao;
+		}
+
+		unsigned int GeometryArena::getUsedVertices() const
+		{
+			return m_vertices.used;
+		}
+
+		unsigned int GeometryArena::getUsedIndices() const
+		{
+			return m_indices.used;
+		}
+
+		bool GeometryArena::take(Pool& pool, unsigned int count, unsigned int& offset)
+		{
+			// first free range which fits
+			auto it = pool.free.begin();
+
+			while (it != pool.free.end() && it->second < count) ++it;
+
+			// grow if none fits, trailing free range then holds count
+			if (it == pool.free.end())
+			{
+				if (!grow(pool, pool.capacity + count)) return false;
+
+				it = pool.free.begin();
+
+				while (it != pool.free.end() && it->second < count) ++it;
+
+				if (it == pool.free.end()) return false;
+			}
+
+			// cut range from front of free range
+			offset = it->first;
+
+			unsigned int rest = it->second - count;
+
+			pool.free.erase(it);
+
+			if (rest) pool.free[offset + count] = rest;
+
+			pool.used += count;
+
+			return true;
+		}
+
+		void GeometryArena::give(Pool& pool, unsigned int offset, unsigned int count)
+		{
+			// return if range is outside pool
+			if (offset + count > pool.capacity) return;
+
+			// next free range and previous one
+			auto next = pool.free.lower_bound(offset);
+			auto previous = next == pool.free.begin() ? pool.free.end() : std::prev(next);
+
+			pool.used -= count;
+
+			// merge with next range
+			if (next != pool.free.end() && next->first == offset + count)
+			{
+				count += next->second;
+
+				pool.free.erase(next);
+			}
+
+			// merge with previous range
+			if (previous != pool.free.end() && previous->first + previous->second == offset)
+			{
+				previous->second += count;
+
+				return;
+			}
+
+			pool.free[offset] = count;
+		}
+
+		bool GeometryArena::grow(Pool& pool, unsigned int capacity)
+		{
+			// double capacity until it fits
+			unsigned long long size = pool.capacity ? pool.capacity : capacity;
+
+			while (size < capacity) size *= 2;
+
+			// return if size can not be addressed
+			if (size > 0xFFFFFFFFull || size * pool.stride > static_cast<unsigned long long>(PTRDIFF_MAX)) return false;
+
+			// make new buffer
+			unsigned int buffer = 0;
+
+			glCreateBuffers(1, &buffer);
+			glNamedBufferStorage(buffer, static_cast<GLsizeiptr>(size * pool.stride), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+			// copy old content and free old buffer
+			if (pool.buffer)
+			{
+				glCopyNamedBufferSubData(pool.buffer, buffer, 0, 0, static_cast<GLsizeiptr>(pool.capacity) * pool.stride);
+				glDeleteBuffers(1, &pool.buffer);
+			}
+
+			// new space is free, merged into trailing free range
+			unsigned int added = static_cast<unsigned int>(size) - pool.capacity;
+
+			auto last = pool.free.empty() ? pool.free.end() : std::prev(pool.free.end());
+
+			if (last != pool.free.end() && last->first + last->second == pool.capacity)
+				last->second += added;
+			else
+				pool.free[pool.capacity] = added;
+
+			pool.capacity = static_cast<unsigned int>(size);
+			pool.buffer = buffer;
+
+			// point vertex array at new buffer
+			if (&pool == &m_vertices)
+				glVertexArrayVertexBuffer(m_vao, 0, buffer, 0, pool.stride);
+			else
+				glVertexArrayElementBuffer(m_vao, buffer);
+
+			return true;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#ifndef HAWK_OBJECTS_GEOMETRY_ARENA_H
+#define HAWK_OBJECTS_GEOMETRY_ARENA_H
+
+// stl
+#include <map>
+
+namespace hawk
+{
+	namespace Objects
+	{
+		/**
+		 * Shared vertex and index buffers which meshes upload into, read through one vertex array of mesh vertex layout.
+		 * Ranges are handed out by first fit free lists, buffers grow by copying when no free range fits. Indices stay
+		 * local to their mesh, draws add base vertex. Copied meshes share ranges, which are counted per first vertex.
+		 */
+		class GeometryArena
+		{
+		public:
+			/**
+			 * Vertices capacity on initialize.
+			 */
+			static constexpr unsigned int INITIAL_VERTICES = 262144;
+
+			/**
+			 * Indices capacity on initialize.
+			 */
+			static constexpr unsigned int INITIAL_INDICES = 1048576;
+
+			/**
+			 * Constructor.
+			 */
+			GeometryArena();
+
+			/**
+			 * Destructor.
+			 */
+			~GeometryArena();
+
+			/**
+			 * Make buffers and vertex array.
+			 * @param vertices Vertices capacity.
+			 * @param indices Indices capacity.
+			 * @return True or False.
+			 */
+			bool initialize(unsigned int vertices = INITIAL_VERTICES, unsigned int indices = INITIAL_INDICES);
+
+			/**
+			 * Free buffers and vertex array, ranges still held by meshes are dropped.
+			 */
+			void deinitialize();
+
+			/**
+			 * Upload mesh geometry into free ranges.
+			 * @param vertices Mesh vertices, laid out as mesh vertex.
+			 * @param vertices_count Vertices count.
+			 * @param indices Mesh elements, may be nullptr.
+			 * @param indices_count Elements count.
+			 * @param base_vertex First vertex of range.
+			 * @param first_index First element of range.
+			 * @return True or False.
+			 */
+			bool allocate(const void* vertices, unsigned int vertices_count, const unsigned int* indices, unsigned int indices_count, unsigned int& base_vertex, unsigned int& first_index);
+
+			/**
+			 * Add a mesh sharing ranges.
+			 * @param base_vertex First vertex of range.
+			 */
+			void retain(unsigned int base_vertex);
+
+			/**
+			 * Remove a mesh sharing ranges, ranges are given back by last one with their allocated sizes.
+			 * @param base_vertex First vertex of range.
+			 */
+			void free(unsigned int base_vertex);
+
+			/**
+			 * Are buffers made?
+			 */
+			bool isReady() const;
+
+			/**
+			 * Shared vertex array object.
+			 */
+			unsigned int getVao() const;
+
+			/**
+			 * Allocated vertices.
+			 */
+			unsigned int getUsedVertices() const;
+
+			/**
+			 * Allocated indices.
+			 */
+			unsigned int getUsedIndices() const;
+
+		private:
+			/**
+			 * Buffer and its free ranges.
+			 */
+			struct Pool
+			{
+				/**
+				 * Buffer object.
+				 */
+				unsigned int buffer;
+
+				/**
+				 * Element size in bytes.
+				 */
+				unsigned int stride;
+
+				/**
+				 * Capacity in elements.
+				 */
+				unsigned int capacity;
+
+				/**
+				 * Allocated elements.
+				 */
+				unsigned int used;
+
+				/**
+				 * Free ranges, first element to count, neighbours are merged.
+				 */
+				std::map<unsigned int, unsigned int> free;
+			};
+
+			/**
+			 * Ranges of one upload.
+			 */
+			struct Allocation
+			{
+				/**
+				 * Meshes sharing ranges.
+				 */
+				unsigned int references;
+
+				/**
+				 * Vertices count.
+				 */
+				unsigned int vertices_count;
+
+				/**
+				 * First element of range.
+				 */
+				unsigned int first_index;
+
+				/**
+				 * Elements count.
+				 */
+				unsigned int indices_count;
+			};
+
+			/**
+			 * Take a range of a pool, growing the pool if no free range fits.
+			 * @param pool Pool.
+			 * @param count Elements count.
+			 * @param offset First element of range.
+			 * @return True or False.
+			 */
+			bool take(Pool& pool, unsigned int count, unsigned int& offset);
+
+			/**
+			 * Give a range back to a pool.
+			 * @param pool Pool.
+			 * @param offset First element of range.
+			 * @param count Elements count.
+			 */
+			static void give(Pool& pool, unsigned int offset, unsigned int count);
+
+			/**
+			 * Grow a pool to hold at least a capacity, content is copied to a new buffer.
+			 * @param pool Pool.
+			 * @param capacity Least capacity in elements.
+			 * @return True or False.
+			 */
+			bool grow(Pool& pool, unsigned int capacity);
+
+			/**
+			 * Vertex array object.
+			 */
+			unsigned int m_vao;
+
+			/**
+			 * Vertices pool.
+			 */
+			Pool m_vertices;
+
+			/**
+			 * Indices pool.
+			 */
+			Pool m_indices;
+
+			/**
+			 * Allocations by first vertex.
+			 */
+			std::map<unsigned int, Allocation> m_allocations;
+		};
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,430 @@
+#include "../system/core.hpp"
+#include "gpu_culler.hpp"
+#include "entity.hpp"
+#include "../components/mesh_renderer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+namespace hawk
+{
+	namespace Objects
+	{
+		GpuCuller::GpuCuller() : m_cull_shader(nullptr), m_pyramid_shader(nullptr), m_transforms_buffer(0), m_bounds_buffer(0), m_commands_buffer(0),
+			m_pyramid_texture(0), m_pyramid_size(0), m_pyramid_levels(0), m_pyramid_view_projection(1.0f), m_pyramid_valid(false) {}
+
+		GpuCuller::~GpuCuller() {}
+
+		void GpuCuller::setShaders(Assets::Shader* cull_shader, Assets::Shader* pyramid_shader)
+		{
+			m_cull_shader = cull_shader;
+			m_pyramid_shader = pyramid_shader;
+		}
+
+		void GpuCuller::release()
+		{
+			// free storage buffers
+			if (m_transforms_buffer)
+			{
+				glDeleteBuffers(1, &m_transforms_buffer);
+
+				m_transforms_buffer = 0;
+			}
+
+			if (m_bounds_buffer)
+			{
+				glDeleteBuffers(1, &m_bounds_buffer);
+
+				m_bounds_buffer = 0;
+			}
+
+			if (m_commands_buffer)
+			{
+				glDeleteBuffers(1, &m_commands_buffer);
+
+				m_commands_buffer = 0;
+			}
+
+			// free depth pyramid
+			if (m_pyramid_texture)
+			{
+				glDeleteTextures(1, &m_pyramid_texture);
+
+				m_pyramid_texture = 0;
+			}
+
+			// clear draws
+			m_renderers.clear();
+			m_draws.clear();
+			m_batches.clear();
+			m_transforms.clear();
+			m_bounds.clear();
+			m_commands.clear();
+
+			m_pyramid_size = glm::ivec2(0);
+			m_pyramid_levels = 0;
+			m_pyramid_valid = false;
+		}
+
+		bool GpuCuller::isReady() const
+		{
+			return m_cull_shader && m_pyramid_shader;
+		}
+
+		bool GpuCuller::isIndirect(const Components::Renderer* renderer)
+		{
+			// return if renderer is not a mesh renderer
+			if (renderer->getTypeId() != Components::MeshRenderer::TYPE_ID) return false;
+
+			const Components::MeshRenderer* mesh_renderer = static_cast<const Components::MeshRenderer*>(renderer);
+
+			// instanced renderers, render callbacks, detail levels and meshlets need their own draws
+			if (!mesh_renderer->instances.empty() || mesh_renderer->onRender) return false;
+
+			if (renderer->mesh && (!renderer->mesh->lods.empty() || !renderer->mesh->meshlets.empty())) return false;
+
+			// commands need indexed meshes and culling needs bounds
+			if (!renderer->entity || !renderer->mesh || renderer->mesh->indices.empty() || !renderer->hasBounds()) return false;
+
+			// return if renderer only draws shadows or has nothing to draw
+			if (renderer->shadows == Components::Renderer::Shadows::OnlyShadows || renderer->materials.empty()) return false;
+
+			// every material has to be lit and read draws buffer
+			for (auto material : renderer->materials)
+			{
+				if (material->getMaterialType() != Assets::Material::Type::Lit) return false;
+
+				if (!material->getShader()->isIndirect()) return false;
+			}
+
+			return true;
+		}
+
+		void GpuCuller::update(const std::vector<Components::Renderer*>& renderers, std::vector<Components::Renderer*>& direct)
+		{
+			// split renderers
+			m_scratch.clear();
+			direct.clear();
+
+			for (auto item : renderers)
+			{
+				if (isIndirect(item))
+					m_scratch.push_back(item);
+				else
+					direct.push_back(item);
+			}
+
+			// rebuild when renderers change
+			bool rebuild = m_scratch != m_renderers;
+
+			// draws to upload
+			unsigned int first = static_cast<unsigned int>(m_draws.size());
+			unsigned int last = 0;
+
+			for (unsigned int i = 0; i < m_draws.size() && !rebuild; ++i)
+			{
+				Draw& draw = m_draws[i];
+
+				// rebuild when mesh or material changes
+				if (draw.mesh != draw.renderer->mesh || draw.slot >= draw.renderer->materials.size() || draw.material != draw.renderer->materials[draw.slot])
+				{
+					rebuild = true;
+
+					break;
+				}
+
+				// continue if renderer has not moved
+				if (draw.version == draw.renderer->entity->transform->getVersion()) continue;
+
+				fill(i);
+
+				first = std::min(first, i);
+				last = i + 1;
+			}
+
+			if (rebuild)
+			{
+				m_renderers.swap(m_scratch);
+
+				build();
+			}
+			else if (first < last)
+			{
+				// upload moved range
+				glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_transforms_buffer);
+				glBufferSubData(GL_SHADER_STORAGE_BUFFER, first * sizeof(Transform), (last - first) * sizeof(Transform), &m_transforms[first]);
+
+				glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bounds_buffer);
+				glBufferSubData(GL_SHADER_STORAGE_BUFFER, first * sizeof(Bounds), (last - first) * sizeof(Bounds), &m_bounds[first]);
+
+				glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+			}
+		}
+
+		void GpuCuller::cull(const glm::mat4& view_projection, bool occlusion)
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// return if there is nothing to cull
+			if (m_draws.empty() || !isReady()) return;
+
+			// camera frustum
+			Helpers::Bounds::Frustum frustum = Helpers::Bounds::frustum(view_projection);
+
+			// set uniforms
+			m_cull_shader->setUInt("draws_count", static_cast<unsigned int>(m_draws.size()));
+			m_cull_shader->setFloatVec4("frustum", std::vector<glm::vec4>(frustum.planes, frustum.planes + 6));
+			m_cull_shader->setBool("occlusion", occlusion && m_pyramid_valid);
+
+			if (occlusion && m_pyramid_valid)
+			{
+				m_cull_shader->setInt("pyramid", 0);
+				m_cull_shader->setFloatVec2("pyramid_size", glm::vec2(m_pyramid_size));
+				m_cull_shader->setInt("pyramid_levels", m_pyramid_levels);
+				m_cull_shader->setFloatMat4("pyramid_view_projection", m_pyramid_view_projection);
+
+				// bind depth pyramid
+				app.video.bindTexture(0, m_pyramid_texture);
+			}
+
+			// bind draw buffers
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_bounds_buffer);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_commands_buffer);
+
+			// write instance counts of commands
+			app.video.useProgram(m_cull_shader->getProgram());
+			glDispatchCompute((static_cast<unsigned int>(m_draws.size()) + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+
+			// make commands visible to indirect draws
+			glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+
+			// unbind depth pyramid
+			app.video.bindTexture(0, 0);
+		}
+
+		void GpuCuller::draw()
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// return if there is nothing to draw
+			if (m_batches.empty() || !isReady()) return;
+
+			// bind commands and transforms
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commands_buffer);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_transforms_buffer);
+
+			for (auto& batch : m_batches)
+			{
+				// batch draws share these
+				const Draw& draw = m_draws[batch.first];
+
+				Assets::Material* material = draw.material;
+
+				// set renderer properties
+				material->setInt("renderer.shadows", (int)draw.renderer->shadows);
+
+				// use material
+				material->use();
+
+				// set material render states
+				material->setStates();
+
+				// set shader uniform values
+				material->setUniforms();
+
+				// set shader sampler values
+				material->setSamplers();
+
+				// read transforms from draws buffer
+				material->getShader()->setBool("indirect", 1);
+
+				// set fill mode
+				app.video.setPolygonMode(draw.renderer->mode);
+
+				// draw batch commands, batches of arena meshes share one vertex array
+				app.video.bindVertexArray(draw.mesh->getVao());
+				glMultiDrawElementsIndirect(draw.mesh->mode, GL_UNSIGNED_INT, (void*)(batch.first * sizeof(Command)), (int)batch.count, 0);
+
+				// read transforms from uniforms again
+				material->getShader()->setBool("indirect", 0);
+			}
+
+			// unbind, render states are left to following queued draws
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		}
+
+		void GpuCuller::buildPyramid(const Assets::Framebuffer* framebuffer, const glm::mat4& view_projection)
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// return if there is nothing to build
+			if (!isReady() || !framebuffer || !framebuffer->getDepthStencilTexture()) return;
+
+			// depth buffer size
+			glm::ivec2 size = glm::ivec2(framebuffer->getWidth(), framebuffer->getHeight());
+
+			// make depth pyramid on first use or resize
+			if (!m_pyramid_texture || size != m_pyramid_size)
+			{
+				if (m_pyramid_texture)
+				{
+					glDeleteTextures(1, &m_pyramid_texture);
+
+					// deleted names may be reused
+					app.video.resetBindings();
+				}
+
+				m_pyramid_size = size;
+				m_pyramid_levels = 1 + static_cast<int>(std::floor(std::log2(static_cast<float>(std::max(size.x, size.y)))));
+
+				// made without binding so cached texture units stay valid
+				glCreateTextures(GL_TEXTURE_2D, 1, &m_pyramid_texture);
+				glTextureStorage2D(m_pyramid_texture, m_pyramid_levels, GL_R32F, size.x, size.y);
+				glTextureParameteri(m_pyramid_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				glTextureParameteri(m_pyramid_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+				glTextureParameteri(m_pyramid_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+				glTextureParameteri(m_pyramid_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			}
+
+			// set shader program
+			app.video.useProgram(m_pyramid_shader->getProgram());
+
+			m_pyramid_shader->setInt("source", 0);
+
+			// first level copies depth buffer, others keep farthest depth of previous level
+			glm::ivec2 source_size = size;
+
+			for (int level = 0; level < m_pyramid_levels; ++level)
+			{
+				glm::ivec2 destination_size = level == 0 ? size : glm::ivec2(std::max(source_size.x / 2, 1), std::max(source_size.y / 2, 1));
+
+				// bind source and destination
+				app.video.bindTexture(0, level == 0 ? framebuffer->getDepthStencilTexture() : m_pyramid_texture);
+				glBindImageTexture(0, m_pyramid_texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+				m_pyramid_shader->setInt("source_level", level == 0 ? 0 : level - 1);
+				m_pyramid_shader->setIntVec2("source_size", source_size);
+				m_pyramid_shader->setIntVec2("destination_size", destination_size);
+
+				// reduce level
+				glDispatchCompute((destination_size.x + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE, (destination_size.y + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE, 1);
+
+				// make level visible to next level and culling
+				glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+
+				source_size = destination_size;
+			}
+
+			// unbind
+			app.video.bindTexture(0, 0);
+			glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+			// keep matrix to project boxes next frame
+			m_pyramid_view_projection = view_projection;
+			m_pyramid_valid = true;
+		}
+
+		void GpuCuller::resetPyramid()
+		{
+			m_pyramid_valid = false;
+		}
+
+		bool GpuCuller::hasPyramid() const
+		{
+			return m_pyramid_valid;
+		}
+
+		unsigned int GpuCuller::getDrawsCount() const
+		{
+			return static_cast<unsigned int>(m_draws.size());
+		}
+
+		unsigned int GpuCuller::getBatchesCount() const
+		{
+			return static_cast<unsigned int>(m_batches.size());
+		}
+
+		void GpuCuller::build()
+		{
+			// one draw per renderer material
+			m_draws.clear();
+
+			for (auto item : m_renderers)
+				for (unsigned int i = 0; i < item->materials.size(); ++i)
+					m_draws.push_back({ item, item->materials[i], i, item->mesh, 0 });
+
+			// sort draws by batch, meshes of geometry arena share a vertex array
+			std::sort(m_draws.begin(), m_draws.end(), [](const Draw& a, const Draw& b)
+			{
+				return std::make_tuple(a.material, (int)a.renderer->shadows, a.renderer->mode, a.mesh->getVao(), a.mesh->mode, a.mesh) < 
+					std::make_tuple(b.material, (int)b.renderer->shadows, b.renderer->mode, b.mesh->getVao(), b.mesh->mode, b.mesh);
+			});
+
+			// fill draws and group batches
+			m_batches.clear();
+			m_transforms.resize(m_draws.size());
+			m_bounds.resize(m_draws.size());
+			m_commands.resize(m_draws.size());
+
+			for (unsigned int i = 0; i < m_draws.size(); ++i)
+			{
+				const Draw& draw = m_draws[i];
+
+				fill(i);
+
+				// each command draws its draw transform through base instance
+				m_commands[i] = { static_cast<unsigned int>(draw.mesh->indices.size()), 0, draw.mesh->getFirstIndex(), (int)draw.mesh->getBaseVertex(), i };
+
+				// start a batch when material, vertex array or states differ from previous draw
+				const Draw* previous = i > 0 ? &m_draws[i - 1] : nullptr;
+
+				if (!previous || previous->material != draw.material || previous->mesh->getVao() != draw.mesh->getVao() || previous->mesh->mode != draw.mesh->mode || 
+					previous->renderer->shadows != draw.renderer->shadows || previous->renderer->mode != draw.renderer->mode)
+					m_batches.push_back({ i, 0 });
+
+				m_batches.back().count++;
+			}
+
+			// return if there is nothing to upload
+			if (m_draws.empty()) return;
+
+			// make buffers on first use
+			if (!m_transforms_buffer) glGenBuffers(1, &m_transforms_buffer);
+			if (!m_bounds_buffer) glGenBuffers(1, &m_bounds_buffer);
+			if (!m_commands_buffer) glGenBuffers(1, &m_commands_buffer);
+
+			// fill buffers
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_transforms_buffer);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, m_transforms.size() * sizeof(Transform), &m_transforms[0], GL_DYNAMIC_DRAW);
+
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bounds_buffer);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, m_bounds.size() * sizeof(Bounds), &m_bounds[0], GL_DYNAMIC_DRAW);
+
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_commands_buffer);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, m_commands.size() * sizeof(Command), &m_commands[0], GL_DYNAMIC_DRAW);
+
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		}
+
+		void GpuCuller::fill(unsigned int index)
+		{
+			Draw& draw = m_draws[index];
+
+			// model and normal matrices
+			glm::mat4 model = draw.renderer->entity->transform->getModelMatrix();
+
+			m_transforms[index] = { model, glm::transpose(glm::inverse(model)) };
+
+			// world box
+			const Helpers::Bounds::Box& box = draw.renderer->getWorldBounds();
+
+			m_bounds[index] = { glm::vec4(box.min, 0.0f), glm::vec4(box.max, 0.0f) };
+
+			// keep uploaded version
+			draw.version = draw.renderer->entity->transform->getVersion();
+		}
+	}
+}
\ No newline at end of file
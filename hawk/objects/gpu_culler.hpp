@@ -0,0 +1,322 @@
+#ifndef HAWK_OBJECTS_GPU_CULLER_H
+#define HAWK_OBJECTS_GPU_CULLER_H
+
+// stl
+#include <vector>
+
+// glm
+#include <glm/glm.hpp>
+
+// local
+#include "../helpers/bounds.hpp"
+
+namespace hawk
+{
+	namespace Assets
+	{
+		/**
+		 * Material forward declaration.
+		 */
+		class Material;
+
+		/**
+		 * Mesh forward declaration.
+		 */
+		class Mesh;
+
+		/**
+		 * Shader forward declaration.
+		 */
+		class Shader;
+
+		/**
+		 * Framebuffer forward declaration.
+		 */
+		class Framebuffer;
+	}
+
+	namespace Components
+	{
+		/**
+		 * Renderer forward declaration.
+		 */
+		class Renderer;
+	}
+
+	namespace Objects
+	{
+		/**
+		 * Culls lit renderers on graphics device. Draw transforms, boxes and indirect commands live in storage buffers,
+		 * a compute pass tests boxes against camera frustum and last frame depth pyramid and writes instance counts of commands,
+		 * which are drawn with one multi draw indirect call per material and mesh batch.
+		 */
+		class GpuCuller
+		{
+		public:
+			/**
+			 * Cull compute shader threads per group.
+			 */
+			static constexpr unsigned int GROUP_SIZE = 64;
+
+			/**
+			 * Depth pyramid compute shader threads per group side.
+			 */
+			static constexpr unsigned int PYRAMID_GROUP_SIZE = 8;
+
+			/**
+			 * Constructor.
+			 */
+			GpuCuller();
+
+			/**
+			 * Destructor.
+			 */
+			~GpuCuller();
+
+			/**
+			 * Set compute shaders, culling is disabled without them.
+			 * @param cull_shader Draws culling shader.
+			 * @param pyramid_shader Depth pyramid shader.
+			 */
+			void setShaders(Assets::Shader* cull_shader, Assets::Shader* pyramid_shader);
+
+			/**
+			 * Free graphics buffers and textures.
+			 */
+			void release();
+
+			/**
+			 * Are compute shaders set?
+			 */
+			bool isReady() const;
+
+			/**
+			 * Can renderer be drawn by indirect commands?
+			 * @param renderer Renderer.
+			 * @return True or False.
+			 */
+			static bool isIndirect(const Components::Renderer* renderer);
+
+			/**
+			 * Build draws from renderers when they change, otherwise upload moved draws only.
+			 * @param renderers Active renderers with updated world bounds.
+			 * @param direct List to fill with renderers that can't be drawn indirectly.
+			 */
+			void update(const std::vector<Components::Renderer*>& renderers, std::vector<Components::Renderer*>& direct);
+
+			/**
+			 * Write draw commands of visible draws on graphics device.
+			 * @param view_projection Camera view projection matrix.
+			 * @param occlusion Test against depth pyramid too?
+			 */
+			void cull(const glm::mat4& view_projection, bool occlusion);
+
+			/**
+			 * Draw culled commands, one multi draw call per batch.
+			 */
+			void draw();
+
+			/**
+			 * Build depth pyramid from a depth buffer for next frame.
+			 * @param framebuffer Frame buffer with depth attachment.
+			 * @param view_projection View projection matrix depth buffer was rendered with.
+			 */
+			void buildPyramid(const Assets::Framebuffer* framebuffer, const glm::mat4& view_projection);
+
+			/**
+			 * Invalidate depth pyramid, next frame is culled by frustum only.
+			 */
+			void resetPyramid();
+
+			/**
+			 * Is depth pyramid built?
+			 */
+			bool hasPyramid() const;
+
+			/**
+			 * Indirect draws count.
+			 */
+			unsigned int getDrawsCount() const;
+
+			/**
+			 * Multi draw batches count.
+			 */
+			unsigned int getBatchesCount() const;
+
+		private:
+			/**
+			 * Draw elements indirect command, layout is defined by graphics library.
+			 */
+			struct Command
+			{
+				unsigned int count;
+				unsigned int instance_count;
+				unsigned int first_index;
+				int base_vertex;
+				unsigned int base_instance;
+			};
+
+			/**
+			 * Draw transform, layout matches draws buffer of vertex shaders.
+			 */
+			struct Transform
+			{
+				glm::mat4 model;
+				glm::mat4 normal;
+			};
+
+			/**
+			 * Draw box, layout matches cull compute shader.
+			 */
+			struct Bounds
+			{
+				glm::vec4 min;
+				glm::vec4 max;
+			};
+
+			/**
+			 * One renderer material.
+			 */
+			struct Draw
+			{
+				/**
+				 * Drawn renderer.
+				 */
+				Components::Renderer* renderer;
+
+				/**
+				 * Draw material.
+				 */
+				Assets::Material* material;
+
+				/**
+				 * Material index in renderer materials.
+				 */
+				unsigned int slot;
+
+				/**
+				 * Draw mesh.
+				 */
+				Assets::Mesh* mesh;
+
+				/**
+				 * Renderer transform version of uploaded data.
+				 */
+				unsigned int version;
+			};
+
+			/**
+			 * Draws sharing material, vertex array and render states, drawn by one multi draw indirect call.
+			 */
+			struct Batch
+			{
+				/**
+				 * First draw index.
+				 */
+				unsigned int first;
+
+				/**
+				 * Draws count.
+				 */
+				unsigned int count;
+			};
+
+			/**
+			 * Rebuild draws, batches and buffers from renderers.
+			 */
+			void build();
+
+			/**
+			 * Fill draw transform and box from its renderer.
+			 * @param index Draw index.
+			 */
+			void fill(unsigned int index);
+
+			/**
+			 * Indirect renderers of current draws.
+			 */
+			std::vector<Components::Renderer*> m_renderers;
+
+			/**
+			 * Indirect renderers of this frame.
+			 */
+			std::vector<Components::Renderer*> m_scratch;
+
+			/**
+			 * Draws sorted by batch.
+			 */
+			std::vector<Draw> m_draws;
+
+			/**
+			 * Multi draw batches.
+			 */
+			std::vector<Batch> m_batches;
+
+			/**
+			 * Draw transforms.
+			 */
+			std::vector<Transform> m_transforms;
+
+			/**
+			 * Draw boxes.
+			 */
+			std::vector<Bounds> m_bounds;
+
+			/**
+			 * Draw commands.
+			 */
+			std::vector<Command> m_commands;
+
+			/**
+			 * Draws culling compute shader.
+			 */
+			Assets::Shader* m_cull_shader;
+
+			/**
+			 * Depth pyramid compute shader.
+			 */
+			Assets::Shader* m_pyramid_shader;
+
+			/**
+			 * Draw transforms storage buffer.
+			 */
+			unsigned int m_transforms_buffer;
+
+			/**
+			 * Draw boxes storage buffer.
+			 */
+			unsigned int m_bounds_buffer;
+
+			/**
+			 * Draw commands storage and indirect buffer.
+			 */
+			unsigned int m_commands_buffer;
+
+			/**
+			 * Depth pyramid texture, farthest depth per texel.
+			 */
+			unsigned int m_pyramid_texture;
+
+			/**
+			 * Depth pyramid size of first level.
+			 */
+			glm::ivec2 m_pyramid_size;
+
+			/**
+			 * Depth pyramid levels count.
+			 */
+			int m_pyramid_levels;
+
+			/**
+			 * View projection matrix of depth pyramid frame.
+			 */
+			glm::mat4 m_pyramid_view_projection;
+
+			/**
+			 * Is depth pyramid built?
+			 */
+			bool m_pyramid_valid;
+		};
+	}
+}
+#endif
\ No newline at end of file
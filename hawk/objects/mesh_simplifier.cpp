@@ -0,0 +1,475 @@
+#include "mesh_simplifier.hpp"
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <numeric>
+
+namespace hawk
+{
+	namespace Objects
+	{
+		/**
+		 * Welding key of a vertex, position comes first so equal positions are neighbours after sorting.
+		 */
+		static std::array<float, 8> key(const Assets::Mesh::Vertex& vertex)
+		{
+			return { vertex.position.x, vertex.position.y, vertex.position.z, vertex.normal.x, vertex.normal.y, vertex.normal.z, vertex.uv.x, vertex.uv.y };
+		}
+
+		MeshSimplifier::MeshSimplifier() : m_source_count(0), m_error(0.0f) {}
+
+		MeshSimplifier::~MeshSimplifier() {}
+
+		bool MeshSimplifier::load(const Assets::Mesh* mesh)
+		{
+			// reset state
+			m_vertices.clear();
+			m_indices.clear();
+			m_source_count = 0;
+			m_error = 0.0f;
+
+			// return if mesh has no triangles
+			if (!mesh || mesh->mode != GL_TRIANGLES || mesh->vertices.empty()) return false;
+
+			const std::vector<Assets::Mesh::Vertex>& vertices = mesh->vertices;
+
+			// source elements, meshes without them are drawn in vertex order
+			std::vector<unsigned int> source = mesh->indices;
+
+			if (source.empty())
+			{
+				source.resize(vertices.size());
+
+				std::iota(source.begin(), source.end(), 0);
+			}
+
+			if (source.size() < 3 || source.size() % 3 != 0) return false;
+
+			// weld identical vertices, importers often give each face its own vertices
+			std::vector<unsigned int> order(vertices.size());
+
+			std::iota(order.begin(), order.end(), 0);
+
+			std::sort(order.begin(), order.end(), [&vertices](unsigned int a, unsigned int b) { return key(vertices[a]) < key(vertices[b]); });
+
+			std::vector<unsigned int> weld(vertices.size());
+
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				if (i == 0 || key(vertices[order[i - 1]]) < key(vertices[order[i]]))
+					m_vertices.push_back(vertices[order[i]]);
+
+				weld[order[i]] = static_cast<unsigned int>(m_vertices.size() - 1);
+			}
+
+			unsigned int count = static_cast<unsigned int>(m_vertices.size());
+
+			// welded triangles without degenerate ones
+			for (size_t i = 0; i < source.size(); i += 3)
+			{
+				unsigned int a = weld[source[i]], b = weld[source[i + 1]], c = weld[source[i + 2]];
+
+				if (a == b || b == c || a == c) continue;
+
+				m_indices.push_back(a);
+				m_indices.push_back(b);
+				m_indices.push_back(c);
+			}
+
+			if (m_indices.empty()) return false;
+
+			m_source_count = m_indices.size();
+
+			// group vertices sharing a position, welded vertices are sorted so groups are contiguous
+			std::vector<unsigned int>& groups = m_groups;
+			std::vector<unsigned int> group_sizes(count, 0);
+
+			groups.resize(count);
+
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				groups[i] = (i > 0 && m_vertices[i].position == m_vertices[i - 1].position) ? groups[i - 1] : i;
+
+				group_sizes[groups[i]]++;
+			}
+
+			// position edges with their vertex edges
+			std::vector<std::pair<unsigned long long, unsigned long long>> edges;
+
+			edges.reserve(m_indices.size());
+
+			for (size_t i = 0; i < m_indices.size(); i += 3)
+			{
+				for (unsigned int j = 0; j < 3; ++j)
+				{
+					unsigned int a = m_indices[i + j], b = m_indices[i + (j + 1) % 3];
+					unsigned int group_a = groups[a], group_b = groups[b];
+
+					edges.push_back(std::make_pair((static_cast<unsigned long long>(std::min(group_a, group_b)) << 32) | std::max(group_a, group_b),
+						(static_cast<unsigned long long>(std::min(a, b)) << 32) | std::max(a, b)));
+				}
+			}
+
+			std::sort(edges.begin(), edges.end());
+
+			// edges not shared by exactly two triangles are borders, shared edges with different vertices are seams
+			std::vector<unsigned char> border(count, 0);
+			std::vector<unsigned int> seams(count, 0);
+
+			for (size_t i = 0; i < edges.size();)
+			{
+				size_t j = i;
+
+				while (j < edges.size() && edges[j].first == edges[i].first) ++j;
+
+				unsigned int group_a = static_cast<unsigned int>(edges[i].first >> 32), group_b = static_cast<unsigned int>(edges[i].first & 0xffffffffull);
+
+				if (j - i != 2)
+				{
+					border[group_a] = 1;
+					border[group_b] = 1;
+				}
+				else if (edges[i].second != edges[i + 1].second)
+				{
+					seams[group_a]++;
+					seams[group_b]++;
+				}
+
+				i = j;
+			}
+
+			// lock borders, seam ends and corners, and positions shared by more than two vertices
+			m_locked.resize(count);
+			m_twins.assign(count, UINT_MAX);
+
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				unsigned int group = groups[i];
+
+				m_locked[i] = (border[group] || group_sizes[group] > 2 || seams[group] != (group_sizes[group] == 2 ? 2u : 0u)) ? 1 : 0;
+
+				// vertices running along a seam pair up with the other vertex at their position
+				if (!m_locked[i] && group_sizes[group] == 2) m_twins[i] = (group == i) ? i + 1 : group;
+			}
+
+			// sum planes of triangles around each vertex
+			m_quadrics.assign(count, Quadric { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 });
+
+			for (size_t i = 0; i < m_indices.size(); i += 3)
+			{
+				const glm::vec3& a = m_vertices[m_indices[i]].position;
+				const glm::vec3& b = m_vertices[m_indices[i + 1]].position;
+				const glm::vec3& c = m_vertices[m_indices[i + 2]].position;
+
+				for (unsigned int j = 0; j < 3; ++j)
+					addPlane(m_quadrics[m_indices[i + j]], a, b, c);
+			}
+
+			return true;
+		}
+
+		Assets::Mesh* MeshSimplifier::simplify(float ratio)
+		{
+			// return if nothing is loaded
+			if (m_indices.empty()) return nullptr;
+
+			unsigned int count = static_cast<unsigned int>(m_vertices.size());
+
+			// target indices count, at least one triangle
+			size_t target = std::max<size_t>(3, static_cast<size_t>(m_source_count * ratio) / 3 * 3);
+
+			size_t start = m_indices.size();
+
+			// collapse in passes, each vertex changes once per pass
+			while (m_indices.size() > target)
+			{
+				buildAdjacency();
+
+				// cheapest collapse of each unlocked vertex onto a neighbour
+				m_collapses.clear();
+
+				for (unsigned int i = 0; i < count; ++i)
+				{
+					if (m_locked[i] || m_offsets[i] == m_offsets[i + 1]) continue;
+
+					// seam pairs are collapsed once, from their first vertex
+					unsigned int twin = m_twins[i];
+
+					if (twin != UINT_MAX && twin < i) continue;
+
+					Collapse best = { i, i, UINT_MAX, UINT_MAX, FLT_MAX };
+
+					for (unsigned int j = m_offsets[i]; j < m_offsets[i + 1]; ++j)
+					{
+						for (unsigned int k = 0; k < 3; ++k)
+						{
+							unsigned int neighbour = m_indices[m_triangles[j] * 3 + k];
+
+							if (neighbour == i || m_groups[neighbour] == m_groups[i]) continue;
+
+							Quadric quadric = m_quadrics[i];
+
+							addQuadric(quadric, m_quadrics[neighbour]);
+
+							float error = evaluate(quadric, m_vertices[neighbour].position);
+
+							// seam vertices move along the seam, twin follows onto its neighbour at the same position
+							unsigned int twin_to = UINT_MAX;
+
+							if (twin != UINT_MAX)
+							{
+								twin_to = findNeighbour(twin, m_groups[neighbour]);
+
+								if (twin_to == UINT_MAX) continue;
+
+								Quadric twin_quadric = m_quadrics[twin];
+
+								addQuadric(twin_quadric, m_quadrics[twin_to]);
+
+								error += evaluate(twin_quadric, m_vertices[twin_to].position);
+							}
+
+							if (error < best.error) best = { i, neighbour, twin, twin_to, error };
+						}
+					}
+
+					if (best.to != i) m_collapses.push_back(best);
+				}
+
+				if (m_collapses.empty()) break;
+
+				std::sort(m_collapses.begin(), m_collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+				// apply cheapest collapses until target is reached
+				m_remap.resize(count);
+
+				std::iota(m_remap.begin(), m_remap.end(), 0);
+
+				m_touched.assign(count, 0);
+
+				size_t limit = (m_indices.size() - target) / 3;
+				size_t removed = 0;
+				unsigned int collapsed = 0;
+
+				for (auto& collapse : m_collapses)
+				{
+					if (removed >= limit) break;
+
+					bool seam = collapse.twin_from != UINT_MAX;
+
+					// skip vertices whose triangles already changed in this pass
+					if (m_touched[collapse.from] || m_touched[collapse.to]) continue;
+
+					if (seam && (m_touched[collapse.twin_from] || m_touched[collapse.twin_to])) continue;
+
+					// skip collapses which flip triangles
+					if (!isValid(collapse.from, collapse.to) || (seam && !isValid(collapse.twin_from, collapse.twin_to))) continue;
+
+					removed += apply(collapse.from, collapse.to);
+
+					if (seam) removed += apply(collapse.twin_from, collapse.twin_to);
+
+					m_error = std::max(m_error, collapse.error);
+
+					collapsed++;
+				}
+
+				if (collapsed == 0) break;
+
+				// replace removed vertices and drop degenerate triangles
+				size_t write = 0;
+
+				for (size_t i = 0; i < m_indices.size(); i += 3)
+				{
+					unsigned int a = m_remap[m_indices[i]], b = m_remap[m_indices[i + 1]], c = m_remap[m_indices[i + 2]];
+
+					if (a == b || b == c || a == c) continue;
+
+					m_indices[write++] = a;
+					m_indices[write++] = b;
+					m_indices[write++] = c;
+				}
+
+				m_indices.resize(write);
+			}
+
+			// return if triangles could not be reduced
+			if (m_indices.size() >= start || m_indices.empty()) return nullptr;
+
+			// keep referenced vertices only
+			std::vector<unsigned int> map(count, UINT_MAX);
+			std::vector<Assets::Mesh::Vertex> vertices;
+			std::vector<unsigned int> indices(m_indices.size());
+
+			for (size_t i = 0; i < m_indices.size(); ++i)
+			{
+				if (map[m_indices[i]] == UINT_MAX)
+				{
+					map[m_indices[i]] = static_cast<unsigned int>(vertices.size());
+
+					vertices.push_back(m_vertices[m_indices[i]]);
+				}
+
+				indices[i] = map[m_indices[i]];
+			}
+
+			return new Assets::Mesh(vertices, indices);
+		}
+
+		float MeshSimplifier::getError() const
+		{
+			return m_error;
+		}
+
+		void MeshSimplifier::addPlane(Quadric& quadric, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+		{
+			// triangle normal, its length is twice the area
+			glm::vec3 normal = glm::cross(b - a, c - a);
+
+			float length = glm::length(normal);
+
+			if (length <= 0.0f) return;
+
+			normal = normal * (1.0f / length);
+
+			// plane weighted by area
+			double area = length * 0.5;
+			double x = normal.x, y = normal.y, z = normal.z;
+			double d = -glm::dot(normal, a);
+
+			quadric.a00 += area * x * x;
+			quadric.a01 += area * x * y;
+			quadric.a02 += area * x * z;
+			quadric.a11 += area * y * y;
+			quadric.a12 += area * y * z;
+			quadric.a22 += area * z * z;
+			quadric.b0 += area * x * d;
+			quadric.b1 += area * y * d;
+			quadric.b2 += area * z * d;
+			quadric.c += area * d * d;
+		}
+
+		void MeshSimplifier::addQuadric(Quadric& quadric, const Quadric& other)
+		{
+			quadric.a00 += other.a00;
+			quadric.a01 += other.a01;
+			quadric.a02 += other.a02;
+			quadric.a11 += other.a11;
+			quadric.a12 += other.a12;
+			quadric.a22 += other.a22;
+			quadric.b0 += other.b0;
+			quadric.b1 += other.b1;
+			quadric.b2 += other.b2;
+			quadric.c += other.c;
+		}
+
+		float MeshSimplifier::evaluate(const Quadric& quadric, const glm::vec3& point)
+		{
+			double x = point.x, y = point.y, z = point.z;
+
+			// point' * A * point + 2 * b' * point + c
+			double error = quadric.a00 * x * x + 2.0 * quadric.a01 * x * y + 2.0 * quadric.a02 * x * z
+				+ quadric.a11 * y * y + 2.0 * quadric.a12 * y * z + quadric.a22 * z * z
+				+ 2.0 * (quadric.b0 * x + quadric.b1 * y + quadric.b2 * z) + quadric.c;
+
+			return static_cast<float>(std::fabs(error));
+		}
+
+		void MeshSimplifier::buildAdjacency()
+		{
+			unsigned int count = static_cast<unsigned int>(m_vertices.size());
+
+			// triangles count per vertex
+			m_offsets.assign(count + 1, 0);
+
+			for (auto index : m_indices)
+				m_offsets[index + 1]++;
+
+			for (unsigned int i = 0; i < count; ++i)
+				m_offsets[i + 1] += m_offsets[i];
+
+			// fill triangles, remap list is free between passes and serves as write cursors
+			m_triangles.resize(m_indices.size());
+
+			m_remap.assign(m_offsets.begin(), m_offsets.end() - 1);
+
+			for (size_t i = 0; i < m_indices.size(); ++i)
+				m_triangles[m_remap[m_indices[i]]++] = static_cast<unsigned int>(i / 3);
+		}
+
+		unsigned int MeshSimplifier::findNeighbour(unsigned int vertex, unsigned int group) const
+		{
+			for (unsigned int j = m_offsets[vertex]; j < m_offsets[vertex + 1]; ++j)
+			{
+				unsigned int triangle = m_triangles[j] * 3;
+
+				for (unsigned int k = 0; k < 3; ++k)
+				{
+					if (m_groups[m_indices[triangle + k]] == group) return m_indices[triangle + k];
+				}
+			}
+
+			return UINT_MAX;
+		}
+
+		size_t MeshSimplifier::apply(unsigned int from, unsigned int to)
+		{
+			// vanished triangles
+			size_t removed = 0;
+
+			// triangles around removed vertex change, ones sharing the edge vanish
+			for (unsigned int j = m_offsets[from]; j < m_offsets[from + 1]; ++j)
+			{
+				unsigned int triangle = m_triangles[j] * 3;
+
+				bool shared = false;
+
+				for (unsigned int k = 0; k < 3; ++k)
+				{
+					m_touched[m_indices[triangle + k]] = 1;
+
+					if (m_indices[triangle + k] == to) shared = true;
+				}
+
+				if (shared) removed++;
+			}
+
+			m_remap[from] = to;
+
+			addQuadric(m_quadrics[to], m_quadrics[from]);
+
+			return removed;
+		}
+
+		bool MeshSimplifier::isValid(unsigned int from, unsigned int to) const
+		{
+			const glm::vec3& target = m_vertices[to].position;
+
+			for (unsigned int j = m_offsets[from]; j < m_offsets[from + 1]; ++j)
+			{
+				unsigned int triangle = m_triangles[j] * 3;
+
+				// triangles sharing the edge vanish
+				if (m_indices[triangle] == to || m_indices[triangle + 1] == to || m_indices[triangle + 2] == to) continue;
+
+				glm::vec3 before[3], after[3];
+
+				for (unsigned int k = 0; k < 3; ++k)
+				{
+					before[k] = m_vertices[m_indices[triangle + k]].position;
+					after[k] = (m_indices[triangle + k] == from) ? target : before[k];
+				}
+
+				// facing must not turn over or collapse to a line
+				glm::vec3 normal_before = glm::cross(before[1] - before[0], before[2] - before[0]);
+				glm::vec3 normal_after = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+				if (glm::dot(normal_before, normal_after) <= 0.0f) return false;
+			}
+
+			return true;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#ifndef HAWK_OBJECTS_MESH_SIMPLIFIER_H
+#define HAWK_OBJECTS_MESH_SIMPLIFIER_H
+
+// stl
+#include <vector>
+
+// glm
+#include <glm/glm.hpp>
+
+// local
+#include "../assets/mesh.hpp"
+
+namespace hawk
+{
+	namespace Objects
+	{
+		/**
+		 * Simplifies triangle meshes by quadric error edge collapse. A vertex collapses onto a neighbour so vertex attributes
+		 * stay valid. Vertices on attribute seams collapse along the seam together with their twin on the other side,
+		 * while border vertices and seam corners are locked. Each call continues from the last result, so levels of detail
+		 * are made from finer to coarser.
+		 */
+		class MeshSimplifier
+		{
+		public:
+			/**
+			 * Constructor.
+			 */
+			MeshSimplifier();
+
+			/**
+			 * Destructor.
+			 */
+			~MeshSimplifier();
+
+			/**
+			 * Set source mesh, welds identical vertices and computes vertex quadrics.
+			 * @param mesh Triangle mesh with kept vertices.
+			 * @return True or False.
+			 */
+			bool load(const Assets::Mesh* mesh);
+
+			/**
+			 * Collapse edges until triangles count drops to a ratio of source triangles.
+			 * @param ratio Ratio of source triangles to keep.
+			 * @return New mesh which is not built yet, otherwise null pointer if triangles could not be reduced.
+			 */
+			Assets::Mesh* simplify(float ratio);
+
+			/**
+			 * Largest collapse error so far, in squared distance units.
+			 */
+			float getError() const;
+
+		private:
+			/**
+			 * Symmetric 4x4 error matrix of planes, error of a point is its weighted squared distance to the planes.
+			 */
+			struct Quadric
+			{
+				double a00, a01, a02, a11, a12, a22;
+				double b0, b1, b2;
+				double c;
+			};
+
+			/**
+			 * Vertex collapse onto a neighbour.
+			 */
+			struct Collapse
+			{
+				/**
+				 * Removed vertex.
+				 */
+				unsigned int from;
+
+				/**
+				 * Kept vertex.
+				 */
+				unsigned int to;
+
+				/**
+				 * Removed twin vertex across a seam, or invalid.
+				 */
+				unsigned int twin_from;
+
+				/**
+				 * Kept twin vertex across a seam, or invalid.
+				 */
+				unsigned int twin_to;
+
+				/**
+				 * Collapse error.
+				 */
+				float error;
+			};
+
+			/**
+			 * Add plane of a triangle weighted by its area.
+			 * @param quadric Quadric to add to.
+			 * @param a First vertex position.
+			 * @param b Second vertex position.
+			 * @param c Third vertex position.
+			 */
+			static void addPlane(Quadric& quadric, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+
+			/**
+			 * Add a quadric to another.
+			 * @param quadric Quadric to add to.
+			 * @param other Added quadric.
+			 */
+			static void addQuadric(Quadric& quadric, const Quadric& other);
+
+			/**
+			 * Error of a point.
+			 * @param quadric Quadric.
+			 * @param point Point.
+			 */
+			static float evaluate(const Quadric& quadric, const glm::vec3& point);
+
+			/**
+			 * Fill triangles around each vertex from current indices.
+			 */
+			void buildAdjacency();
+
+			/**
+			 * Does moving a vertex onto another keep facing of its other triangles?
+			 * @param from Removed vertex.
+			 * @param to Kept vertex.
+			 * @return True or False.
+			 */
+			bool isValid(unsigned int from, unsigned int to) const;
+
+			/**
+			 * Neighbour of a vertex at a position group.
+			 * @param vertex Vertex.
+			 * @param group Position group.
+			 * @return Neighbour or invalid.
+			 */
+			unsigned int findNeighbour(unsigned int vertex, unsigned int group) const;
+
+			/**
+			 * Mark triangles around a removed vertex as changed and remap it.
+			 * @param from Removed vertex.
+			 * @param to Kept vertex.
+			 * @return Triangles which vanish.
+			 */
+			size_t apply(unsigned int from, unsigned int to);
+
+			/**
+			 * Welded vertices.
+			 */
+			std::vector<Assets::Mesh::Vertex> m_vertices;
+
+			/**
+			 * Current triangle indices into welded vertices.
+			 */
+			std::vector<unsigned int> m_indices;
+
+			/**
+			 * Source indices count.
+			 */
+			size_t m_source_count;
+
+			/**
+			 * Vertex quadrics.
+			 */
+			std::vector<Quadric> m_quadrics;
+
+			/**
+			 * Vertices which can't be removed.
+			 */
+			std::vector<unsigned char> m_locked;
+
+			/**
+			 * Position group of each vertex, first vertex at the same position.
+			 */
+			std::vector<unsigned int> m_groups;
+
+			/**
+			 * Other vertex at the same position of seam vertices, otherwise invalid.
+			 */
+			std::vector<unsigned int> m_twins;
+
+			/**
+			 * First entry of each vertex in triangles list, vertices count entry is the end.
+			 */
+			std::vector<unsigned int> m_offsets;
+
+			/**
+			 * Triangles around vertices.
+			 */
+			std::vector<unsigned int> m_triangles;
+
+			/**
+			 * Vertex replacements of a pass.
+			 */
+			std::vector<unsigned int> m_remap;
+
+			/**
+			 * Vertices changed in a pass.
+			 */
+			std::vector<unsigned char> m_touched;
+
+			/**
+			 * Collapse candidates of a pass.
+			 */
+			std::vector<Collapse> m_collapses;
+
+			/**
+			 * Largest collapse error so far.
+			 */
+			float m_error;
+		};
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "../system/core.hpp"
+#include "occlusion_buffer.hpp"
+#include "../assets/mesh.hpp"
+#include <algorithm>
+#include <cmath>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define HAWK_OCCLUSION_SSE
+#endif
+
+namespace hawk
+{
+	namespace Objects
+	{
+		/**
+		 * Smallest clip space w kept, triangles and boxes closer than this are treated as crossing near plane.
+		 */
+		static const float min_w = 1e-5f;
+
+		/**
+		 * Depth bias of box tests, a box touching an occluder surface stays visible.
+		 */
+		static const float depth_bias = 1e-4f;
+
+		OcclusionBuffer::OcclusionBuffer() : m_width(0), m_height(0), m_view_projection(1.0f), m_triangles_count(0)
+		{
+			// set default size
+			resize(WIDTH, HEIGHT);
+		}
+
+		OcclusionBuffer::~OcclusionBuffer() {}
+
+		void OcclusionBuffer::resize(unsigned int width, unsigned int height)
+		{
+			// keep rows a multiple of four pixels
+			m_width = (std::max(width, 4u) + 3) & ~3u;
+			m_height = std::max(height, 1u);
+
+			m_depth.assign(m_width * m_height, 1.0f);
+		}
+
+		void OcclusionBuffer::begin(const glm::mat4& view_projection)
+		{
+			m_view_projection = view_projection;
+
+			m_occluders.clear();
+		}
+
+		void OcclusionBuffer::addOccluder(const Assets::Mesh* mesh, const glm::mat4& model)
+		{
+			// return if mesh is not a triangle list
+			if (!mesh || mesh->mode != GL_TRIANGLES || mesh->vertices.empty()) return;
+
+			m_occluders.push_back({ mesh, m_view_projection * model });
+		}
+
+		void OcclusionBuffer::rasterize()
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// transform occluders in parallel
+			m_triangles.resize(m_occluders.size());
+
+			if (m_screen.size() < m_occluders.size()) m_screen.resize(m_occluders.size());
+
+			for (size_t i = 0; i < m_occluders.size(); ++i)
+				app.workers.push([this, i]() { transform(m_occluders[i], m_screen[i], m_triangles[i]); });
+
+			app.workers.wait();
+
+			// count triangles
+			m_triangles_count = 0;
+
+			for (size_t i = 0; i < m_occluders.size(); ++i)
+				m_triangles_count += static_cast<unsigned int>(m_triangles[i].size());
+
+			// rasterize bands of rows in parallel, bands do not share pixels
+			unsigned int bands = std::min(m_height, app.workers.getCount() + 1);
+			unsigned int rows = (m_height + bands - 1) / bands;
+
+			for (unsigned int first = 0; first < m_height; first += rows)
+			{
+				unsigned int last = std::min(first + rows, m_height);
+
+				app.workers.push([this, first, last]() { rasterizeRows(first, last); });
+			}
+
+			app.workers.wait();
+		}
+
+		bool OcclusionBuffer::isVisible(const Helpers::Bounds::Box& box) const
+		{
+			// screen rectangle and nearest depth of box corners
+			float min_x = std::numeric_limits<float>::max(), min_y = std::numeric_limits<float>::max(), min_z = std::numeric_limits<float>::max();
+			float max_x = -std::numeric_limits<float>::max(), max_y = -std::numeric_limits<float>::max();
+
+			for (int i = 0; i < 8; ++i)
+			{
+				glm::vec4 clip = m_view_projection * glm::vec4(i & 1 ? box.max.x : box.min.x, i & 2 ? box.max.y : box.min.y, i & 4 ? box.max.z : box.min.z, 1.0f);
+
+				// return if box crosses near plane
+				if (clip.w <= min_w) return true;
+
+				float x = (clip.x / clip.w * 0.5f + 0.5f) * m_width;
+				float y = (clip.y / clip.w * 0.5f + 0.5f) * m_height;
+				float z = clip.z / clip.w * 0.5f + 0.5f;
+
+				min_x = std::min(min_x, x);
+				max_x = std::max(max_x, x);
+				min_y = std::min(min_y, y);
+				max_y = std::max(max_y, y);
+				min_z = std::min(min_z, z);
+			}
+
+			// bias toward camera
+			min_z -= depth_bias;
+
+			// return if box reaches near plane
+			if (min_z <= 0.0f) return true;
+
+			// covered pixels
+			int x0 = std::max(0, static_cast<int>(std::floor(min_x)));
+			int x1 = std::min(static_cast<int>(m_width) - 1, static_cast<int>(std::ceil(max_x)));
+			int y0 = std::max(0, static_cast<int>(std::floor(min_y)));
+			int y1 = std::min(static_cast<int>(m_height) - 1, static_cast<int>(std::ceil(max_y)));
+
+			// return if rectangle is off buffer, frustum culling decides those
+			if (x0 > x1 || y0 > y1) return true;
+
+			// visible if any pixel has no occluder in front of box
+			for (int y = y0; y <= y1; ++y)
+			{
+				const float* row = &m_depth[y * m_width];
+
+#ifdef HAWK_OCCLUSION_SSE
+				__m128 depth = _mm_set1_ps(min_z);
+				__m128 first = _mm_set1_ps(static_cast<float>(x0));
+				__m128 last = _mm_set1_ps(static_cast<float>(x1));
+
+				for (int x = x0 & ~3; x <= x1; x += 4)
+				{
+					// lanes inside rectangle
+					__m128 lanes = _mm_setr_ps(static_cast<float>(x), static_cast<float>(x + 1), static_cast<float>(x + 2), static_cast<float>(x + 3));
+					__m128 inside = _mm_and_ps(_mm_cmpge_ps(lanes, first), _mm_cmple_ps(lanes, last));
+
+					// box nearer than occluders
+					__m128 nearer = _mm_cmpgt_ps(_mm_loadu_ps(row + x), depth);
+
+					if (_mm_movemask_ps(_mm_and_ps(inside, nearer))) return true;
+				}
+#else
+				for (int x = x0; x <= x1; ++x)
+					if (row[x] > min_z) return true;
+#endif
+			}
+
+			return false;
+		}
+
+		unsigned int OcclusionBuffer::getWidth() const
+		{
+			return m_width;
+		}
+
+		unsigned int OcclusionBuffer::getHeight() const
+		{
+			return m_height;
+		}
+
+		unsigned int OcclusionBuffer::getOccludersCount() const
+		{
+			return static_cast<unsigned int>(m_occluders.size());
+		}
+
+		unsigned int OcclusionBuffer::getTrianglesCount() const
+		{
+			return m_triangles_count;
+		}
+
+		void OcclusionBuffer::transform(const Occluder& occluder, std::vector<glm::vec4>& screen, std::vector<Triangle>& triangles) const
+		{
+			// reuse list
+			triangles.clear();
+
+			// mesh data
+			const std::vector<Assets::Mesh::Vertex>& vertices = occluder.mesh->vertices;
+			const std::vector<unsigned int>& indices = occluder.mesh->indices;
+
+			// screen space vertices, w is zero for vertices behind near plane
+			screen.resize(vertices.size());
+
+			for (size_t i = 0; i < vertices.size(); ++i)
+			{
+				glm::vec4 clip = occluder.matrix * glm::vec4(vertices[i].position, 1.0f);
+
+				if (clip.w <= min_w)
+				{
+					screen[i] = glm::vec4(0.0f);
+
+					continue;
+				}
+
+				screen[i] = glm::vec4((clip.x / clip.w * 0.5f + 0.5f) * m_width, (clip.y / clip.w * 0.5f + 0.5f) * m_height, clip.z / clip.w * 0.5f + 0.5f, 1.0f);
+			}
+
+			// triangles count
+			size_t count = indices.empty() ? vertices.size() / 3 : indices.size() / 3;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				// vertex indices
+				unsigned int a = indices.empty() ? static_cast<unsigned int>(i * 3) : indices[i * 3];
+				unsigned int b = indices.empty() ? static_cast<unsigned int>(i * 3 + 1) : indices[i * 3 + 1];
+				unsigned int c = indices.empty() ? static_cast<unsigned int>(i * 3 + 2) : indices[i * 3 + 2];
+
+				// drop triangles crossing near plane, leaving holes only makes culling less aggressive
+				if (screen[a].w == 0.0f || screen[b].w == 0.0f || screen[c].w == 0.0f) continue;
+
+				// drop triangles off buffer
+				float min_x = std::min(screen[a].x, std::min(screen[b].x, screen[c].x));
+				float max_x = std::max(screen[a].x, std::max(screen[b].x, screen[c].x));
+				float min_y = std::min(screen[a].y, std::min(screen[b].y, screen[c].y));
+				float max_y = std::max(screen[a].y, std::max(screen[b].y, screen[c].y));
+
+				if (max_x < 0.0f || max_y < 0.0f || min_x >= m_width || min_y >= m_height) continue;
+
+				triangles.push_back({ { glm::vec3(screen[a]), glm::vec3(screen[b]), glm::vec3(screen[c]) } });
+			}
+		}
+
+		void OcclusionBuffer::rasterizeRows(unsigned int first, unsigned int last)
+		{
+			// clear rows
+			std::fill(m_depth.begin() + first * m_width, m_depth.begin() + last * m_width, 1.0f);
+
+			for (auto& list : m_triangles)
+			{
+				for (auto& triangle : list)
+				{
+					glm::vec3 v0 = triangle.vertices[0];
+					glm::vec3 v1 = triangle.vertices[1];
+					glm::vec3 v2 = triangle.vertices[2];
+
+					// twice signed area, flip to counter clockwise
+					float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+
+					if (std::fabs(area) < 1e-6f) continue;
+
+					if (area < 0.0f)
+					{
+						std::swap(v1, v2);
+
+						area = -area;
+					}
+
+					// bounding rectangle clipped to band
+					int x0 = std::max(0, static_cast<int>(std::floor(std::min(v0.x, std::min(v1.x, v2.x)))));
+					int x1 = std::min(static_cast<int>(m_width) - 1, static_cast<int>(std::ceil(std::max(v0.x, std::max(v1.x, v2.x)))));
+					int y0 = std::max(static_cast<int>(first), static_cast<int>(std::floor(std::min(v0.y, std::min(v1.y, v2.y)))));
+					int y1 = std::min(static_cast<int>(last) - 1, static_cast<int>(std::ceil(std::max(v0.y, std::max(v1.y, v2.y)))));
+
+					if (x0 > x1 || y0 > y1) continue;
+
+					// edge functions a * x + b * y + c, positive inside
+					float a0 = v1.y - v2.y, b0 = v2.x - v1.x, c0 = -a0 * v1.x - b0 * v1.y;
+					float a1 = v2.y - v0.y, b1 = v0.x - v2.x, c1 = -a1 * v2.x - b1 * v2.y;
+					float a2 = v0.y - v1.y, b2 = v1.x - v0.x, c2 = -a2 * v0.x - b2 * v0.y;
+
+					// depth plane
+					float za = (a0 * v0.z + a1 * v1.z + a2 * v2.z) / area;
+					float zb = (b0 * v0.z + b1 * v1.z + b2 * v2.z) / area;
+					float zc = (c0 * v0.z + c1 * v1.z + c2 * v2.z) / area;
+
+					// pixel centers pass only if whole pixel is inside, and take farthest depth of pixel
+					c0 -= 0.5f * (std::fabs(a0) + std::fabs(b0));
+					c1 -= 0.5f * (std::fabs(a1) + std::fabs(b1));
+					c2 -= 0.5f * (std::fabs(a2) + std::fabs(b2));
+					zc += 0.5f * (std::fabs(za) + std::fabs(zb));
+
+					for (int y = y0; y <= y1; ++y)
+					{
+						float* row = &m_depth[y * m_width];
+
+						// pixel center row
+						float py = y + 0.5f;
+
+#ifdef HAWK_OCCLUSION_SSE
+						// row constants
+						__m128 e0_row = _mm_set1_ps(b0 * py + c0), e1_row = _mm_set1_ps(b1 * py + c1), e2_row = _mm_set1_ps(b2 * py + c2);
+						__m128 z_row = _mm_set1_ps(zb * py + zc);
+						__m128 ea0 = _mm_set1_ps(a0), ea1 = _mm_set1_ps(a1), ea2 = _mm_set1_ps(a2), eza = _mm_set1_ps(za);
+						__m128 zero = _mm_setzero_ps();
+
+						for (int x = x0 & ~3; x <= x1; x += 4)
+						{
+							// pixel centers
+							__m128 px = _mm_setr_ps(x + 0.5f, x + 1.5f, x + 2.5f, x + 3.5f);
+
+							// inside all edges
+							__m128 mask = _mm_and_ps(_mm_and_ps(
+								_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(ea0, px), e0_row), zero),
+								_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(ea1, px), e1_row), zero)),
+								_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(ea2, px), e2_row), zero));
+
+							if (!_mm_movemask_ps(mask)) continue;
+
+							// keep nearest depth on covered pixels
+							__m128 depth = _mm_loadu_ps(row + x);
+							__m128 nearest = _mm_min_ps(depth, _mm_add_ps(_mm_mul_ps(eza, px), z_row));
+
+							_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(mask, nearest), _mm_andnot_ps(mask, depth)));
+						}
+#else
+						for (int x = x0; x <= x1; ++x)
+						{
+							float px = x + 0.5f;
+
+							if (a0 * px + b0 * py + c0 < 0.0f || a1 * px + b1 * py + c1 < 0.0f || a2 * px + b2 * py + c2 < 0.0f) continue;
+
+							row[x] = std::min(row[x], za * px + zb * py + zc);
+						}
+#endif
+					}
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
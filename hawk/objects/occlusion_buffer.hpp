@@ -0,0 +1,190 @@
+#ifndef HAWK_OBJECTS_OCCLUSION_BUFFER_H
+#define HAWK_OBJECTS_OCCLUSION_BUFFER_H
+
+// stl
+#include <vector>
+
+// glm
+#include <glm/glm.hpp>
+
+// local
+#include "../helpers/bounds.hpp"
+
+namespace hawk
+{
+	namespace Assets
+	{
+		/**
+		 * Mesh forward declaration.
+		 */
+		class Mesh;
+	}
+
+	namespace Objects
+	{
+		/**
+		 * Low resolution software depth buffer. Occluder triangles are rasterized on worker threads, four pixels per step,
+		 * and boxes are tested against it to reject draws hidden behind occluders without reading back from graphics device.
+		 * Occluders only write pixels they fully cover with their farthest depth in the pixel, so tests stay conservative.
+		 */
+		class OcclusionBuffer
+		{
+		public:
+			/**
+			 * Default buffer width, multiple of four.
+			 */
+			static constexpr unsigned int WIDTH = 256;
+
+			/**
+			 * Default buffer height.
+			 */
+			static constexpr unsigned int HEIGHT = 128;
+
+			/**
+			 * Constructor.
+			 */
+			OcclusionBuffer();
+
+			/**
+			 * Destructor.
+			 */
+			~OcclusionBuffer();
+
+			/**
+			 * Set buffer size.
+			 * @param width Buffer width, rounded up to a multiple of four.
+			 * @param height Buffer height.
+			 */
+			void resize(unsigned int width, unsigned int height);
+
+			/**
+			 * Start a new frame, removes occluders.
+			 * @param view_projection Camera view projection matrix.
+			 */
+			void begin(const glm::mat4& view_projection);
+
+			/**
+			 * Add an occluder mesh, mesh vertices must be kept.
+			 * @param mesh Occluder mesh.
+			 * @param model Occluder model matrix.
+			 */
+			void addOccluder(const Assets::Mesh* mesh, const glm::mat4& model);
+
+			/**
+			 * Transform occluders and rasterize them into depth buffer on worker threads.
+			 */
+			void rasterize();
+
+			/**
+			 * Is any part of a box in front of occluders? Safe to call from worker threads after rasterize.
+			 * @param box World space box.
+			 * @return True or False.
+			 */
+			bool isVisible(const Helpers::Bounds::Box& box) const;
+
+			/**
+			 * Buffer width.
+			 */
+			unsigned int getWidth() const;
+
+			/**
+			 * Buffer height.
+			 */
+			unsigned int getHeight() const;
+
+			/**
+			 * Occluders count of current frame.
+			 */
+			unsigned int getOccludersCount() const;
+
+			/**
+			 * Rasterized triangles count of current frame.
+			 */
+			unsigned int getTrianglesCount() const;
+
+		private:
+			/**
+			 * Screen space triangle, x and y in pixels and z in normalized depth.
+			 */
+			struct Triangle
+			{
+				/**
+				 * Triangle vertices.
+				 */
+				glm::vec3 vertices[3];
+			};
+
+			/**
+			 * Occluder of current frame.
+			 */
+			struct Occluder
+			{
+				/**
+				 * Occluder mesh.
+				 */
+				const Assets::Mesh* mesh;
+
+				/**
+				 * Mesh to clip space matrix.
+				 */
+				glm::mat4 matrix;
+			};
+
+			/**
+			 * Transform occluder triangles to screen space, triangles crossing near plane are dropped.
+			 * @param occluder Occluder.
+			 * @param screen Screen space vertices scratch list.
+			 * @param triangles List to fill.
+			 */
+			void transform(const Occluder& occluder, std::vector<glm::vec4>& screen, std::vector<Triangle>& triangles) const;
+
+			/**
+			 * Rasterize all triangles into a band of rows.
+			 * @param first First row.
+			 * @param last Row after last row.
+			 */
+			void rasterizeRows(unsigned int first, unsigned int last);
+
+			/**
+			 * Nearest depth per pixel, row major.
+			 */
+			std::vector<float> m_depth;
+
+			/**
+			 * Buffer width.
+			 */
+			unsigned int m_width;
+
+			/**
+			 * Buffer height.
+			 */
+			unsigned int m_height;
+
+			/**
+			 * Camera view projection matrix.
+			 */
+			glm::mat4 m_view_projection;
+
+			/**
+			 * Occluders of current frame.
+			 */
+			std::vector<Occluder> m_occluders;
+
+			/**
+			 * Screen space triangles per occluder.
+			 */
+			std::vector<std::vector<Triangle>> m_triangles;
+
+			/**
+			 * Screen space vertices scratch lists per occluder, kept between frames.
+			 */
+			std::vector<std::vector<glm::vec4>> m_screen;
+
+			/**
+			 * Rasterized triangles count.
+			 */
+			unsigned int m_triangles_count;
+		};
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "render_queue.hpp"
+#include <cstring>
+
+namespace hawk
+{
+	namespace Objects
+	{
+		RenderQueue::RenderQueue() {}
+
+		RenderQueue::~RenderQueue() {}
+
+		void RenderQueue::clear()
+		{
+			m_items.clear();
+		}
+
+		void RenderQueue::push(unsigned long long key, Components::Renderer* renderer)
+		{
+			m_items.push_back({ key, renderer });
+		}
+
+		void RenderQueue::sort()
+		{
+			// return if there is nothing to order
+			if (m_items.size() < 2) return;
+
+			// byte histograms of all passes in one read
+			unsigned int counts[8][256];
+
+			std::memset(counts, 0, sizeof counts);
+
+			for (auto& item : m_items)
+			{
+				for (unsigned int pass = 0; pass < 8; ++pass)
+					counts[pass][(item.key >> (pass * 8)) & 0xFF]++;
+			}
+
+			m_scratch.resize(m_items.size());
+
+			for (unsigned int pass = 0; pass < 8; ++pass)
+			{
+				unsigned int* count = counts[pass];
+
+				unsigned int shift = pass * 8;
+
+				// skip byte if all keys share it
+				if (count[(m_items[0].key >> shift) & 0xFF] == m_items.size()) continue;
+
+				// bucket offsets
+				unsigned int offset = 0;
+
+				for (unsigned int i = 0; i < 256; ++i)
+				{
+					unsigned int size = count[i];
+
+					count[i] = offset;
+					offset += size;
+				}
+
+				// stable scatter
+				for (auto& item : m_items)
+					m_scratch[count[(item.key >> shift) & 0xFF]++] = item;
+
+				m_items.swap(m_scratch);
+			}
+		}
+
+		const std::vector<RenderQueue::Item>& RenderQueue::getItems() const
+		{
+			return m_items;
+		}
+
+		unsigned long long RenderQueue::makeKey(unsigned int layer, unsigned int program, unsigned int textures, unsigned int mesh, float depth, bool depth_first, bool back_to_front)
+		{
+			// quantize depth
+			const unsigned long long depth_max = (1ull << DEPTH_BITS) - 1;
+
+			float clamped = depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+
+			unsigned long long z = static_cast<unsigned long long>(clamped * static_cast<float>(depth_max));
+
+			if (back_to_front) z = depth_max - z;
+
+			// state fields
+			unsigned long long state = (static_cast<unsigned long long>(program & ((1u << PROGRAM_BITS) - 1)) << (TEXTURES_BITS + MESH_BITS)) |
+				(static_cast<unsigned long long>(textures & ((1u << TEXTURES_BITS) - 1)) << MESH_BITS) |
+				static_cast<unsigned long long>(mesh & ((1u << MESH_BITS) - 1));
+
+			unsigned long long key = static_cast<unsigned long long>(layer & ((1u << LAYER_BITS) - 1)) << (PROGRAM_BITS + TEXTURES_BITS + MESH_BITS + DEPTH_BITS);
+
+			// depth above state for blended layers, below it for opaque ones
+			if (depth_first)
+				key |= (z << (PROGRAM_BITS + TEXTURES_BITS + MESH_BITS)) | state;
+			else
+				key |= (state << DEPTH_BITS) | z;
+
+			return key;
+		}
+	}
+}
\ No newline at end of file
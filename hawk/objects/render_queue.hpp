@@ -0,0 +1,124 @@
+#ifndef HAWK_OBJECTS_RENDER_QUEUE_H
+#define HAWK_OBJECTS_RENDER_QUEUE_H
+
+// stl
+#include <vector>
+
+namespace hawk
+{
+	namespace Components
+	{
+		/**
+		 * Renderer forward declaration.
+		 */
+		class Renderer;
+	}
+
+	namespace Objects
+	{
+		/**
+		 * Draws of a pass ordered by 64-bit sort keys. Keys pack layer, shader program, texture set, mesh and depth from
+		 * high to low bits, so after a radix sort draws sharing a program and textures follow each other.
+		 */
+		class RenderQueue
+		{
+		public:
+			/**
+			 * Queued draw.
+			 */
+			struct Item
+			{
+				/**
+				 * Sort key.
+				 */
+				unsigned long long key;
+
+				/**
+				 * Drawn renderer.
+				 */
+				Components::Renderer* renderer;
+			};
+
+			/**
+			 * Layer bits, highest field.
+			 */
+			static constexpr unsigned int LAYER_BITS = 2;
+
+			/**
+			 * Shader program bits.
+			 */
+			static constexpr unsigned int PROGRAM_BITS = 10;
+
+			/**
+			 * Texture set bits.
+			 */
+			static constexpr unsigned int TEXTURES_BITS = 14;
+
+			/**
+			 * Mesh bits.
+			 */
+			static constexpr unsigned int MESH_BITS = 14;
+
+			/**
+			 * Depth bits, lowest field.
+			 */
+			static constexpr unsigned int DEPTH_BITS = 24;
+
+			/**
+			 * Constructor.
+			 */
+			RenderQueue();
+
+			/**
+			 * Destructor.
+			 */
+			~RenderQueue();
+
+			/**
+			 * Remove all draws.
+			 */
+			void clear();
+
+			/**
+			 * Add a draw.
+			 * @param key Sort key.
+			 * @param renderer Drawn renderer.
+			 */
+			void push(unsigned long long key, Components::Renderer* renderer);
+
+			/**
+			 * Sort draws by key, least significant byte first, bytes equal in all keys are skipped.
+			 */
+			void sort();
+
+			/**
+			 * Draws, sorted after a sort call.
+			 */
+			const std::vector<Item>& getItems() const;
+
+			/**
+			 * Pack a sort key, fields are cut to their bits so ids only have to be distinct in low bits to group well.
+			 * @param layer Layer, drawn in increasing order.
+			 * @param program Shader program id.
+			 * @param textures Texture set id.
+			 * @param mesh Mesh id.
+			 * @param depth Depth from zero to one.
+			 * @param depth_first Sort by depth before program, textures and mesh.
+			 * @param back_to_front Draw far depths first.
+			 */
+			static unsigned long long makeKey(unsigned int layer, unsigned int program, unsigned int textures, unsigned int mesh, float depth, bool depth_first = false, bool back_to_front = false);
+
+		private:
+			/**
+			 * Queued draws.
+			 */
+			std::vector<Item> m_items;
+
+			/**
+			 * Sort pass target.
+			 */
+			std::vector<Item> m_scratch;
+		};
+	}
+}
+#endif
\ No newline at end of file
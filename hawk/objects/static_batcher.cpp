@@ -0,0 +1,354 @@
+#include "../system/core.hpp"
+#include "static_batcher.hpp"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace hawk
+{
+	namespace Objects
+	{
+		StaticBatcher::StaticBatcher() : m_meshes_id(0) {}
+
+		StaticBatcher::~StaticBatcher() {}
+
+		Entity* StaticBatcher::build(Entity* root)
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// remove earlier batch of root, nested batches stay
+			Entity* earlier = findBatch(root);
+
+			if (earlier) clearBatch(earlier);
+
+			// group mergeable renderers
+			m_groups.clear();
+
+			collect(root);
+
+			// renderers are merged in root space
+			glm::mat4 root_inverse = root->transform ? glm::inverse(root->transform->getModelMatrix()) : glm::mat4(1.0f);
+
+			Entity* batch = nullptr;
+
+			for (auto& group : m_groups)
+			{
+				// single renderers draw as before
+				if (group.renderers.size() < 2) continue;
+
+				Assets::Mesh* mesh = merge(group, root_inverse);
+
+				if (!mesh) continue;
+
+				// register mesh so it is released with assets
+				std::string name = std::string(ENTITY_NAME) + std::to_string(m_meshes_id++);
+
+				app.assets.addMeshes({ { name, mesh } });
+
+				// make batch entity on first merged group
+				if (!batch)
+				{
+					batch = new Entity();
+					batch->addComponent("Transform", new Components::Transform());
+					batch->setStatic(true);
+				}
+
+				// merged renderer
+				Components::MeshRenderer* renderer = new Components::MeshRenderer(group.material, mesh, group.shadows, group.mode);
+
+				renderer->cast_shadows = group.cast_shadows;
+				renderer->occluder = group.occluder;
+
+				std::string component = "Chunk" + std::to_string(batch->components.size() - 1);
+
+				batch->addComponent(component.c_str(), renderer);
+
+				// sources stop drawing
+				for (auto source : group.renderers)
+					source->m_batch = renderer;
+			}
+
+			m_groups.clear();
+
+			// return if nothing was merged
+			if (!batch) return nullptr;
+
+			app.logger.info((std::string("Merged static renderers of ") + root->getName() + " into " + std::to_string(batch->components.size() - 1) + " batches.").c_str());
+
+			return root->addEntity(ENTITY_NAME, batch);
+		}
+
+		void StaticBatcher::clear(Entity* root)
+		{
+			// batches of root and nested subtrees
+			std::vector<Entity*> batches;
+
+			findBatches(root, batches);
+
+			for (auto batch : batches)
+				clearBatch(batch);
+		}
+
+		std::vector<Entity*> StaticBatcher::invalidate(Entity* entity)
+		{
+			// nested batches
+			std::vector<Entity*> batches;
+
+			findBatches(entity, batches);
+
+			// batches merging renderers of subtree, ancestor batches included
+			std::vector<Entity*> stack(1, entity);
+
+			while (!stack.empty())
+			{
+				Entity* item = stack.back();
+
+				stack.pop_back();
+
+				for (auto component : item->components)
+				{
+					if (component.second->getTypeId() != Components::MeshRenderer::TYPE_ID) continue;
+
+					Components::Renderer* renderer = static_cast<Components::Renderer*>(component.second);
+
+					if (renderer->m_batch && std::find(batches.begin(), batches.end(), renderer->m_batch->entity) == batches.end())
+						batches.push_back(renderer->m_batch->entity);
+				}
+
+				for (auto child : item->entities)
+					if (child.second->getName() != ENTITY_NAME) stack.push_back(child.second);
+			}
+
+			// remove batches and keep their roots
+			std::vector<Entity*> roots;
+
+			for (auto batch : batches)
+			{
+				if (std::find(roots.begin(), roots.end(), batch->parent) == roots.end()) roots.push_back(batch->parent);
+
+				clearBatch(batch);
+			}
+
+			return roots;
+		}
+
+		bool StaticBatcher::isMerged(const Entity* entity)
+		{
+			for (auto component : entity->components)
+			{
+				if (component.second->getTypeId() == Components::MeshRenderer::TYPE_ID && static_cast<Components::Renderer*>(component.second)->m_batch) return true;
+			}
+
+			return false;
+		}
+
+		Entity* StaticBatcher::getRoot(const Components::Renderer* renderer)
+		{
+			return (renderer->m_batch && renderer->m_batch->entity) ? renderer->m_batch->entity->parent : nullptr;
+		}
+
+		void StaticBatcher::clearBatch(Entity* batch)
+		{
+			// application
+			System::Core& app = System::Core::getInstance();
+
+			// subtree root
+			Entity* root = batch->parent;
+
+			// merged meshes
+			std::vector<Assets::Mesh*> meshes;
+
+			for (auto component : batch->components)
+			{
+				if (component.second->getTypeId() == Components::MeshRenderer::TYPE_ID)
+					meshes.push_back(static_cast<Components::MeshRenderer*>(component.second)->mesh);
+			}
+
+			// sources of this batch draw again
+			std::vector<Entity*> stack(1, root);
+
+			while (!stack.empty())
+			{
+				Entity* entity = stack.back();
+
+				stack.pop_back();
+
+				for (auto component : entity->components)
+				{
+					if (component.second->getTypeId() != Components::MeshRenderer::TYPE_ID) continue;
+
+					Components::Renderer* renderer = static_cast<Components::Renderer*>(component.second);
+
+					if (renderer->m_batch && renderer->m_batch->entity == batch) renderer->m_batch = nullptr;
+				}
+
+				for (auto child : entity->entities)
+					if (child.second != batch) stack.push_back(child.second);
+			}
+
+			// destroy merged renderers
+			Entity::destroyImmediate(batch);
+
+			// free merged meshes
+			for (auto mesh : meshes)
+			{
+				for (auto it = app.assets.meshes.begin(); it != app.assets.meshes.end(); ++it)
+				{
+					if (it->second != mesh) continue;
+
+					std::string name = it->first;
+
+					app.assets.removeMesh(name.c_str());
+
+					break;
+				}
+			}
+		}
+
+		bool StaticBatcher::isBatchable(const Components::MeshRenderer* renderer)
+		{
+			// skip disabled and already merged renderers
+			if (!renderer->enable || renderer->m_batch || !renderer->entity->isActive() || !renderer->entity->isStatic()) return false;
+
+			// instanced renderers and render callbacks need their own draws
+			if (!renderer->instances.empty() || renderer->onRender) return false;
+
+			// one material
+			if (renderer->materials.size() != 1 || !renderer->materials[0]) return false;
+
+			// triangles with kept vertices, detail levels would be lost
+			const Assets::Mesh* mesh = renderer->mesh;
+
+			return mesh && mesh->mode == GL_TRIANGLES && !mesh->vertices.empty() && mesh->lods.empty();
+		}
+
+		Entity* StaticBatcher::findBatch(Entity* root)
+		{
+			for (auto child : root->entities)
+				if (child.second->getName() == ENTITY_NAME) return child.second;
+
+			return nullptr;
+		}
+
+		void StaticBatcher::findBatches(Entity* root, std::vector<Entity*>& batches)
+		{
+			for (auto child : root->entities)
+			{
+				if (child.second->getName() == ENTITY_NAME)
+					batches.push_back(child.second);
+				else
+					findBatches(child.second, batches);
+			}
+		}
+
+		void StaticBatcher::collect(Entity* entity)
+		{
+			for (auto component : entity->components)
+			{
+				if (component.second->getTypeId() != Components::MeshRenderer::TYPE_ID) continue;
+
+				Components::MeshRenderer* renderer = static_cast<Components::MeshRenderer*>(component.second);
+
+				if (!isBatchable(renderer)) continue;
+
+				// chunk of world bounds center
+				Helpers::Bounds::Box box = Helpers::Bounds::transform(renderer->mesh->getBounds(), renderer->entity->transform->getModelMatrix());
+
+				glm::vec3 center = (box.min + box.max) * (0.5f / CHUNK_SIZE);
+
+				glm::ivec3 chunk(static_cast<int>(std::floor(center.x)), static_cast<int>(std::floor(center.y)), static_cast<int>(std::floor(center.z)));
+
+				// find group, groups keep first seen order so batches are named the same across loads
+				Group* group = nullptr;
+
+				for (auto& item : m_groups)
+				{
+					if (item.material == renderer->materials[0] && item.mode == renderer->mode && item.shadows == renderer->shadows &&
+						item.cast_shadows == renderer->cast_shadows && item.occluder == renderer->occluder && item.chunk == chunk)
+					{
+						group = &item;
+
+						break;
+					}
+				}
+
+				if (!group)
+				{
+					m_groups.push_back({ renderer->materials[0], renderer->mode, renderer->shadows, renderer->cast_shadows, renderer->occluder, chunk, false });
+
+					group = &m_groups.back();
+				}
+
+				group->meshlets |= !renderer->mesh->meshlets.empty();
+				group->renderers.push_back(renderer);
+			}
+
+			// child entities, skip an earlier batch
+			for (auto child : entity->entities)
+				if (child.second->getName() != ENTITY_NAME) collect(child.second);
+		}
+
+		Assets::Mesh* StaticBatcher::merge(const Group& group, const glm::mat4& root_inverse) const
+		{
+			// merged geometry
+			std::vector<Assets::Mesh::Vertex> vertices;
+			std::vector<unsigned int> indices;
+
+			for (auto renderer : group.renderers)
+			{
+				const Assets::Mesh* mesh = renderer->mesh;
+
+				// source to root space
+				glm::mat4 model = root_inverse * renderer->entity->transform->getModelMatrix();
+				glm::mat3 normal = glm::mat3(glm::transpose(glm::inverse(model)));
+
+				// mirrored sources flip triangle winding
+				glm::mat3 linear = glm::mat3(model);
+
+				bool mirrored = glm::dot(glm::cross(linear[0], linear[1]), linear[2]) < 0.0f;
+
+				unsigned int base = static_cast<unsigned int>(vertices.size());
+
+				// same normal matrix as shaders, so lighting does not change
+				for (auto vertex : mesh->vertices)
+				{
+					vertex.position = glm::vec3(model * glm::vec4(vertex.position, 1.0f));
+					vertex.normal = normal * vertex.normal;
+					vertex.tangent = normal * vertex.tangent;
+					vertex.bitangent = normal * vertex.bitangent;
+
+					vertices.push_back(vertex);
+				}
+
+				unsigned int count = static_cast<unsigned int>(mesh->indices.empty() ? mesh->vertices.size() : mesh->indices.size());
+
+				for (unsigned int i = 0; i + 2 < count; i += 3)
+				{
+					unsigned int a = mesh->indices.empty() ? i : mesh->indices[i];
+					unsigned int b = mesh->indices.empty() ? i + 1 : mesh->indices[i + 1];
+					unsigned int c = mesh->indices.empty() ? i + 2 : mesh->indices[i + 2];
+
+					indices.push_back(base + a);
+					indices.push_back(base + (mirrored ? c : b));
+					indices.push_back(base + (mirrored ? b : c));
+				}
+			}
+
+			Assets::Mesh* mesh = new Assets::Mesh(vertices, indices);
+
+			// keep cluster culling of sources
+			if (group.meshlets) mesh->buildMeshlets();
+
+			// build mesh
+			if (!mesh->build())
+			{
+				mesh->release();
+
+				return nullptr;
+			}
+
+			return mesh;
+		}
+	}
+}
\ No newline at end of file
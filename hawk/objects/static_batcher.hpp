@@ -0,0 +1,180 @@
+#ifndef HAWK_OBJECTS_STATIC_BATCHER_H
+#define HAWK_OBJECTS_STATIC_BATCHER_H
+
+// stl
+#include <vector>
+
+// glm
+#include <glm/glm.hpp>
+
+// local
+#include "entity.hpp"
+#include "../components/mesh_renderer.hpp"
+
+namespace hawk
+{
+	namespace Objects
+	{
+		/**
+		 * Merges static mesh renderers of a subtree which share material and render settings. Vertices are transformed into
+		 * subtree root space and split by spatial chunks, so merged renderers are still culled, and sources stop drawing.
+		 */
+		class StaticBatcher
+		{
+		public:
+			/**
+			 * Chunk side length, sources are assigned to chunks by their bounds center.
+			 */
+			static constexpr float CHUNK_SIZE = 32.0f;
+
+			/**
+			 * Name of child entity holding merged renderers.
+			 */
+			static constexpr const char* ENTITY_NAME = "StaticBatch";
+
+			/**
+			 * Constructor.
+			 */
+			StaticBatcher();
+
+			/**
+			 * Destructor.
+			 */
+			~StaticBatcher();
+
+			/**
+			 * Merge renderers of a subtree into renderers of a new child entity, earlier batch of root is cleared first.
+			 * Renderers already merged by nested batches are kept in them. Merged renderers are not started.
+			 * @param root Subtree root.
+			 * @return Batch entity or nullptr if nothing could be merged.
+			 */
+			Entity* build(Entity* root);
+
+			/**
+			 * Remove batch of a subtree root and nested batches, sources draw again.
+			 * @param root Subtree root.
+			 */
+			void clear(Entity* root);
+
+			/**
+			 * Remove nested batches of a subtree and ancestor batches merging its renderers, sources draw again.
+			 * @param entity Subtree root.
+			 * @return Roots of removed batches, to be built again from their remaining static renderers.
+			 */
+			std::vector<Entity*> invalidate(Entity* entity);
+
+			/**
+			 * Are any renderers of an entity drawn by a batch?
+			 * @param entity Entity.
+			 * @return True or False.
+			 */
+			static bool isMerged(const Entity* entity);
+
+			/**
+			 * Root of batch drawing a renderer.
+			 * @param renderer Renderer.
+			 * @return Subtree root or nullptr if renderer is not merged.
+			 */
+			static Entity* getRoot(const Components::Renderer* renderer);
+
+		private:
+			/**
+			 * Sources merged into one renderer.
+			 */
+			struct Group
+			{
+				/**
+				 * Shared material.
+				 */
+				Assets::Material* material;
+
+				/**
+				 * Shared fill mode.
+				 */
+				unsigned int mode;
+
+				/**
+				 * Shared shadows mode.
+				 */
+				Components::Renderer::Shadows shadows;
+
+				/**
+				 * Shared shadow casting.
+				 */
+				bool cast_shadows;
+
+				/**
+				 * Shared occluder flag.
+				 */
+				bool occluder;
+
+				/**
+				 * Chunk coordinates.
+				 */
+				glm::ivec3 chunk;
+
+				/**
+				 * Do any sources have meshlets?
+				 */
+				bool meshlets;
+
+				/**
+				 * Source renderers.
+				 */
+				std::vector<Components::MeshRenderer*> renderers;
+			};
+
+			/**
+			 * Can renderer be merged?
+			 * @param renderer Mesh renderer.
+			 * @return True or False.
+			 */
+			static bool isBatchable(const Components::MeshRenderer* renderer);
+
+			/**
+			 * Batch entity of a subtree.
+			 * @param root Subtree root.
+			 * @return Batch entity or nullptr.
+			 */
+			static Entity* findBatch(Entity* root);
+
+			/**
+			 * Batch entities of a subtree, nested batches included.
+			 * @param root Subtree root.
+			 * @param batches List to add to.
+			 */
+			static void findBatches(Entity* root, std::vector<Entity*>& batches);
+
+			/**
+			 * Destroy a batch entity and free its meshes, its sources draw again.
+			 * @param batch Batch entity.
+			 */
+			static void clearBatch(Entity* batch);
+
+			/**
+			 * Add mergeable renderers of a subtree to groups.
+			 * @param entity Subtree root.
+			 */
+			void collect(Entity* entity);
+
+			/**
+			 * Merge sources of a group into one mesh.
+			 * @param group Group.
+			 * @param root_inverse Inverse model matrix of subtree root.
+			 * @return Built mesh or nullptr.
+			 */
+			Assets::Mesh* merge(const Group& group, const glm::mat4& root_inverse) const;
+
+			/**
+			 * Groups of last build.
+			 */
+			std::vector<Group> m_groups;
+
+			/**
+			 * Merged meshes id holder.
+			 */
+			unsigned int m_meshes_id;
+		};
+	}
+}
+#endif
\ No newline at end of file
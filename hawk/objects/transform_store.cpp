@@ -0,0 +1,565 @@
+#include "transform_store.hpp"
+#include "../components/transform.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define HAWK_TRANSFORM_STORE_SSE
+#endif
+
+namespace hawk
+{
+	namespace Objects
+	{
+		/**
+		 * Multiply two column major 4x4 matrices.
+		 * @param a Left matrix.
+		 * @param b Right matrix.
+		 * @param result Result matrix, must not overlap inputs.
+		 */
+		static inline void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& result)
+		{
+#ifdef HAWK_TRANSFORM_STORE_SSE
+			// load left matrix columns
+			const __m128 a0 = _mm_loadu_ps(&a[0][0]);
+			const __m128 a1 = _mm_loadu_ps(&a[1][0]);
+			const __m128 a2 = _mm_loadu_ps(&a[2][0]);
+			const __m128 a3 = _mm_loadu_ps(&a[3][0]);
+
+			// each result column is a linear combination of left columns
+			for (int i = 0; i < 4; ++i)
+			{
+				const float* column = &b[i][0];
+
+				__m128 value = _mm_mul_ps(a0, _mm_set1_ps(column[0]));
+				value = _mm_add_ps(value, _mm_mul_ps(a1, _mm_set1_ps(column[1])));
+				value = _mm_add_ps(value, _mm_mul_ps(a2, _mm_set1_ps(column[2])));
+				value = _mm_add_ps(value, _mm_mul_ps(a3, _mm_set1_ps(column[3])));
+
+				_mm_storeu_ps(&result[i][0], value);
+			}
+#else
+			result = a * b;
+#endif
+		}
+
+		TransformStore::TransformStore() : enable(false), m_stamp(1), m_pending(0), m_removed(0), m_unordered(false), m_parallel(false) {}
+
+		TransformStore::~TransformStore() {}
+
+		unsigned int TransformStore::add(Components::Transform* owner, int parent, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+		{
+			// slot index
+			unsigned int index = static_cast<unsigned int>(m_owners.size());
+
+			// local values
+			m_position_x.push_back(position.x);
+			m_position_y.push_back(position.y);
+			m_position_z.push_back(position.z);
+			m_rotation_x.push_back(rotation.x);
+			m_rotation_y.push_back(rotation.y);
+			m_rotation_z.push_back(rotation.z);
+			m_scale_x.push_back(scale.x);
+			m_scale_y.push_back(scale.y);
+			m_scale_z.push_back(scale.z);
+
+			// world values
+			m_world_rotations.push_back(glm::vec3(0.0f));
+			m_world_scales.push_back(glm::vec3(1.0f));
+			m_local_matrices.push_back(glm::mat4(1.0f));
+			m_world_matrices.push_back(glm::mat4(1.0f));
+
+			// bookkeeping
+			m_parents.push_back(parent);
+			m_dirty.push_back(0);
+			m_resolved.push_back(0);
+			m_versions.push_back(0);
+			m_owners.push_back(owner);
+
+			// parent must come first for linear sweep
+			if (parent >= static_cast<int>(index)) m_unordered = true;
+
+			// calculate on next sweep
+			markDirty(index);
+
+			return index;
+		}
+
+		void TransformStore::remove(unsigned int index)
+		{
+			// queue while workers read slots
+			if (m_parallel)
+			{
+				std::lock_guard<std::mutex> lock(m_queued_mutex);
+
+				m_queued_removed.push_back(index);
+
+				return;
+			}
+
+			// return if slot is out of range or already removed
+			if (index >= m_owners.size() || !m_owners[index]) return;
+
+			// release slot on next sweep
+			m_owners[index] = nullptr;
+
+			m_removed++;
+		}
+
+		void TransformStore::reparent(unsigned int index, int parent)
+		{
+			// queue while workers read slots
+			if (m_parallel)
+			{
+				std::lock_guard<std::mutex> lock(m_queued_mutex);
+
+				m_queued_parents.push_back(std::make_pair(index, parent));
+
+				return;
+			}
+
+			// set parent
+			m_parents[index] = parent;
+
+			// parent must come first for linear sweep
+			if (parent >= static_cast<int>(index)) m_unordered = true;
+
+			// recalculate against new parent
+			markDirty(index);
+		}
+
+		void TransformStore::update()
+		{
+			// return if nothing has changed
+			if (m_pending == 0 && m_removed == 0 && !m_unordered) return;
+
+			// restore slot order
+			if (m_removed > 0 || m_unordered) compact();
+
+			// slots count
+			size_t count = m_owners.size();
+
+			// local matrices of changed slots
+			for (size_t i = 0; i < count; ++i)
+				if (m_dirty[i]) calculateLocal(static_cast<unsigned int>(i));
+
+			// world matrices, parents are always calculated before their children
+			for (size_t i = 0; i < count; ++i)
+			{
+				// parent slot
+				int parent = m_parents[i];
+
+				// inherit parent flag
+				if (parent >= 0) m_dirty[i] |= m_dirty[parent];
+
+				// calculate if changed
+				if (m_dirty[i]) calculateWorld(static_cast<unsigned int>(i));
+			}
+
+			// reset flags
+			std::fill(m_dirty.begin(), m_dirty.end(), static_cast<unsigned char>(0));
+
+			m_pending = 0;
+		}
+
+		void TransformStore::clear()
+		{
+			// detach owners
+			for (auto owner : m_owners)
+				if (owner) owner->m_store = nullptr;
+
+			// clear lists
+			m_position_x.clear();
+			m_position_y.clear();
+			m_position_z.clear();
+			m_rotation_x.clear();
+			m_rotation_y.clear();
+			m_rotation_z.clear();
+			m_scale_x.clear();
+			m_scale_y.clear();
+			m_scale_z.clear();
+			m_world_rotations.clear();
+			m_world_scales.clear();
+			m_local_matrices.clear();
+			m_world_matrices.clear();
+			m_parents.clear();
+			m_dirty.clear();
+			m_resolved.clear();
+			m_versions.clear();
+			m_owners.clear();
+
+			// drop queued changes
+			m_queued_dirty.clear();
+			m_queued_removed.clear();
+			m_queued_parents.clear();
+
+			// reset counters
+			m_pending = 0;
+			m_removed = 0;
+			m_unordered = false;
+		}
+
+		void TransformStore::markDirty(unsigned int index)
+		{
+			// queue while workers read slots, counters and stamp are shared
+			if (m_parallel)
+			{
+				std::lock_guard<std::mutex> lock(m_queued_mutex);
+
+				m_queued_dirty.push_back(index);
+
+				return;
+			}
+
+			// count pending slots once
+			if (!m_dirty[index])
+			{
+				m_dirty[index] = 1;
+
+				m_pending++;
+			}
+
+			// invalidate lazily resolved slots
+			m_stamp++;
+		}
+
+		void TransformStore::setParallel(bool state)
+		{
+			// return if unchanged
+			if (m_parallel == state) return;
+
+			m_parallel = state;
+
+			// return if update starts
+			if (state) return;
+
+			// apply queued changes in order of kinds, removals last so queued marks of removed slots stay in range
+			for (auto& item : m_queued_parents)
+				reparent(item.first, item.second);
+
+			for (auto index : m_queued_dirty)
+				markDirty(index);
+
+			for (auto index : m_queued_removed)
+				remove(index);
+
+			m_queued_dirty.clear();
+			m_queued_removed.clear();
+			m_queued_parents.clear();
+		}
+
+		bool TransformStore::isParallel() const
+		{
+			return m_parallel;
+		}
+
+		glm::vec3 TransformStore::getPosition(unsigned int index) const
+		{
+			return glm::vec3(m_position_x[index], m_position_y[index], m_position_z[index]);
+		}
+
+		glm::vec3 TransformStore::getRotation(unsigned int index) const
+		{
+			return glm::vec3(m_rotation_x[index], m_rotation_y[index], m_rotation_z[index]);
+		}
+
+		glm::vec3 TransformStore::getScale(unsigned int index) const
+		{
+			return glm::vec3(m_scale_x[index], m_scale_y[index], m_scale_z[index]);
+		}
+
+		void TransformStore::setPosition(unsigned int index, const glm::vec3& position)
+		{
+			// set values
+			m_position_x[index] = position.x;
+			m_position_y[index] = position.y;
+			m_position_z[index] = position.z;
+
+			// calculate on next sweep
+			markDirty(index);
+		}
+
+		void TransformStore::setRotation(unsigned int index, const glm::vec3& rotation)
+		{
+			// set values
+			m_rotation_x[index] = rotation.x;
+			m_rotation_y[index] = rotation.y;
+			m_rotation_z[index] = rotation.z;
+
+			// calculate on next sweep
+			markDirty(index);
+		}
+
+		void TransformStore::setScale(unsigned int index, const glm::vec3& scale)
+		{
+			// set values
+			m_scale_x[index] = scale.x;
+			m_scale_y[index] = scale.y;
+			m_scale_z[index] = scale.z;
+
+			// calculate on next sweep
+			markDirty(index);
+		}
+
+		glm::vec3 TransformStore::getWorldRotation(unsigned int index)
+		{
+			// bring slot up to date
+			resolve(index);
+
+			return m_world_rotations[index];
+		}
+
+		glm::vec3 TransformStore::getWorldScale(unsigned int index)
+		{
+			// bring slot up to date
+			resolve(index);
+
+			return m_world_scales[index];
+		}
+
+		const glm::mat4& TransformStore::getLocalMatrix(unsigned int index)
+		{
+			// bring slot up to date
+			resolve(index);
+
+			return m_local_matrices[index];
+		}
+
+		const glm::mat4& TransformStore::getWorldMatrix(unsigned int index)
+		{
+			// bring slot up to date
+			resolve(index);
+
+			return m_world_matrices[index];
+		}
+
+		bool TransformStore::isDirty(unsigned int index) const
+		{
+			// walk up to root
+			for (int i = static_cast<int>(index); i >= 0; i = m_parents[i])
+				if (m_dirty[i]) return true;
+
+			return false;
+		}
+
+		unsigned int TransformStore::getVersion(unsigned int index) const
+		{
+			return m_versions[index];
+		}
+
+		unsigned int TransformStore::getSize() const
+		{
+			return static_cast<unsigned int>(m_owners.size());
+		}
+
+		void TransformStore::resolve(unsigned int index)
+		{
+			// return if nothing has changed since last resolve or sweep, slots are read only during parallel update
+			if (m_pending == 0 || m_parallel || m_resolved[index] == m_stamp) return;
+
+			// top most dirty slot on the path to root
+			int top = -1;
+
+			for (int i = static_cast<int>(index); i >= 0; i = m_parents[i])
+				if (m_dirty[i]) top = i;
+
+			// recalculate path from top most dirty slot down to this slot, flags are left for the sweep to propagate
+			if (top >= 0)
+			{
+				// collect path
+				std::vector<unsigned int> path;
+
+				for (int i = static_cast<int>(index); i != top; i = m_parents[i])
+					path.push_back(static_cast<unsigned int>(i));
+
+				path.push_back(static_cast<unsigned int>(top));
+
+				// calculate from top to bottom
+				for (auto it = path.rbegin(); it != path.rend(); ++it)
+				{
+					calculateLocal(*it);
+					calculateWorld(*it);
+				}
+			}
+
+			// remember stamp
+			m_resolved[index] = m_stamp;
+		}
+
+		void TransformStore::calculateLocal(unsigned int index)
+		{
+			// rotation sines and cosines
+			float rx = glm::radians(m_rotation_x[index]), ry = glm::radians(m_rotation_y[index]), rz = glm::radians(m_rotation_z[index]);
+			float sx = std::sin(rx), cx = std::cos(rx);
+			float sy = std::sin(ry), cy = std::cos(ry);
+			float sz = std::sin(rz), cz = std::cos(rz);
+
+			// scale
+			float scale_x = m_scale_x[index], scale_y = m_scale_y[index], scale_z = m_scale_z[index];
+
+			// translate * rotate x * rotate y * rotate z * scale in closed form
+			glm::mat4& m = m_local_matrices[index];
+
+			m[0][0] = cy * cz * scale_x;
+			m[0][1] = (sx * sy * cz + cx * sz) * scale_x;
+			m[0][2] = (-cx * sy * cz + sx * sz) * scale_x;
+			m[0][3] = 0.0f;
+
+			m[1][0] = -cy * sz * scale_y;
+			m[1][1] = (-sx * sy * sz + cx * cz) * scale_y;
+			m[1][2] = (cx * sy * sz + sx * cz) * scale_y;
+			m[1][3] = 0.0f;
+
+			m[2][0] = sy * scale_z;
+			m[2][1] = -sx * cy * scale_z;
+			m[2][2] = cx * cy * scale_z;
+			m[2][3] = 0.0f;
+
+			m[3][0] = m_position_x[index];
+			m[3][1] = m_position_y[index];
+			m[3][2] = m_position_z[index];
+			m[3][3] = 1.0f;
+		}
+
+		void TransformStore::calculateWorld(unsigned int index)
+		{
+			// parent slot
+			int parent = m_parents[index];
+
+			// local rotation and scale
+			glm::vec3 rotation(m_rotation_x[index], m_rotation_y[index], m_rotation_z[index]);
+			glm::vec3 scale(m_scale_x[index], m_scale_y[index], m_scale_z[index]);
+
+			// calculate against parent world values
+			if (parent >= 0)
+			{
+				multiply(m_world_matrices[parent], m_local_matrices[index], m_world_matrices[index]);
+
+				m_world_rotations[index] = m_world_rotations[parent] + rotation;
+				m_world_scales[index] = m_world_scales[parent] * scale;
+			}
+			else
+			{
+				m_world_matrices[index] = m_local_matrices[index];
+				m_world_rotations[index] = rotation;
+				m_world_scales[index] = scale;
+			}
+
+			// increase version
+			m_versions[index]++;
+		}
+
+		void TransformStore::compact()
+		{
+			// slots count
+			size_t count = m_owners.size();
+
+			// depth of each live slot, -1 for removed ones
+			std::vector<int> depths(count, -2);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				// removed slot
+				if (!m_owners[i])
+				{
+					depths[i] = -1;
+
+					continue;
+				}
+
+				// walk up until a known depth is found
+				int depth = 0;
+				int j = m_parents[i];
+
+				while (j >= 0 && m_owners[j] && depths[j] == -2)
+				{
+					depth++;
+
+					j = m_parents[j];
+				}
+
+				// add known depth of ancestor
+				if (j >= 0 && m_owners[j]) depth += depths[j] + 1;
+
+				depths[i] = depth;
+			}
+
+			// live slots sorted by depth, stable to keep siblings in order
+			std::vector<unsigned int> order;
+			order.reserve(count);
+
+			for (size_t i = 0; i < count; ++i)
+				if (m_owners[i]) order.push_back(static_cast<unsigned int>(i));
+
+			std::stable_sort(order.begin(), order.end(), [&depths](unsigned int a, unsigned int b) {
+				return depths[a] < depths[b];
+			});
+
+			// old to new slot indices
+			std::vector<int> remap(count, -1);
+
+			for (size_t i = 0; i < order.size(); ++i)
+				remap[order[i]] = static_cast<int>(i);
+
+			// gather helper
+			auto gather = [&order](auto& list) {
+				std::remove_reference_t<decltype(list)> result;
+				result.reserve(order.size());
+
+				for (auto index : order)
+					result.push_back(list[index]);
+
+				list.swap(result);
+			};
+
+			// rebuild lists
+			gather(m_position_x);
+			gather(m_position_y);
+			gather(m_position_z);
+			gather(m_rotation_x);
+			gather(m_rotation_y);
+			gather(m_rotation_z);
+			gather(m_scale_x);
+			gather(m_scale_y);
+			gather(m_scale_z);
+			gather(m_world_rotations);
+			gather(m_world_scales);
+			gather(m_local_matrices);
+			gather(m_world_matrices);
+			gather(m_parents);
+			gather(m_dirty);
+			gather(m_versions);
+			gather(m_owners);
+
+			// lazily resolved slots are recalculated
+			m_resolved.assign(order.size(), 0);
+
+			// remap parents, orphans of removed slots become roots
+			for (size_t i = 0; i < m_parents.size(); ++i)
+			{
+				// skip roots
+				if (m_parents[i] < 0) continue;
+
+				m_parents[i] = remap[m_parents[i]];
+
+				// recalculate orphans as roots
+				if (m_parents[i] < 0 && !m_dirty[i])
+				{
+					m_dirty[i] = 1;
+
+					m_pending++;
+				}
+			}
+
+			// update owner handles
+			for (size_t i = 0; i < m_owners.size(); ++i)
+				m_owners[i]->m_store_index = static_cast<unsigned int>(i);
+
+			// reset counters
+			m_removed = 0;
+			m_unordered = false;
+		}
+	}
+}
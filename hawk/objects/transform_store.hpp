@@ -0,0 +1,334 @@
+#ifndef HAWK_OBJECTS_TRANSFORM_STORE_H
+#define HAWK_OBJECTS_TRANSFORM_STORE_H
+
+// stl
+#include <mutex>
+#include <vector>
+
+// glm
+#include <glm/glm.hpp>
+
+namespace hawk
+{
+	namespace Components
+	{
+		/**
+		 * Transform forward declaration.
+		 */
+		class Transform;
+	}
+
+	namespace Objects
+	{
+		/**
+		 * Structure of arrays storage for transforms. Slots are kept in parent-before-child order so world matrices are calculated in one linear sweep.
+		 */
+		class TransformStore
+		{
+		public:
+			/**
+			 * Constructor.
+			 */
+			TransformStore();
+
+			/**
+			 * Constructor.
+			 * @param other Other object.
+			 */
+			TransformStore(const TransformStore& other) = delete;
+
+			/**
+			 * Destructor.
+			 */
+			~TransformStore();
+
+			/**
+			 * Assignment operator.
+			 * @param other Other object.
+			 */
+			void operator=(const TransformStore& other) = delete;
+
+			/**
+			 * Add a transform to store. Parent must be added before its children.
+			 * @param owner Transform component which owns the slot.
+			 * @param parent Parent slot index or -1 for root transforms.
+			 * @param position Local position.
+			 * @param rotation Local rotation.
+			 * @param scale Local scale.
+			 * @return Slot index.
+			 */
+			unsigned int add(Components::Transform* owner, int parent, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+
+			/**
+			 * Remove a transform from store. Slot is freed on next update.
+			 * @param index Slot index.
+			 */
+			void remove(unsigned int index);
+
+			/**
+			 * Change parent of a slot.
+			 * @param index Slot index.
+			 * @param parent Parent slot index or -1 for root transforms.
+			 */
+			void reparent(unsigned int index, int parent);
+
+			/**
+			 * Calculate world matrices of changed slots and their children.
+			 */
+			void update();
+
+			/**
+			 * Clear store.
+			 */
+			void clear();
+
+			/**
+			 * Mark a slot for recalculation.
+			 * @param index Slot index.
+			 */
+			void markDirty(unsigned int index);
+
+			/**
+			 * Start or end a parallel update. While it runs world values are read only and changes are queued, ending it applies them.
+			 * Call update before starting so no slot is resolved lazily while workers read it.
+			 * @param state True or False.
+			 */
+			void setParallel(bool state);
+
+			/**
+			 * Is a parallel update running?
+			 */
+			bool isParallel() const;
+
+			/**
+			 * Local position.
+			 */
+			glm::vec3 getPosition(unsigned int index) const;
+
+			/**
+			 * Local rotation.
+			 */
+			glm::vec3 getRotation(unsigned int index) const;
+
+			/**
+			 * Local scale.
+			 */
+			glm::vec3 getScale(unsigned int index) const;
+
+			/**
+			 * Set local position.
+			 */
+			void setPosition(unsigned int index, const glm::vec3& position);
+
+			/**
+			 * Set local rotation.
+			 */
+			void setRotation(unsigned int index, const glm::vec3& rotation);
+
+			/**
+			 * Set local scale.
+			 */
+			void setScale(unsigned int index, const glm::vec3& scale);
+
+			/**
+			 * Rotation in world.
+			 */
+			glm::vec3 getWorldRotation(unsigned int index);
+
+			/**
+			 * Scale in world.
+			 */
+			glm::vec3 getWorldScale(unsigned int index);
+
+			/**
+			 * Model matrix in local space.
+			 */
+			const glm::mat4& getLocalMatrix(unsigned int index);
+
+			/**
+			 * Model matrix in world space.
+			 */
+			const glm::mat4& getWorldMatrix(unsigned int index);
+
+			/**
+			 * Is slot waiting for recalculation?
+			 */
+			bool isDirty(unsigned int index) const;
+
+			/**
+			 * World matrix version of slot.
+			 */
+			unsigned int getVersion(unsigned int index) const;
+
+			/**
+			 * Slots count.
+			 */
+			unsigned int getSize() const;
+
+			/**
+			 * Store transforms which are started while this flag is on.
+			 */
+			bool enable;
+
+		private:
+			/**
+			 * Bring a single slot up to date between sweeps.
+			 * @param index Slot index.
+			 */
+			void resolve(unsigned int index);
+
+			/**
+			 * Calculate local matrix of a slot.
+			 * @param index Slot index.
+			 */
+			void calculateLocal(unsigned int index);
+
+			/**
+			 * Calculate world values of a slot from its parent.
+			 * @param index Slot index.
+			 */
+			void calculateWorld(unsigned int index);
+
+			/**
+			 * Drop removed slots and restore parent-before-child order.
+			 */
+			void compact();
+
+			/**
+			 * Local position x components.
+			 */
+			std::vector<float> m_position_x;
+
+			/**
+			 * Local position y components.
+			 */
+			std::vector<float> m_position_y;
+
+			/**
+			 * Local position z components.
+			 */
+			std::vector<float> m_position_z;
+
+			/**
+			 * Local rotation x components.
+			 */
+			std::vector<float> m_rotation_x;
+
+			/**
+			 * Local rotation y components.
+			 */
+			std::vector<float> m_rotation_y;
+
+			/**
+			 * Local rotation z components.
+			 */
+			std::vector<float> m_rotation_z;
+
+			/**
+			 * Local scale x components.
+			 */
+			std::vector<float> m_scale_x;
+
+			/**
+			 * Local scale y components.
+			 */
+			std::vector<float> m_scale_y;
+
+			/**
+			 * Local scale z components.
+			 */
+			std::vector<float> m_scale_z;
+
+			/**
+			 * World rotations.
+			 */
+			std::vector<glm::vec3> m_world_rotations;
+
+			/**
+			 * World scales.
+			 */
+			std::vector<glm::vec3> m_world_scales;
+
+			/**
+			 * Local matrices.
+			 */
+			std::vector<glm::mat4> m_local_matrices;
+
+			/**
+			 * World matrices.
+			 */
+			std::vector<glm::mat4> m_world_matrices;
+
+			/**
+			 * Parent slot indices.
+			 */
+			std::vector<int> m_parents;
+
+			/**
+			 * Dirty flags.
+			 */
+			std::vector<unsigned char> m_dirty;
+
+			/**
+			 * Change stamps of lazily resolved slots.
+			 */
+			std::vector<unsigned int> m_resolved;
+
+			/**
+			 * World matrix versions.
+			 */
+			std::vector<unsigned int> m_versions;
+
+			/**
+			 * Slot owners.
+			 */
+			std::vector<Components::Transform*> m_owners;
+
+			/**
+			 * Change stamp, increases every time a slot is marked dirty.
+			 */
+			unsigned int m_stamp;
+
+			/**
+			 * Count of slots marked dirty since last sweep.
+			 */
+			unsigned int m_pending;
+
+			/**
+			 * Count of removed slots since last sweep.
+			 */
+			unsigned int m_removed;
+
+			/**
+			 * Slots are out of parent-before-child order.
+			 */
+			bool m_unordered;
+
+			/**
+			 * Is a parallel update running?
+			 */
+			bool m_parallel;
+
+			/**
+			 * Queued changes lock.
+			 */
+			std::mutex m_queued_mutex;
+
+			/**
+			 * Slots marked dirty during parallel update.
+			 */
+			std::vector<unsigned int> m_queued_dirty;
+
+			/**
+			 * Slots removed during parallel update.
+			 */
+			std::vector<unsigned int> m_queued_removed;
+
+			/**
+			 * Slots reparented during parallel update, slot and parent.
+			 */
+			std::vector<std::pair<unsigned int, int>> m_queued_parents;
+		};
+	}
+}
+#endif
\ No newline at end of file
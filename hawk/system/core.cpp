@@ -215,6 +215,22 @@ namespace hawk
 				return false;
 			}
 
+			logger.info("Initializing workers...");
+
+			// initialize workers
+			if (!workers.initialize())
+			{
+				logger.error("Failed to initialize workers!");
+
+				// deinitialize
+				workers.deinitialize();
+
+				// terminate glfw
+				glfwTerminate();
+
+				return false;
+			}
+
 			// center window
 			glfwSetWindowPos(window, (video.getVideoMode()->width - width) / 2, (video.getVideoMode()->height - height) / 2);
 
@@ -234,6 +250,9 @@ namespace hawk
 		{
 			logger.info("Deinitializing core...");
 
+			// deinit workers
+			workers.deinitialize();
+
 			// deinit scene
 			scene.deinitialize();
 
@@ -285,7 +304,7 @@ namespace hawk
 				audio.update();
 
 				// update world with fixed frame rate
-				scene.world->fixedUpdate();
+				scene.fixedUpdate();
 			}
 		}
 
@@ -302,13 +321,19 @@ namespace hawk
 			input.update();
 
 			// update world
-			scene.world->update();
+			scene.update();
+
+			// calculate stored transforms
+			scene.transforms.update();
 		}
 
 		void Core::lateUpdate()
 		{
 			// late update world
-			scene.world->lateUpdate();
+			scene.lateUpdate();
+
+			// calculate stored transforms changed on late update
+			scene.transforms.update();
 		}
 
 		void Core::render()
@@ -316,6 +341,9 @@ namespace hawk
 			// return if window is iconified
 			if (iconified) return;
 
+			// render event of components
+			scene.render();
+
 			// render scene to cameras
 			video.render();
 
@@ -327,6 +355,9 @@ namespace hawk
 		{
 			// process destroyed objects
 			scene.processDestroyedObjects();
+
+			// merge or split static geometry after destroyed subtrees are gone
+			scene.processStaticBatches();
 		}
 
 		void Core::stop()
@@ -359,7 +390,7 @@ namespace hawk
 		void Core::windowResizeCallback(GLFWwindow* window, int width, int height)
 		{
 			// reset viewport
-			glViewport(0, 0, width, height);
+			System::Core::getInstance().video.setViewport(0, 0, width, height);
 
 			// set window size
 			System::Core::getInstance().width = width;
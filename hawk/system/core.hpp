@@ -29,6 +29,7 @@
 #include "../managers/input.hpp"
 #include "../managers/scene.hpp"
 #include "../managers/assets.hpp"
+#include "../managers/workers.hpp"
 
 namespace hawk
 {
@@ -169,6 +170,11 @@ namespace hawk
 			 */
 			Managers::Scene scene;
 
+			/**
+			 * Worker threads manager.
+			 */
+			Managers::Workers workers;
+
 			/**
 			 * Main window.
 			 */